@@ -4,5 +4,10 @@ namespace wield {
 
     // A tag type to indicate the dispatcher should make a copy of the message.
     struct CloneMessageTagType {} static clone_message;
+
+    // A tag type to indicate a fanout should share the message with stages
+    // which only read it, and clone it for stages which mutate it.
+    struct CopyOnWriteTagType {};
+    constexpr CopyOnWriteTagType copy_on_write{};
 }
 
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <cstddef>
+#include <iterator>
 #include <type_traits>
 
 namespace wield {
@@ -43,6 +44,19 @@ namespace wield {
         // @clone a tag type for tag-dispatching this overloaded function
         template<class ConcreteMessageType>
         void dispatch(StageEnumType stageName, ConcreteMessageType& message, CloneMessageTagType);
+
+        // Send a batch of messages to a stage in one operation
+        // @stageName the stage to dispatch the messages to.
+        // @first, @last a forward iterator range over messages (raw or smart pointers),
+        // pushed as a single run using the queue's bulk enqueue when available.
+        template<class Iterator>
+        void dispatchBatch(StageEnumType stageName, Iterator first, Iterator last);
+
+        // Send one message to several stages
+        // @firstStage, @lastStage a forward iterator range over the names of the destination stages.
+        // @message the message to send, the references for all destinations are added at once.
+        template<class StageIterator>
+        void dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename StageType::MessageType& message);
         
         // Stage lookup function
         // @stageName is the name of the stage to get a reference to.
@@ -103,6 +117,34 @@ namespace wield {
         stages_[static_cast<std::size_t>(stageName)]->push(clone);
     }
 
+    template<typename StageEnum, class Stage>
+    template<class Iterator>
+    inline
+    void DispatcherBase<StageEnum, Stage>::dispatchBatch(StageEnumType stageName, Iterator first, Iterator last)
+    {
+        // take the queue's references for the whole batch up front,
+        // then hand the run to the stage.
+        for(Iterator it = first; it != last; ++it)
+        {
+            (*it)->incrementReferenceCount();
+        }
+
+        stages_[static_cast<std::size_t>(stageName)]->push(first, last);
+    }
+
+    template<typename StageEnum, class Stage>
+    template<class StageIterator>
+    inline
+    void DispatcherBase<StageEnum, Stage>::dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename StageType::MessageType& message)
+    {
+        message.incrementReferenceCount(static_cast<std::size_t>(std::distance(firstStage, lastStage)));
+
+        for(; firstStage != lastStage; ++firstStage)
+        {
+            stages_[static_cast<std::size_t>(*firstStage)]->push(&message);
+        }
+    }
+
     template<typename StageEnum, class Stage>
     inline
     Stage& DispatcherBase<StageEnum, Stage>::operator[](StageEnumType stageName)
@@ -14,4 +14,94 @@ namespace wield {
     public:
         IllegallyPushedMessageOntoQueueAdapter();
     };
+
+    class TooManyInputQueuesAdded final : public std::runtime_error
+    {
+    public:
+        TooManyInputQueuesAdded();
+    };
+
+    class IllegallyPushedMessageOntoTimerWheel final : public std::runtime_error
+    {
+    public:
+        IllegallyPushedMessageOntoTimerWheel();
+    };
+
+    class IllegallyPushedMessageOntoIngress final : public std::runtime_error
+    {
+    public:
+        IllegallyPushedMessageOntoIngress();
+    };
+
+    class InvalidSharedMemoryRing final : public std::runtime_error
+    {
+    public:
+        InvalidSharedMemoryRing();
+    };
+
+    class MessageTooLargeForSharedMemoryRing final : public std::runtime_error
+    {
+    public:
+        MessageTooLargeForSharedMemoryRing();
+    };
+
+    class SharedMemoryRingFull final : public std::runtime_error
+    {
+    public:
+        SharedMemoryRingFull();
+    };
+
+    class MessageNotSerializable final : public std::runtime_error
+    {
+    public:
+        MessageNotSerializable();
+    };
+
+    class MessageTooLargeForBuffer final : public std::runtime_error
+    {
+    public:
+        MessageTooLargeForBuffer();
+    };
+
+    class UnknownMessageType final : public std::runtime_error
+    {
+    public:
+        UnknownMessageType();
+    };
+
+    class DuplicateMessageTypeRegistration final : public std::runtime_error
+    {
+    public:
+        DuplicateMessageTypeRegistration();
+    };
+
+    class TransportLinkClosed final : public std::runtime_error
+    {
+    public:
+        TransportLinkClosed();
+    };
+
+    class TransportWindowFull final : public std::runtime_error
+    {
+    public:
+        TransportWindowFull();
+    };
+
+    class UnknownStageName final : public std::runtime_error
+    {
+    public:
+        UnknownStageName();
+    };
+
+    class InvalidJournal final : public std::runtime_error
+    {
+    public:
+        InvalidJournal();
+    };
+
+    class FanoutOfUniquelyOwnedMessage final : public std::runtime_error
+    {
+    public:
+        FanoutOfUniquelyOwnedMessage();
+    };
 }
@@ -1,6 +1,9 @@
 #pragma once
-#include <UsingIntrusivePtrIn/UsingIntrusivePtrIn.hpp>
-#include <UsingIntrusivePtrIn/Handle.hpp>
+#include <wield/Exceptions.hpp>
+#include <wield/ReferenceCounting.hpp>
+
+#include <cstddef>
+#include <cstdint>
 
 namespace wield {
 
@@ -15,29 +18,62 @@ namespace wield {
     // This flexability maybe useful for updating statistics or informing
     // the scheduler of events via ProcessingFunctor - if that is how
     // client code decides to feed statistics or information into their scheduler.
-    template<class ProcessingFunctor>
-    class MessageBase : public UsingIntrusivePtrIn::UsingIntrusivePtrIn<MessageBase<ProcessingFunctor>>
+    //
+    // ReferenceCounting selects how references are counted, see
+    // wield/ReferenceCounting.hpp.
+    template<class ProcessingFunctor, class ReferenceCounting = AtomicReferenceCount>
+    class MessageBase : public details::ReferenceCounted<MessageBase<ProcessingFunctor, ReferenceCounting>, ReferenceCounting>
 	{
 	public:
-        using smartptr = UsingIntrusivePtrIn::Handle<MessageBase>;
+        using smartptr = typename details::HandleOf<MessageBase, ReferenceCounting>::type;
         using ptr = MessageBase*;
 
         virtual ~MessageBase(){}
 		virtual void processWith(ProcessingFunctor& process) = 0;
 
+        // optional serialization, for messages leaving the process (see
+        // wield/serialization). The type id names the concrete message
+        // class in a serialization::MessageRegistry, 0 means the message
+        // can't be serialized.
+        virtual std::uint32_t typeId() const { return 0; }
+
+        // write the message's payload into @buffer.
+        // @return the number of bytes written.
+        // @throw MessageTooLargeForBuffer if it needs more than @capacity.
+        virtual std::size_t serializeInto(char* buffer, const std::size_t capacity) const;
+
         inline void incrementReferenceCount();
+        inline void incrementReferenceCount(const std::size_t count);
         inline void decrementReferenceCount();
     };
 
 
-    template<class ProcessingFunctor>
-    void MessageBase<ProcessingFunctor>::incrementReferenceCount()
+    template<class ProcessingFunctor, class ReferenceCounting>
+    std::size_t MessageBase<ProcessingFunctor, ReferenceCounting>::serializeInto(char*, const std::size_t) const
+    {
+        throw MessageNotSerializable();
+    }
+
+    template<class ProcessingFunctor, class ReferenceCounting>
+    void MessageBase<ProcessingFunctor, ReferenceCounting>::incrementReferenceCount()
     {
         intrusive_ptr_add_ref(this);
     }
 
-    template<class ProcessingFunctor>
-    void MessageBase<ProcessingFunctor>::decrementReferenceCount()
+    // add @count references at once, used when fanning a message out
+    // to several stages: a single atomic add before any queue sees the
+    // message, rather than one per destination.
+    //
+    // @throw FanoutOfUniquelyOwnedMessage for more than one reference
+    // to a UniqueOwnership message.
+    template<class ProcessingFunctor, class ReferenceCounting>
+    void MessageBase<ProcessingFunctor, ReferenceCounting>::incrementReferenceCount(const std::size_t count)
+    {
+        this->addReferences(count);
+    }
+
+    template<class ProcessingFunctor, class ReferenceCounting>
+    void MessageBase<ProcessingFunctor, ReferenceCounting>::decrementReferenceCount()
     {
         intrusive_ptr_release(this);
     }
@@ -0,0 +1,349 @@
+#pragma once
+#include <UsingIntrusivePtrIn/Handle.hpp>
+
+#include <wield/Exceptions.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace wield {
+
+    // Reference counting policies for MessageBase, chosen per application
+    // through the optional ReferenceCounting declaration of its traits:
+    //
+    //      struct ApplicationTraits
+    //      {
+    //          ...
+    //          using ReferenceCounting = wield::NonAtomicReferenceCount;
+    //      };
+    //
+    // AtomicReferenceCount is the default, and the only safe choice when
+    // a message is referenced from more than one thread: fanned out to
+    // stages on different threads, or dispatched by one thread and
+    // processed by another.
+
+    // Each policy provides
+    //      void increment(void);
+    //      void add(std::size_t count);    // @count references at once
+    //      bool decrement(void);           // true when the last reference has gone
+
+    // atomic counts, a message may be shared between threads.
+    class AtomicReferenceCount
+    {
+    public:
+        AtomicReferenceCount() : count_(0) {}
+
+        // taking a reference needs no ordering, only dropping one does.
+        void increment(void) { count_.fetch_add(1, std::memory_order_relaxed); }
+
+        // one read-modify-write of the counter's cache line for the
+        // whole fanout, rather than one per destination.
+        void add(const std::size_t count) { count_.fetch_add(count, std::memory_order_relaxed); }
+
+        // acquire, so whatever other threads did with the message
+        // happens before it's freed.
+        bool decrement(void) { return count_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    private:
+        std::atomic<std::size_t> count_;
+    };
+
+    // plain counts, for pipelines where every reference to a message is
+    // taken and dropped on one thread: a single threaded scheduler, fused
+    // stages or a replay run. Saves a locked instruction per reference.
+    class NonAtomicReferenceCount
+    {
+    public:
+        NonAtomicReferenceCount() : count_(0) {}
+
+        void increment(void) { ++count_; }
+        void add(const std::size_t count) { count_ += count; }
+
+        // @return true when the last reference has gone.
+        bool decrement(void) { return --count_ == 0; }
+
+    private:
+        std::size_t count_;
+    };
+
+    // NonAtomicReferenceCount which, in debug builds, asserts that the
+    // message is only ever counted on one thread: the thread which took
+    // its first reference. Run with it to find the messages which do
+    // escape their thread, before switching to NonAtomicReferenceCount.
+    class ThreadConfinedReferenceCount
+    {
+    public:
+        ThreadConfinedReferenceCount() : count_(0) {}
+
+        void increment(void)
+        {
+            if(count_ == 0)
+            {
+                owner_ = std::this_thread::get_id();
+            }
+
+            assert(owner_ == std::this_thread::get_id() && "message referenced from more than one thread");
+            ++count_;
+        }
+
+        void add(const std::size_t count)
+        {
+            if(count_ == 0)
+            {
+                owner_ = std::this_thread::get_id();
+            }
+
+            assert(owner_ == std::this_thread::get_id() && "message referenced from more than one thread");
+            count_ += count;
+        }
+
+        bool decrement(void)
+        {
+            assert(owner_ == std::this_thread::get_id() && "message referenced from more than one thread");
+            return --count_ == 0;
+        }
+
+        std::thread::id owner(void) const { return owner_; }
+
+    private:
+        std::size_t count_;
+        std::thread::id owner_;
+    };
+
+    // one owner at a time, for linear pipelines: Message::smartptr is a
+    // move-only UniqueHandle and dispatching a message hands it on, the
+    // handle which owned it is left empty:
+    //
+    //      Message::smartptr quote = new Quote(...);
+    //      dispatcher.dispatch(Stages::Pricing, *quote);   // quote is empty now
+    //
+    // A stage's handle on the message it's processing is emptied the same
+    // way when its ProcessingFunctor dispatches the message on. Ownership
+    // passes with the pointer, so the count is only touched when a message
+    // is made and freed, and then without atomics.
+    //
+    // NOTE: a message dispatched on may be processed, and freed, by another
+    // thread straight away. Don't touch it after dispatching it, and don't
+    // dispatch it on from a stage whose queue looks at messages after they
+    // are processed (KeyedQueue). Fanout needs a copy of the message for
+    // each stage, dispatch(stage, message, CloneMessage): dispatchFanout
+    // throws FanoutOfUniquelyOwnedMessage.
+    struct UniqueOwnership
+    {
+    };
+
+    template<class Message>
+    class UniqueHandle;
+
+    namespace details {
+
+        // the counting base class of @Message, with the intrusive_ptr hooks
+        // found by argument dependent lookup.
+        template<class Message, class ReferenceCounting>
+        class ReferenceCounted
+        {
+        public:
+            ReferenceCounted() {}
+            ReferenceCounted(const ReferenceCounted&) {}
+            ReferenceCounted& operator=(const ReferenceCounted&) { return *this; }
+
+            // take @count references at once, for a fanout.
+            void addReferences(const std::size_t count) const { count_.add(count); }
+
+            friend void intrusive_ptr_add_ref(const ReferenceCounted* p)
+            {
+                p->count_.increment();
+            }
+
+            friend void intrusive_ptr_release(const ReferenceCounted* p)
+            {
+                if(p->count_.decrement())
+                {
+                    delete static_cast<const Message*>(p);
+                }
+            }
+
+        private:
+            mutable ReferenceCounting count_;
+        };
+
+        // tracks the handle owning the message, if one does, and counts
+        // the reference held elsewhere: by a queue, a TimerWheel. There is
+        // never more than one.
+        template<class Message>
+        class ReferenceCounted<Message, UniqueOwnership>
+        {
+        public:
+            ReferenceCounted() : count_(0), owner_(nullptr) {}
+            ReferenceCounted(const ReferenceCounted&) : count_(0), owner_(nullptr) {}
+            ReferenceCounted& operator=(const ReferenceCounted&) { return *this; }
+
+            // @throw FanoutOfUniquelyOwnedMessage for more than one reference,
+            // each stage needs a copy of its own.
+            void addReferences(const std::size_t count) const
+            {
+                if(count > 1)
+                {
+                    throw FanoutOfUniquelyOwnedMessage();
+                }
+
+                if(count == 1)
+                {
+                    addReference();
+                }
+            }
+
+            // the owning handle's reference goes with the message.
+            friend void intrusive_ptr_add_ref(const ReferenceCounted* p)
+            {
+                p->addReference();
+            }
+
+            friend void intrusive_ptr_release(const ReferenceCounted* p)
+            {
+                if(--p->count_ == 0)
+                {
+                    delete static_cast<const Message*>(p);
+                }
+            }
+
+        private:
+            friend class UniqueHandle<Message>;
+
+            // @throw FanoutOfUniquelyOwnedMessage for a message a queue
+            // already holds, dispatching it again would share it.
+            void addReference(void) const
+            {
+                if(owner_ != nullptr)
+                {
+                    owner_->message_ = nullptr;
+                    owner_ = nullptr;
+                    return;
+                }
+
+                if(count_ != 0)
+                {
+                    throw FanoutOfUniquelyOwnedMessage();
+                }
+
+                ++count_;
+            }
+
+            mutable std::size_t count_;
+            mutable UniqueHandle<Message>* owner_;
+        };
+
+        template<class Message, class ReferenceCounting>
+        struct HandleOf
+        {
+            using type = UsingIntrusivePtrIn::Handle<Message>;
+        };
+
+        template<class Message>
+        struct HandleOf<Message, UniqueOwnership>
+        {
+            using type = UniqueHandle<Message>;
+        };
+
+        // @Traits::ReferenceCounting when declared, AtomicReferenceCount otherwise.
+        template<class Traits>
+        class ReferenceCountingOf
+        {
+            template<class T>
+            static auto test(int) -> typename T::ReferenceCounting;
+
+            template<class>
+            static AtomicReferenceCount test(...);
+
+        public:
+            using type = decltype(test<Traits>(0));
+        };
+    }
+
+    // <UniqueHandle> is Message::smartptr for UniqueOwnership messages, a
+    // move-only handle owning the message until it's dispatched.
+    template<class Message>
+    class UniqueHandle
+    {
+    public:
+        UniqueHandle() : message_(nullptr) {}
+
+        // take a reference to @message, or ownership of it from its handle.
+        UniqueHandle(Message* message) : UniqueHandle(message, true) {}
+
+        // @increment false adopts the reference of the queue @message was
+        // popped from, see details::create_smartptr.
+        UniqueHandle(Message* message, const bool increment)
+            : message_(message)
+        {
+            if(message_ != nullptr)
+            {
+                if(increment)
+                {
+                    intrusive_ptr_add_ref(message_);
+                }
+
+                message_->owner_ = this;
+            }
+        }
+
+        UniqueHandle(UniqueHandle&& other)
+            : message_(other.message_)
+        {
+            other.message_ = nullptr;
+            if(message_ != nullptr)
+            {
+                message_->owner_ = this;
+            }
+        }
+
+        UniqueHandle& operator=(UniqueHandle&& other)
+        {
+            if(this != &other)
+            {
+                reset();
+
+                message_ = other.message_;
+                other.message_ = nullptr;
+                if(message_ != nullptr)
+                {
+                    message_->owner_ = this;
+                }
+            }
+
+            return *this;
+        }
+
+        ~UniqueHandle() { reset(); }
+
+        // free the message, unless it has been dispatched.
+        void reset(void)
+        {
+            if(message_ != nullptr)
+            {
+                Message* message = message_;
+                message_ = nullptr;
+                message->owner_ = nullptr;
+                intrusive_ptr_release(message);
+            }
+        }
+
+        Message* get(void) const { return message_; }
+        Message& operator*(void) const { return *message_; }
+        Message* operator->(void) const { return message_; }
+        explicit operator bool(void) const { return message_ != nullptr; }
+
+    private:
+        UniqueHandle(const UniqueHandle&) = delete;
+        UniqueHandle& operator=(const UniqueHandle&) = delete;
+
+        friend class details::ReferenceCounted<Message, UniqueOwnership>;
+
+    private:
+        Message* message_;
+    };
+}
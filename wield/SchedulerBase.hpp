@@ -2,6 +2,8 @@
 
 #include <wield/details/SchedulingPolicyHolder.hpp>
 #include <wield/logging/Log.hpp>
+#include <wield/memory/BatchArena.hpp>
+#include <wield/memory/QuiescentState.hpp>
 #include <wield/platform/thread.hpp>
 #include <wield/platform/list.hpp>
 
@@ -126,5 +128,11 @@ namespace wield {
         while(this->schedulingPolicy_.continueProcessing(pollingInfo));
         
         this->schedulingPolicy_.batchEnd(pollingInfo);
+
+        // free what the batch's processing functors allocated from the arena.
+        memory::BatchArena::current().reset();
+
+        // nor does the thread hold on to anything read from shared data.
+        memory::QuiescentState::quiescent();
     }
 }
@@ -2,6 +2,8 @@
 #include <wield/DispatcherInterface.hpp>
 #include <wield/MessageBase.hpp>
 
+#include <wield/details/BulkPush.hpp>
+#include <wield/details/ProcessedNotification.hpp>
 #include <wield/details/SmartPtrCreator.hpp>
 
 namespace wield {
@@ -30,6 +32,12 @@ namespace wield {
         // Insert a message onto the stage's queue
         // @m the message to insert
         void push(const typename MessageType::ptr& m);
+
+        // Insert a run of messages onto the stage's queue, using the
+        // queue's push_bulk(first, last) when it provides one.
+        // @first, @last the range of messages to insert
+        template<class Iterator>
+        void push(Iterator first, Iterator last);
         
         // process a message:
         // pump the queue, if there is a message, process it.
@@ -75,6 +83,14 @@ namespace wield {
         queue_.push(m);
     }
     
+    template<typename StageEnum, class ProcessingFunctor, class Message, class QueueType>
+    template<class Iterator>
+    inline
+    void StageBase<StageEnum, ProcessingFunctor, Message, QueueType>::push(Iterator first, Iterator last)
+    {
+        details::bulk_push<typename MessageType::ptr>(queue_, first, last);
+    }
+    
     template<typename StageEnum, class ProcessingFunctor, class Message, class QueueType>
     bool StageBase<StageEnum, ProcessingFunctor, Message, QueueType>::process(void)
     {
@@ -83,6 +99,9 @@ namespace wield {
         {
             typename MessageType::smartptr message(details::create_smartptr<MessageType>(m, no_increment));
 
+            // tell queues which need to know (e.g. KeyedQueue) when processing is done.
+            details::ProcessedNotification<QueueType, typename MessageType::ptr> notify(queue_, m);
+
             message->processWith(processingFunctor_);
             return true;
         }
@@ -1,6 +1,7 @@
 #pragma once
 #include <wield/DispatcherBase.hpp>
 #include <wield/MessageBase.hpp>
+#include <wield/ReferenceCounting.hpp>
 #include <wield/SchedulerBase.hpp>
 #include <wield/StageBase.hpp>
 
@@ -10,13 +11,18 @@ namespace wield {
     // If you wish to override particular classes, like
     // the DispatcherType, you'll need define similar struct
     // with your desired types.
+    //
+    // ClientDefinedTraits may also declare ReferenceCounting, the message
+    // reference counting policy (see wield/ReferenceCounting.hpp).
     template<class ClientDefinedTraits>
     struct Traits
     {
         using StageEnumType = typename ClientDefinedTraits::StageEnumType;
         using ProcessingFunctor = typename ClientDefinedTraits::ProcessingFunctor;
         
-        using Message = MessageBase<ProcessingFunctor>;
+        using ReferenceCounting = typename details::ReferenceCountingOf<ClientDefinedTraits>::type;
+        
+        using Message = MessageBase<ProcessingFunctor, ReferenceCounting>;
         using MessagePtr = typename Message::ptr;
         
         using Queue = typename ClientDefinedTraits::template QueueType<MessagePtr>;
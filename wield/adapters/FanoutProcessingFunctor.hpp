@@ -1,8 +1,11 @@
 #pragma once
 #include <wield/CloneMessageTag.hpp>
 
+#include <algorithm>
 #include <array>
+#include <initializer_list>
 #include <utility>
+#include <vector>
 
 namespace wield { namespace adapters {
     
@@ -22,6 +25,10 @@ namespace wield { namespace adapters {
         
         FanoutProcessingFunctor(Dispatcher& dispatcher);
         
+        // @mutatingStages the stages of StageList which modify the messages
+        // they receive, they get a clone when dispatching with copy_on_write.
+        FanoutProcessingFunctor(Dispatcher& dispatcher, std::initializer_list<StageEnumType> mutatingStages);
+        
         // NOTE: use this dispatch() method instead of Dispatcher::dispatch() in
         // your concrete processing functor.
         void dispatch(Message& m);
@@ -31,26 +38,45 @@ namespace wield { namespace adapters {
         template<class ConcreteMessageType>
         void dispatch(ConcreteMessageType& message, CloneMessageTagType);
         
+        // Share the message with read-only stages and clone it only
+        // for the mutating stages.
+        template<class ConcreteMessageType>
+        void dispatch(ConcreteMessageType& message, CopyOnWriteTagType);
+        
     private:
         std::array<StageEnumType, sizeof...(StageList)> stages_;
+        std::vector<StageEnumType> sharedStages_;
+        std::vector<StageEnumType> mutatingStages_;
         Dispatcher& dispatcher_;
     };
     
 
     template<class Dispatcher, class ProcessingFunctorInterface, typename Dispatcher::StageEnumType... StageList>
     FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, StageList...>::FanoutProcessingFunctor(Dispatcher& dispatcher)
+        : stages_({{StageList...}})
+        , sharedStages_({StageList...})
+        , dispatcher_(dispatcher)
+    {
+    }
+
+    template<class Dispatcher, class ProcessingFunctorInterface, typename Dispatcher::StageEnumType... StageList>
+    FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, StageList...>::FanoutProcessingFunctor(Dispatcher& dispatcher, std::initializer_list<StageEnumType> mutatingStages)
         : stages_({{StageList...}})
         , dispatcher_(dispatcher)
     {
+        for(const auto stage : stages_)
+        {
+            const bool mutates = std::find(begin(mutatingStages), end(mutatingStages), stage) != end(mutatingStages);
+            (mutates ? mutatingStages_ : sharedStages_).push_back(stage);
+        }
     }
 
     template<class Dispatcher, class ProcessingFunctorInterface, typename Dispatcher::StageEnumType... StageList>
     inline
     void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, StageList...>::dispatch(Message& m)
     {
-        std::for_each(begin(stages_), end(stages_), [this, &m](const StageEnumType stage){
-            this->dispatcher_.dispatch(stage, m);
-        });
+        // one reference count update for all stages.
+        dispatcher_.dispatchFanout(begin(stages_), end(stages_), m);
     }
     
     template<class Dispatcher, class ProcessingFunctorInterface, typename Dispatcher::StageEnumType... StageList>
@@ -63,4 +89,16 @@ namespace wield { namespace adapters {
         });
     }
 
+    template<class Dispatcher, class ProcessingFunctorInterface, typename Dispatcher::StageEnumType... StageList>
+    template<class ConcreteMessageType>
+    inline
+    void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, StageList...>::dispatch(ConcreteMessageType& m, CopyOnWriteTagType)
+    {
+        std::for_each(begin(mutatingStages_), end(mutatingStages_), [this, &m](const StageEnumType stage){
+            this->dispatcher_.dispatch(stage, m, clone_message);
+        });
+
+        dispatcher_.dispatchFanout(begin(sharedStages_), end(sharedStages_), m);
+    }
+
 }}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+
+namespace wield { namespace adapters {
+
+    namespace details {
+
+        // apply each processing functor in @functors to @message, in order.
+        // The recursion is resolved at compile-time so each call is made on
+        // the concrete functor type.
+        template<std::size_t Index, std::size_t NumberOfProcessingFunctors>
+        struct ProcessWithEach
+        {
+            template<class MessagePtr, class Functors>
+            static inline void apply(const MessagePtr& message, Functors& functors)
+            {
+                message->processWith(std::get<Index>(functors));
+                ProcessWithEach<Index + 1, NumberOfProcessingFunctors>::apply(message, functors);
+            }
+        };
+
+        template<std::size_t NumberOfProcessingFunctors>
+        struct ProcessWithEach<NumberOfProcessingFunctors, NumberOfProcessingFunctors>
+        {
+            template<class MessagePtr, class Functors>
+            static inline void apply(const MessagePtr&, Functors&) {}
+        };
+    }
+
+    // <FusedQueue> is the compile-time counterpart of PassThroughStageQueue
+    // and ProcessingFunctorChain. It satisfies the plain queue concept (push,
+    // try_pop, unsafe_size) without deriving from polymorphic::QueueInterface,
+    // so fusing a stage does not force every other stage in the application
+    // through virtual queue calls.
+    //
+    // A message pushed onto a FusedQueue is processed immediately, in the
+    // thread of the dispatching stage, by each of the @ProcessingFunctors
+    // in the order given. Use it as the concrete queue of a stage in a
+    // static_graph::StageGraph, or as the QueueType of any StageBase whose
+    // queue type is known at compile-time.
+    //
+    // CAVEAT: as with ProcessingFunctorChain, functors other than the last
+    // should not dispatch the message to a different stage as doing so can
+    // introduce race conditions into your application.
+    template<class MessagePtr, class... ProcessingFunctors>
+    class FusedQueue
+    {
+    public:
+        static_assert(sizeof...(ProcessingFunctors) > 0, "FusedQueue requires at least one processing functor.");
+
+        FusedQueue(ProcessingFunctors&... processingFunctors);
+
+        // called in the same thread as the stage invoking dispatch to
+        // the stage owning this queue (the previous stage in the
+        // stage graph).
+        void push(const MessagePtr& message);
+
+        bool try_pop(MessagePtr&) { return false; }
+        std::size_t unsafe_size(void) const { return 0; }
+
+    private:
+        FusedQueue() = delete;
+
+    private:
+        std::tuple<ProcessingFunctors&...> processingFunctors_;
+    };
+
+
+    // A helper to create a FusedQueue from a list of processing functors.
+    //     auto fused = CreateFusedQueue<Message::ptr>(f1, f2, f3);
+    template<class MessagePtr, class... ProcessingFunctors>
+    FusedQueue<MessagePtr, ProcessingFunctors...> CreateFusedQueue(ProcessingFunctors&... processingFunctors)
+    {
+        return FusedQueue<MessagePtr, ProcessingFunctors...>(processingFunctors...);
+    }
+
+
+    template<class MessagePtr, class... ProcessingFunctors>
+    FusedQueue<MessagePtr, ProcessingFunctors...>::FusedQueue(ProcessingFunctors&... processingFunctors)
+        : processingFunctors_(processingFunctors...)
+    {
+    }
+
+    template<class MessagePtr, class... ProcessingFunctors>
+    inline
+    void FusedQueue<MessagePtr, ProcessingFunctors...>::push(const MessagePtr& message)
+    {
+        // process the message immediately with each of the ProcessingFunctors
+        details::ProcessWithEach<0, sizeof...(ProcessingFunctors)>::apply(message, processingFunctors_);
+
+        // the dispatcher increments the reference count before push'ing
+        // we have to decrement it here to ensure memory is cleaned up.
+        message->decrementReferenceCount();
+    }
+}}
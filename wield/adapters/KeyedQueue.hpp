@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace wield { namespace adapters {
+
+    // <KeyedQueue> lets a stage be visited by several threads at once while
+    // keeping the messages of each key in order.
+    //
+    // Messages are split by the hash of their key over @numberOfPartitions
+    // sub-queues of type @Queue. A thread popping a message claims its
+    // partition until the stage tells the queue the message has been
+    // processed (StageBase and static_graph::Stage call processed() for
+    // queues which provide it), so each partition is processed by at most
+    // one thread at a time and messages with the same key are processed in
+    // the order they were dispatched.
+    //
+    // @KeyFunction maps a message to its key, any type std::hash supports:
+    //     struct BySymbol
+    //     {
+    //         std::uint32_t operator()(const Message::ptr& m) const { return static_cast<Order&>(*m).symbol(); }
+    //     };
+    // The key of a message must not change while it is queued or processed,
+    // processed() finds the partition to release from the key.
+    //
+    // @Queue must support concurrent push, pops of a partition are serialized
+    // by its claim. Give the stage a max concurrency of at most
+    // @numberOfPartitions, more threads would only find every partition claimed.
+    //
+    // Use KeyedQueue as a concrete queue type (e.g. in a static_graph::StageGraph).
+    // polymorphic::QueueInterface has no processed(), so it doesn't work
+    // behind a polymorphic::QueueAdapter.
+    template<class MessagePtr, class KeyFunction, class Queue>
+    class KeyedQueue
+    {
+    public:
+        KeyedQueue(const std::size_t numberOfPartitions, const KeyFunction& keyFunction = KeyFunction());
+
+        // enqueue @message on the partition of its key.
+        void push(const MessagePtr& message);
+
+        // pop a message from a partition no other thread has claimed, and
+        // claim that partition until processed(@message) is called.
+        // @return false if every partition is empty or claimed.
+        bool try_pop(MessagePtr& message);
+
+        // release the partition claimed when @message was popped.
+        void processed(const MessagePtr& message);
+
+        std::size_t unsafe_size(void) const;
+
+        std::size_t numberOfPartitions(void) const { return numberOfPartitions_; }
+
+    private:
+        KeyedQueue(const KeyedQueue&) = delete;
+        KeyedQueue& operator=(const KeyedQueue&) = delete;
+
+        struct Partition
+        {
+            Partition() : claimed(false) {}
+
+            Queue queue;
+            std::atomic<bool> claimed;
+        };
+
+        std::size_t partitionOf(const MessagePtr& message) const;
+
+    private:
+        const std::size_t numberOfPartitions_;
+        std::unique_ptr<Partition[]> partitions_;
+        KeyFunction keyFunction_;
+
+        // where the next try_pop starts looking, so threads spread
+        // over the partitions instead of contending for the first.
+        std::atomic<std::size_t> next_;
+    };
+
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    KeyedQueue<MessagePtr, KeyFunction, Queue>::KeyedQueue(const std::size_t numberOfPartitions, const KeyFunction& keyFunction)
+        : numberOfPartitions_(numberOfPartitions)
+        , partitions_(new Partition[numberOfPartitions])
+        , keyFunction_(keyFunction)
+        , next_(0)
+    {
+        if(numberOfPartitions == 0)
+        {
+            throw std::invalid_argument("KeyedQueue needs at least one partition.");
+        }
+    }
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    inline
+    std::size_t KeyedQueue<MessagePtr, KeyFunction, Queue>::partitionOf(const MessagePtr& message) const
+    {
+        using Key = typename std::decay<decltype(keyFunction_(message))>::type;
+        return std::hash<Key>()(keyFunction_(message)) % numberOfPartitions_;
+    }
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    inline
+    void KeyedQueue<MessagePtr, KeyFunction, Queue>::push(const MessagePtr& message)
+    {
+        partitions_[partitionOf(message)].queue.push(message);
+    }
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    bool KeyedQueue<MessagePtr, KeyFunction, Queue>::try_pop(MessagePtr& message)
+    {
+        const std::size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+
+        for(std::size_t i = 0; i < numberOfPartitions_; ++i)
+        {
+            Partition& partition = partitions_[(start + i) % numberOfPartitions_];
+
+            if(partition.claimed.load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+
+            // acquire pairs with the release in processed(), so whatever the
+            // previous claimant did processing this partition is visible.
+            if(partition.claimed.exchange(true, std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            if(partition.queue.try_pop(message))
+            {
+                return true;
+            }
+
+            partition.claimed.store(false, std::memory_order_release);
+        }
+
+        return false;
+    }
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    void KeyedQueue<MessagePtr, KeyFunction, Queue>::processed(const MessagePtr& message)
+    {
+        partitions_[partitionOf(message)].claimed.store(false, std::memory_order_release);
+    }
+
+    template<class MessagePtr, class KeyFunction, class Queue>
+    std::size_t KeyedQueue<MessagePtr, KeyFunction, Queue>::unsafe_size(void) const
+    {
+        std::size_t size = 0;
+        for(std::size_t i = 0; i < numberOfPartitions_; ++i)
+        {
+            size += partitions_[i].queue.unsafe_size();
+        }
+        return size;
+    }
+}}
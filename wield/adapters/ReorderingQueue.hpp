@@ -0,0 +1,393 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace wield { namespace adapters {
+
+    // <ReorderingQueue> restores the order of messages coming out of a
+    // stage with a max concurrency > 1. Use it as the queue of the stage
+    // downstream of the parallel stage.
+    //
+    // Messages carry a sequence number, assigned before the parallel stage,
+    // which @SequenceFunction extracts:
+    //     struct BySequence
+    //     {
+    //         std::uint64_t operator()(const Message::ptr& m) const { return static_cast<Packet&>(*m).sequence(); }
+    //     };
+    // try_pop only releases the message with the next sequence number.
+    //
+    // Messages within @windowSize of the next sequence number are parked in
+    // a ring of atomic slots, so pushes from the parallel stage's threads
+    // don't contend on a lock. Messages further ahead go to an overflow
+    // @Queue and are moved into the ring as the window advances.
+    //
+    // If the next sequence number hasn't arrived while later ones wait for
+    // longer than @gapTimeout (e.g. it was filtered out upstream), the gap
+    // is skipped. A message for a sequence number already skipped is
+    // released as soon as it arrives, out of order, rather than lost.
+    // Pass std::chrono::nanoseconds::max() to never skip gaps.
+    //
+    // Pops are serialized: a try_pop while another thread is popping
+    // returns false, so the downstream stage gains nothing from a max
+    // concurrency > 1.
+    //
+    // @Allocator allocates the ring, a memory::HugePageAllocator keeps a
+    // large window on few TLB entries.
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator = std::allocator<std::atomic<MessagePtr>>>
+    class ReorderingQueue
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        ReorderingQueue(
+            const std::size_t windowSize,
+            const std::chrono::nanoseconds gapTimeout,
+            const std::uint64_t firstSequence = 0,
+            const SequenceFunction& sequenceFunction = SequenceFunction(),
+            const Allocator& allocator = Allocator());
+
+        void push(const MessagePtr& message);
+
+        // @return false if the next message in sequence hasn't arrived
+        // (and the gap hasn't timed out), or another thread is popping.
+        bool try_pop(MessagePtr& message);
+
+        std::size_t unsafe_size(void) const;
+
+        // the sequence number try_pop releases next.
+        std::uint64_t nextSequence(void) const { return next_.load(std::memory_order_relaxed); }
+
+        // number of sequence numbers skipped after timing out.
+        std::uint64_t gapsSkipped(void) const { return gapsSkipped_.load(std::memory_order_relaxed); }
+
+    private:
+        ReorderingQueue(const ReorderingQueue&) = delete;
+        ReorderingQueue& operator=(const ReorderingQueue&) = delete;
+
+        std::atomic<MessagePtr>& slotOf(const std::uint64_t sequence) { return slots_[sequence % windowSize_]; }
+
+        // store @message in the slot for @sequence, which was within the
+        // window when it was checked.
+        void park(std::uint64_t sequence, MessagePtr message);
+
+        // note @sequence was pushed to overflow_.
+        void lowerOverflowFirst(const std::uint64_t sequence);
+
+        // move overflow messages which now fit in the window into their slots.
+        // Called with the pop claim held.
+        void drainOverflow(void);
+
+        // take the next message in sequence, skipping timed out gaps.
+        // Called with the pop claim held.
+        bool popInSequence(MessagePtr& message);
+
+        // the lowest sequence number after @next with a message parked or
+        // in overflow_, @next if none can be seen yet.
+        // Called with the pop claim held.
+        std::uint64_t firstPendingAfter(const std::uint64_t next);
+
+    private:
+        const std::size_t windowSize_;
+        const std::chrono::nanoseconds gapTimeout_;
+        const SequenceFunction sequenceFunction_;
+
+        std::vector<std::atomic<MessagePtr>, Allocator> slots_;
+
+        // messages ahead of the window.
+        Queue overflow_;
+
+        // the lowest sequence number in overflow_, max() if it's empty, so
+        // a pop which finds nothing in the window knows whether draining
+        // would help without looking at every message in there.
+        std::atomic<std::uint64_t> overflowFirst_;
+
+        // messages whose sequence number was skipped, released as they come.
+        Queue late_;
+
+        std::atomic<std::uint64_t> next_;
+
+        // messages parked in slots_ or overflow_.
+        std::atomic<std::size_t> pending_;
+
+        std::atomic<std::uint64_t> gapsSkipped_;
+
+        std::atomic<bool> popping_;
+
+        // only touched with the pop claim held.
+        bool waitingOnGap_;
+        Clock::time_point gapSince_;
+    };
+
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::ReorderingQueue(
+        const std::size_t windowSize,
+        const std::chrono::nanoseconds gapTimeout,
+        const std::uint64_t firstSequence,
+        const SequenceFunction& sequenceFunction,
+        const Allocator& allocator)
+        : windowSize_(windowSize)
+        , gapTimeout_(gapTimeout)
+        , sequenceFunction_(sequenceFunction)
+        , slots_(windowSize, allocator)
+        , overflowFirst_(std::numeric_limits<std::uint64_t>::max())
+        , next_(firstSequence)
+        , pending_(0)
+        , gapsSkipped_(0)
+        , popping_(false)
+        , waitingOnGap_(false)
+    {
+        if(windowSize == 0)
+        {
+            throw std::invalid_argument("ReorderingQueue needs a window of at least one message.");
+        }
+
+        for(std::size_t i = 0; i < windowSize_; ++i)
+        {
+            slots_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    void ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::push(const MessagePtr& message)
+    {
+        const std::uint64_t sequence = sequenceFunction_(message);
+        const std::uint64_t next = next_.load();
+
+        if(sequence < next)
+        {
+            late_.push(message);
+            return;
+        }
+
+        // count before publishing, so a pop never sees more messages than pending_.
+        pending_.fetch_add(1, std::memory_order_relaxed);
+
+        if(sequence - next >= windowSize_)
+        {
+            overflow_.push(message);
+            lowerOverflowFirst(sequence);
+            return;
+        }
+
+        park(sequence, message);
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    void ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::park(std::uint64_t sequence, MessagePtr message)
+    {
+        std::atomic<MessagePtr>& slot = slotOf(sequence);
+
+        for(;;)
+        {
+            // a gap may have been skipped past @sequence since push() checked it.
+            if(sequence < next_.load())
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                late_.push(message);
+                return;
+            }
+
+            MessagePtr occupant = nullptr;
+            if(slot.compare_exchange_strong(occupant, message))
+            {
+                break;
+            }
+
+            // take the occupant out to look at it, try_pop may release it first.
+            if(!slot.compare_exchange_strong(occupant, nullptr))
+            {
+                continue;
+            }
+
+            // only one of two messages sharing a slot can be in the window,
+            // the one behind it was skipped over by a gap: move that one
+            // along as late and park the other.
+            const std::uint64_t occupantSequence = sequenceFunction_(occupant);
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+
+            if(occupantSequence < sequence)
+            {
+                late_.push(occupant);
+            }
+            else
+            {
+                late_.push(message);
+                message = occupant;
+                sequence = occupantSequence;
+            }
+        }
+
+        // a gap may have been skipped past @sequence while it was parked,
+        // take it back unless try_pop got to it first.
+        MessagePtr expected = message;
+        if(sequence < next_.load() && slot.compare_exchange_strong(expected, nullptr))
+        {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            late_.push(message);
+        }
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    bool ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::try_pop(MessagePtr& message)
+    {
+        if(late_.try_pop(message))
+        {
+            return true;
+        }
+
+        if(popping_.load(std::memory_order_relaxed) || popping_.exchange(true, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const bool popped = popInSequence(message);
+
+        popping_.store(false, std::memory_order_release);
+        return popped;
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    bool ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::popInSequence(MessagePtr& message)
+    {
+        bool drained = false;
+
+        while(pending_.load(std::memory_order_acquire) != 0)
+        {
+            const std::uint64_t next = next_.load(std::memory_order_relaxed);
+
+            MessagePtr m = slotOf(next).exchange(nullptr);
+            if(m != nullptr)
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                waitingOnGap_ = false;
+
+                // a message for a sequence number skipped after it was
+                // checked against next_ in push(), release it as late.
+                if(sequenceFunction_(m) == next)
+                {
+                    next_.store(next + 1);
+                }
+
+                message = m;
+                return true;
+            }
+
+            if(!drained && overflowFirst_.load() < next + windowSize_)
+            {
+                drainOverflow();
+                drained = true;
+                continue;
+            }
+
+            const Clock::time_point now = Clock::now();
+            if(!waitingOnGap_)
+            {
+                waitingOnGap_ = true;
+                gapSince_ = now;
+                return false;
+            }
+
+            if(now - gapSince_ < gapTimeout_)
+            {
+                return false;
+            }
+
+            // skip the gap, and every empty sequence number up to the next
+            // message: the timeout already passed for all of them.
+            const std::uint64_t first = firstPendingAfter(next);
+            if(first == next)
+            {
+                return false;
+            }
+
+            next_.store(first);
+            gapsSkipped_.fetch_add(first - next, std::memory_order_relaxed);
+            drained = false;
+        }
+
+        waitingOnGap_ = false;
+        return false;
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    void ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::lowerOverflowFirst(const std::uint64_t sequence)
+    {
+        std::uint64_t first = overflowFirst_.load();
+        while(sequence < first && !overflowFirst_.compare_exchange_weak(first, sequence))
+        {
+        }
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    void ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::drainOverflow(void)
+    {
+        const std::uint64_t next = next_.load(std::memory_order_relaxed);
+
+        // recomputed from the messages put back. A push lowers it after
+        // its message is in overflow_, so one not counted below still
+        // shows here.
+        overflowFirst_.store(std::numeric_limits<std::uint64_t>::max());
+
+        // only look at what's there now, messages put back aren't revisited.
+        for(std::size_t count = overflow_.unsafe_size(); count != 0; --count)
+        {
+            MessagePtr m = nullptr;
+            if(!overflow_.try_pop(m))
+            {
+                break;
+            }
+
+            const std::uint64_t sequence = sequenceFunction_(m);
+            if(sequence < next)
+            {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                late_.push(m);
+            }
+            else if(sequence - next < windowSize_)
+            {
+                park(sequence, m);
+            }
+            else
+            {
+                overflow_.push(m);
+                lowerOverflowFirst(sequence);
+            }
+        }
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    std::uint64_t ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::firstPendingAfter(const std::uint64_t next)
+    {
+        // a message in the window is found by its slot, without looking at it.
+        for(std::uint64_t sequence = next + 1; sequence < next + windowSize_; ++sequence)
+        {
+            if(slotOf(sequence).load(std::memory_order_relaxed) != nullptr)
+            {
+                return sequence;
+            }
+        }
+
+        // the window is empty, but there may be messages beyond it. One at
+        // or behind @next was pushed since the drain, the next pop takes it.
+        const std::uint64_t first = overflowFirst_.load();
+        if(first == std::numeric_limits<std::uint64_t>::max() || first <= next)
+        {
+            return next;
+        }
+
+        return first;
+    }
+
+    template<class MessagePtr, class SequenceFunction, class Queue, class Allocator>
+    std::size_t ReorderingQueue<MessagePtr, SequenceFunction, Queue, Allocator>::unsafe_size(void) const
+    {
+        return pending_.load(std::memory_order_relaxed) + late_.unsafe_size();
+    }
+}}
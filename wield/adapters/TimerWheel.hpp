@@ -0,0 +1,504 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/MessageBase.hpp>
+#include <wield/details/SmartPtrCreator.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace wield { namespace adapters {
+
+    // identifies a scheduled timeout so it can be cancelled.
+    struct TimerHandle
+    {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    // <TimerWheel> is the queue of a timer stage. Processing functors
+    // schedule timeouts into it, and when the scheduler visits the timer
+    // stage the expired timeouts are dispatched to their target stages.
+    //
+    // Timeouts are kept in a hierarchical timing wheel: NumberOfLevels
+    // wheels of SlotsPerLevel slots, each level's slot spanning a full turn
+    // of the level below. schedule() and cancel() are O(1), a timeout is
+    // moved down a level at most NumberOfLevels - 1 times before it
+    // expires. Timeouts are rounded up to whole ticks; @tick trades
+    // resolution for the number of slots visited while advancing.
+    //
+    // The scheduled message is referenced until it is dispatched or
+    // cancelled. Nothing is pushed onto the timer stage itself, push()
+    // throws, and try_pop() never returns a message: it dispatches what
+    // expired and returns false, so the scheduler moves on. Dispatching
+    // is done outside the wheel's lock, so target stages may schedule
+    // timeouts from inside push.
+    //
+    // Use it directly as a concrete queue (e.g. in a static_graph::StageGraph),
+    // or behind a polymorphic::QueueAdapter and reach it with queue().
+    template<class StageEnum, class Message>
+    class TimerWheel
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+        using Clock = std::chrono::steady_clock;
+
+        static const std::size_t NumberOfLevels = 4;
+        static const std::size_t BitsPerLevel = 8;
+        static const std::size_t SlotsPerLevel = std::size_t(1) << BitsPerLevel;
+
+        // @dispatcher anything with dispatch(StageEnum, Message&), it isn't
+        // part of the type so a static_graph dispatcher can name this queue.
+        template<class Dispatcher>
+        TimerWheel(Dispatcher& dispatcher, const std::chrono::nanoseconds tick, const Clock::time_point start = Clock::now());
+
+        ~TimerWheel();
+
+        // dispatch @message to @target once @timeout elapses.
+        TimerHandle schedule(const StageEnum target, Message& message, const std::chrono::nanoseconds timeout);
+
+        // dispatch @message to @target at @deadline.
+        TimerHandle scheduleAt(const StageEnum target, Message& message, const Clock::time_point deadline);
+
+        // @return true if the timeout was cancelled before it expired.
+        bool cancel(const TimerHandle& handle);
+
+        // dispatch the timeouts which expired by @now, another thread
+        // already doing so makes this a no-op.
+        // @return the number of messages dispatched.
+        std::size_t expire(const Clock::time_point now);
+
+        // timer stages are event sources, this should never be called.
+        void push(const MessagePtr&);
+
+        // dispatch the timeouts which expired by now.
+        // @return false, there is never a message to process.
+        bool try_pop(MessagePtr& message);
+
+        // nothing waits to be processed on the timer stage.
+        std::size_t unsafe_size(void) const { return 0; }
+
+        // number of scheduled timeouts.
+        std::size_t size(void) const;
+
+    private:
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        static const std::uint32_t Nil = std::numeric_limits<std::uint32_t>::max();
+        static const std::uint64_t SlotMask = SlotsPerLevel - 1;
+        static const std::size_t NumberOfSlots = NumberOfLevels * SlotsPerLevel;
+
+        struct Timer
+        {
+            std::uint64_t expiry;
+            MessagePtr message;
+            StageEnum target;
+            std::uint32_t generation;
+            std::uint32_t slot;
+            std::uint32_t previous;
+            std::uint32_t next;
+        };
+
+        struct Expired
+        {
+            StageEnum target;
+            MessagePtr message;
+        };
+
+        template<class Dispatcher>
+        static void dispatchTo(void* dispatcher, const StageEnum target, Message& message)
+        {
+            static_cast<Dispatcher*>(dispatcher)->dispatch(target, message);
+        }
+
+        std::uint64_t tickOf(const Clock::time_point t) const;
+
+        // link @index into the slot for its expiry relative to now_.
+        void insert(const std::uint32_t index);
+        void unlink(const std::uint32_t index);
+        void release(const std::uint32_t index);
+
+        // move the timeouts of the slot at @level down the wheel.
+        void cascade(const std::size_t level);
+
+        // advance now_ by one tick, collecting what expires into expired_.
+        void advance(void);
+
+        // the last tick before anything can expire or move down a level.
+        std::uint64_t lastIdleTick(void) const;
+
+    private:
+        void* dispatcher_;
+        void (*dispatch_)(void*, const StageEnum, Message&);
+
+        const std::chrono::nanoseconds tick_;
+        const Clock::time_point start_;
+
+        mutable std::mutex lock_;
+
+        // every tick up to and including now_ has been expired.
+        std::uint64_t now_;
+
+        std::vector<Timer> timers_;
+        std::uint32_t free_;
+        std::size_t size_;
+
+        std::array<std::uint32_t, NumberOfSlots> slots_;
+
+        // number of timeouts on each level.
+        std::array<std::size_t, NumberOfLevels> counts_;
+
+        // only touched by the thread which claimed expiring_.
+        std::atomic<bool> expiring_;
+        std::vector<Expired> expired_;
+    };
+
+    template<class StageEnum, class Message> const std::size_t TimerWheel<StageEnum, Message>::NumberOfLevels;
+    template<class StageEnum, class Message> const std::size_t TimerWheel<StageEnum, Message>::BitsPerLevel;
+    template<class StageEnum, class Message> const std::size_t TimerWheel<StageEnum, Message>::SlotsPerLevel;
+    template<class StageEnum, class Message> const std::uint32_t TimerWheel<StageEnum, Message>::Nil;
+    template<class StageEnum, class Message> const std::uint64_t TimerWheel<StageEnum, Message>::SlotMask;
+    template<class StageEnum, class Message> const std::size_t TimerWheel<StageEnum, Message>::NumberOfSlots;
+
+
+    template<class StageEnum, class Message>
+    template<class Dispatcher>
+    TimerWheel<StageEnum, Message>::TimerWheel(Dispatcher& dispatcher, const std::chrono::nanoseconds tick, const Clock::time_point start)
+        : dispatcher_(&dispatcher)
+        , dispatch_(&TimerWheel::dispatchTo<Dispatcher>)
+        , tick_(tick)
+        , start_(start)
+        , now_(0)
+        , free_(Nil)
+        , size_(0)
+        , expiring_(false)
+    {
+        slots_.fill(Nil);
+        counts_.fill(0);
+    }
+
+    template<class StageEnum, class Message>
+    TimerWheel<StageEnum, Message>::~TimerWheel()
+    {
+        for(auto& timer : timers_)
+        {
+            if(timer.slot != Nil)
+            {
+                timer.message->decrementReferenceCount();
+            }
+        }
+    }
+
+    template<class StageEnum, class Message>
+    inline
+    TimerHandle TimerWheel<StageEnum, Message>::schedule(const StageEnum target, Message& message, const std::chrono::nanoseconds timeout)
+    {
+        return scheduleAt(target, message, Clock::now() + timeout);
+    }
+
+    template<class StageEnum, class Message>
+    TimerHandle TimerWheel<StageEnum, Message>::scheduleAt(const StageEnum target, Message& message, const Clock::time_point deadline)
+    {
+        message.incrementReferenceCount();
+
+        std::lock_guard<std::mutex> lock(lock_);
+
+        std::uint32_t index = free_;
+        if(index != Nil)
+        {
+            free_ = timers_[index].next;
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(timers_.size());
+            timers_.push_back(Timer{0, nullptr, target, 0, Nil, Nil, Nil});
+        }
+
+        // tick now_ has already been expired, one already due fires on the next.
+        const std::uint64_t expiry = tickOf(deadline);
+
+        Timer& timer = timers_[index];
+        timer.expiry = expiry > now_ ? expiry : now_ + 1;
+        timer.message = &message;
+        timer.target = target;
+
+        insert(index);
+        size_++;
+
+        return TimerHandle{index, timer.generation};
+    }
+
+    template<class StageEnum, class Message>
+    bool TimerWheel<StageEnum, Message>::cancel(const TimerHandle& handle)
+    {
+        MessagePtr message = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+
+            if(handle.index >= timers_.size())
+            {
+                return false;
+            }
+
+            Timer& timer = timers_[handle.index];
+            if(timer.generation != handle.generation || timer.slot == Nil)
+            {
+                return false;
+            }
+
+            message = timer.message;
+            unlink(handle.index);
+            release(handle.index);
+        }
+
+        message->decrementReferenceCount();
+        return true;
+    }
+
+    template<class StageEnum, class Message>
+    std::size_t TimerWheel<StageEnum, Message>::expire(const Clock::time_point now)
+    {
+        if(expiring_.load(std::memory_order_relaxed) || expiring_.exchange(true, std::memory_order_acquire))
+        {
+            return 0;
+        }
+
+        // releases the claim, and the references of what wasn't
+        // dispatched when a dispatch throws.
+        struct Release
+        {
+            ~Release()
+            {
+                for(; dispatched < expired.size(); ++dispatched)
+                {
+                    expired[dispatched].message->decrementReferenceCount();
+                }
+
+                expired.clear();
+                expiring.store(false, std::memory_order_release);
+            }
+
+            std::atomic<bool>& expiring;
+            std::vector<Expired>& expired;
+            std::size_t dispatched;
+        } release{expiring_, expired_, 0};
+
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+
+            const std::uint64_t target = tickOf(now);
+            while(now_ < target)
+            {
+                // skip the ticks on which nothing happens.
+                const std::uint64_t idle = lastIdleTick();
+                if(idle > now_)
+                {
+                    now_ = idle < target ? idle : target;
+                    continue;
+                }
+
+                advance();
+            }
+        }
+
+        // the wheel's reference is handed to a handle, so a uniquely owned
+        // message moves on to its target rather than being shared with it.
+        const std::size_t count = expired_.size();
+        while(release.dispatched < count)
+        {
+            const Expired& expired = expired_[release.dispatched++];
+            typename Message::smartptr message(wield::details::create_smartptr<Message>(expired.message, no_increment));
+            dispatch_(dispatcher_, expired.target, *message);
+        }
+
+        return count;
+    }
+
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::push(const MessagePtr&)
+    {
+        throw IllegallyPushedMessageOntoTimerWheel();
+    }
+
+    template<class StageEnum, class Message>
+    bool TimerWheel<StageEnum, Message>::try_pop(MessagePtr&)
+    {
+        expire(Clock::now());
+        return false;
+    }
+
+    template<class StageEnum, class Message>
+    std::size_t TimerWheel<StageEnum, Message>::size(void) const
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        return size_;
+    }
+
+    template<class StageEnum, class Message>
+    inline
+    std::uint64_t TimerWheel<StageEnum, Message>::tickOf(const Clock::time_point t) const
+    {
+        if(t <= start_)
+        {
+            return 0;
+        }
+
+        // round up, a timeout never fires early.
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_);
+        return static_cast<std::uint64_t>((elapsed.count() + tick_.count() - 1) / tick_.count());
+    }
+
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::insert(const std::uint32_t index)
+    {
+        Timer& timer = timers_[index];
+
+        // when cascading, a timeout may be due on now_ itself.
+        const std::uint64_t expiry = timer.expiry;
+        const std::uint64_t delta = expiry - now_;
+
+        // the first level whose span covers @delta. Beyond the last level
+        // park it in the furthest slot, it's moved down from there with
+        // its real expiry.
+        std::size_t level = 0;
+        while(level < NumberOfLevels - 1 && delta >= (std::uint64_t(1) << (BitsPerLevel * (level + 1))))
+        {
+            ++level;
+        }
+
+        const std::uint64_t last = now_ + (std::uint64_t(1) << (BitsPerLevel * NumberOfLevels)) - 1;
+        const std::uint64_t placed = expiry < last ? expiry : last;
+
+        const std::uint32_t slot = static_cast<std::uint32_t>(level * SlotsPerLevel + ((placed >> (BitsPerLevel * level)) & SlotMask));
+
+        timer.slot = slot;
+        counts_[level]++;
+
+        timer.previous = Nil;
+        timer.next = slots_[slot];
+
+        if(timer.next != Nil)
+        {
+            timers_[timer.next].previous = index;
+        }
+        slots_[slot] = index;
+    }
+
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::unlink(const std::uint32_t index)
+    {
+        Timer& timer = timers_[index];
+        counts_[timer.slot / SlotsPerLevel]--;
+
+        if(timer.previous != Nil)
+        {
+            timers_[timer.previous].next = timer.next;
+        }
+        else
+        {
+            slots_[timer.slot] = timer.next;
+        }
+
+        if(timer.next != Nil)
+        {
+            timers_[timer.next].previous = timer.previous;
+        }
+    }
+
+    // return the timer to the free list, old handles to it no longer match.
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::release(const std::uint32_t index)
+    {
+        Timer& timer = timers_[index];
+
+        timer.message = nullptr;
+        timer.slot = Nil;
+        timer.generation++;
+        timer.next = free_;
+        free_ = index;
+
+        size_--;
+    }
+
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::cascade(const std::size_t level)
+    {
+        const std::size_t slot = level * SlotsPerLevel + ((now_ >> (BitsPerLevel * level)) & SlotMask);
+
+        std::uint32_t index = slots_[slot];
+        slots_[slot] = Nil;
+
+        while(index != Nil)
+        {
+            const std::uint32_t next = timers_[index].next;
+            counts_[level]--;
+            insert(index);
+            index = next;
+        }
+    }
+
+    template<class StageEnum, class Message>
+    void TimerWheel<StageEnum, Message>::advance(void)
+    {
+        ++now_;
+
+        // when a level wraps, the next slot of the level above is due.
+        for(std::size_t level = 1; level < NumberOfLevels; ++level)
+        {
+            if(((now_ >> (BitsPerLevel * (level - 1))) & SlotMask) != 0)
+            {
+                break;
+            }
+            cascade(level);
+        }
+
+        // cascading may put timeouts into this very slot, so take it after.
+        const std::size_t slot = now_ & SlotMask;
+
+        std::uint32_t index = slots_[slot];
+        slots_[slot] = Nil;
+
+        while(index != Nil)
+        {
+            Timer& timer = timers_[index];
+            const std::uint32_t next = timer.next;
+
+            expired_.push_back(Expired{timer.target, timer.message});
+            counts_[0]--;
+            release(index);
+
+            index = next;
+        }
+    }
+
+    template<class StageEnum, class Message>
+    std::uint64_t TimerWheel<StageEnum, Message>::lastIdleTick(void) const
+    {
+        // with the levels up to @level empty, nothing happens before the
+        // level above moves its next slot down, when @level wraps.
+        std::size_t level = 0;
+        while(level < NumberOfLevels && counts_[level] == 0)
+        {
+            ++level;
+        }
+
+        if(level == NumberOfLevels)
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+
+        if(level == 0)
+        {
+            return now_;
+        }
+
+        return now_ | ((std::uint64_t(1) << (BitsPerLevel * level)) - 1);
+    }
+}}
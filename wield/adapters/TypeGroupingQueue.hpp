@@ -0,0 +1,210 @@
+#pragma once
+#include <wield/details/BulkPush.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace wield { namespace adapters {
+
+    // the dynamic type of a message, read from its vtable.
+    struct ByDynamicType
+    {
+        template<class MessagePtr>
+        const std::type_info* operator()(const MessagePtr& message) const { return &typeid(*message); }
+    };
+
+    // <TypeGroupingQueue> hands out the messages of a stage grouped by type.
+    // try_pop takes up to @batchSize messages from @Queue at once and
+    // releases them one type after another, so the stage's processWith
+    // calls land on the same message class (and ProcessingFunctor overload)
+    // back-to-back: the indirect branches are predicted, and the code of
+    // each overload stays hot, where a mix of types in arrival order
+    // mispredicts on most messages.
+    //
+    // Only for stages which don't care about the order of their messages:
+    // messages of one type keep their order, across types it's lost. Types
+    // come out in the order they first appear in each batch.
+    //
+    // @TypeFunction maps a message to its group, anything comparable with ==.
+    // ByDynamicType groups by concrete class, one with a type id field saves
+    // the vtable load:
+    //     struct ByKind
+    //     {
+    //         std::uint8_t operator()(const Message::ptr& m) const { return static_cast<const Packet&>(*m).kind(); }
+    //     };
+    //
+    // Pops are serialized: a try_pop while another thread is popping
+    // returns false, so the stage gains nothing from a max concurrency > 1.
+    // @Queue's processed() isn't forwarded, don't wrap a KeyedQueue.
+    template<class MessagePtr, class Queue, class TypeFunction = ByDynamicType>
+    class TypeGroupingQueue
+    {
+    public:
+        TypeGroupingQueue(const std::size_t batchSize = 64, const TypeFunction& typeFunction = TypeFunction());
+
+        void push(const MessagePtr& message);
+
+        template<class Iterator>
+        void push_bulk(Iterator first, Iterator last);
+
+        // @return false if there are no messages, or another thread is popping.
+        bool try_pop(MessagePtr& message);
+
+        std::size_t unsafe_size(void) const;
+
+        // the underlying queue.
+        Queue& queue(void) { return queue_; }
+
+    private:
+        using Type = typename std::decay<decltype(std::declval<const TypeFunction&>()(std::declval<const MessagePtr&>()))>::type;
+
+        TypeGroupingQueue(const TypeGroupingQueue&) = delete;
+        TypeGroupingQueue& operator=(const TypeGroupingQueue&) = delete;
+
+        // take the next batch from queue_ and group it into batch_. If
+        // @TypeFunction throws, the batch is left in the order it arrived.
+        // Called with the pop claim held.
+        void refill(void);
+
+    private:
+        const std::size_t batchSize_;
+        const TypeFunction typeFunction_;
+
+        Queue queue_;
+
+        // only touched with the pop claim held.
+        std::vector<MessagePtr> pulled_;
+        std::vector<Type> types_;
+        std::vector<bool> grouped_;
+        std::vector<MessagePtr> batch_;
+        std::size_t next_;
+
+        // messages of batch_ not yet popped.
+        std::atomic<std::size_t> buffered_;
+
+        std::atomic<bool> popping_;
+    };
+
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::TypeGroupingQueue(const std::size_t batchSize, const TypeFunction& typeFunction)
+        : batchSize_(batchSize)
+        , typeFunction_(typeFunction)
+        , next_(0)
+        , buffered_(0)
+        , popping_(false)
+    {
+        if(batchSize == 0)
+        {
+            throw std::invalid_argument("TypeGroupingQueue needs a batch of at least one message.");
+        }
+
+        pulled_.reserve(batchSize_);
+        types_.reserve(batchSize_);
+        grouped_.reserve(batchSize_);
+        batch_.reserve(batchSize_);
+    }
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    inline
+    void TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::push(const MessagePtr& message)
+    {
+        queue_.push(message);
+    }
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    template<class Iterator>
+    inline
+    void TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::push_bulk(Iterator first, Iterator last)
+    {
+        details::bulk_push<MessagePtr>(queue_, first, last);
+    }
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    bool TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::try_pop(MessagePtr& message)
+    {
+        if(popping_.load(std::memory_order_relaxed) || popping_.exchange(true, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        struct Release
+        {
+            ~Release() { popping.store(false, std::memory_order_release); }
+            std::atomic<bool>& popping;
+        } release{popping_};
+
+        if(next_ == batch_.size())
+        {
+            refill();
+        }
+
+        if(next_ == batch_.size())
+        {
+            return false;
+        }
+
+        message = batch_[next_++];
+        buffered_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    void TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::refill(void)
+    {
+        pulled_.clear();
+        types_.clear();
+        batch_.clear();
+        next_ = 0;
+
+        MessagePtr m = nullptr;
+        try
+        {
+            while(pulled_.size() < batchSize_ && queue_.try_pop(m))
+            {
+                pulled_.push_back(m);
+                types_.push_back(typeFunction_(m));
+            }
+        }
+        catch(...)
+        {
+            // what was pulled, the message that failed too, is popped ungrouped.
+            batch_.assign(pulled_.begin(), pulled_.end());
+            buffered_.fetch_add(batch_.size(), std::memory_order_relaxed);
+            throw;
+        }
+
+        // a pass per type in the batch: few types, few passes.
+        grouped_.assign(pulled_.size(), false);
+        for(std::size_t first = 0; first < pulled_.size(); ++first)
+        {
+            if(grouped_[first])
+            {
+                continue;
+            }
+
+            for(std::size_t i = first; i < pulled_.size(); ++i)
+            {
+                if(!grouped_[i] && types_[i] == types_[first])
+                {
+                    grouped_[i] = true;
+                    batch_.push_back(pulled_[i]);
+                }
+            }
+        }
+
+        buffered_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    }
+
+    template<class MessagePtr, class Queue, class TypeFunction>
+    inline
+    std::size_t TypeGroupingQueue<MessagePtr, Queue, TypeFunction>::unsafe_size(void) const
+    {
+        return queue_.unsafe_size() + buffered_.load(std::memory_order_relaxed);
+    }
+}}
@@ -1,87 +1,221 @@
 #pragma once
 #include <wield/CloneMessageTag.hpp>
+#include <wield/memory/QuiescentState.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 namespace wield { namespace adapters { namespace dynamic {
-    
+
     // An abstract base class which implements logic necessary to
     // fanout a message to multiple downstream stages. The stages
     // to fanout to determined at construction.
+    //
+    // The fanout configuration may be replaced with updateStages() from
+    // a control thread while the pipeline is running. dispatch() only
+    // loads the current configuration, a replaced one is kept until every
+    // thread which may be walking it has been quiescent, see
+    // memory::QuiescentState, and freed by a later updateStages().
     template<class Dispatcher, class ProcessingFunctorInterface>
     class FanoutProcessingFunctor : public ProcessingFunctorInterface
     {
     public:
         using StageEnumType = typename Dispatcher::StageEnumType;
         using Message = typename ProcessingFunctorInterface::Message;
-        
+
         FanoutProcessingFunctor(Dispatcher& dispatcher, const std::vector<StageEnumType>& stages);
         FanoutProcessingFunctor(Dispatcher& dispatcher, std::vector<StageEnumType>&& stages);
-        
+
+        // @mutatingStages the stages of @stages which modify the messages
+        // they receive, they get a clone when dispatching with copy_on_write.
+        FanoutProcessingFunctor(Dispatcher& dispatcher, const std::vector<StageEnumType>& stages, const std::vector<StageEnumType>& mutatingStages);
+
         // NOTE: use this dispatch() method instead of Dispatcher::dispatch() in
         // your concrete processing functor.
         void dispatch(Message& m);
-        
+
         // NOTE: use this dispatch() method instead of Dispatcher::dispatch() in
         // your concrete processing functor.
         template<class ConcreteMessageType>
         void dispatch(ConcreteMessageType& message, CloneMessageTagType);
-        
-        // swap the current fanout configuration with @stages
+
+        // Share the message with read-only stages and clone it only
+        // for the mutating stages.
+        template<class ConcreteMessageType>
+        void dispatch(ConcreteMessageType& message, CopyOnWriteTagType);
+
+        // swap the current fanout configuration with @stages,
+        // safe to call while messages are being dispatched. Frees the
+        // replaced configurations no thread can be reading anymore, it
+        // doesn't wait for the others: don't call it from this functor's
+        // own processing.
         void updateStages(const std::vector<StageEnumType>& stages);
         void updateStages(std::vector<StageEnumType>&& stages);
-        
+        void updateStages(const std::vector<StageEnumType>& stages, const std::vector<StageEnumType>& mutatingStages);
+
+    private:
+        FanoutProcessingFunctor(const FanoutProcessingFunctor&) = delete;
+        FanoutProcessingFunctor& operator=(const FanoutProcessingFunctor&) = delete;
+
+        // an immutable fanout configuration.
+        struct Configuration
+        {
+            Configuration(std::vector<StageEnumType>&& stages, const std::vector<StageEnumType>& mutatingStages);
+
+            const std::vector<StageEnumType> stages_;
+            std::vector<StageEnumType> sharedStages_;
+            std::vector<StageEnumType> mutatingStages_;
+        };
+
+        // a configuration replaced at the start of the grace period @epoch.
+        struct Retired
+        {
+            std::uint64_t epoch;
+            std::unique_ptr<const Configuration> configuration;
+        };
+
+        // the configuration to dispatch with, valid until the calling
+        // thread is next quiescent.
+        const Configuration& current(void) const;
+
+        // make @configuration the current configuration.
+        void publish(std::unique_ptr<const Configuration> configuration);
+
     private:
-        std::vector<StageEnumType> stages_;
         Dispatcher& dispatcher_;
+
+        std::atomic<const Configuration*> current_;
+
+        // the following are guarded by publishLock_.
+        std::unique_ptr<const Configuration> owned_;
+        std::vector<Retired> retired_;
+        std::mutex publishLock_;
     };
-    
-    
+
+
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::Configuration::Configuration(std::vector<StageEnumType>&& stages, const std::vector<StageEnumType>& mutatingStages)
+        : stages_(std::move(stages))
+    {
+        for(const auto stage : stages_)
+        {
+            const bool mutates = std::find(begin(mutatingStages), end(mutatingStages), stage) != end(mutatingStages);
+            (mutates ? mutatingStages_ : sharedStages_).push_back(stage);
+        }
+    }
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::FanoutProcessingFunctor(Dispatcher& dispatcher, const std::vector<StageEnumType>& stages)
-        : stages_(stages)
-        , dispatcher_(dispatcher)
+        : dispatcher_(dispatcher)
+        , current_(nullptr)
     {
+        updateStages(stages);
     }
-    
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::FanoutProcessingFunctor(Dispatcher& dispatcher, std::vector<StageEnumType>&& stages)
-        : stages_(std::move(stages))
-        , dispatcher_(dispatcher)
+        : dispatcher_(dispatcher)
+        , current_(nullptr)
+    {
+        updateStages(std::move(stages));
+    }
+
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::FanoutProcessingFunctor(Dispatcher& dispatcher, const std::vector<StageEnumType>& stages, const std::vector<StageEnumType>& mutatingStages)
+        : dispatcher_(dispatcher)
+        , current_(nullptr)
     {
+        updateStages(stages, mutatingStages);
     }
-    
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     inline
     void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::dispatch(Message& m)
     {
-        std::for_each(begin(stages_), end(stages_), [this, &m](const StageEnumType stage){
-            this->dispatcher_.dispatch(stage, m);
-        });
+        const Configuration& configuration = current();
+
+        // one reference count update for all stages.
+        dispatcher_.dispatchFanout(begin(configuration.stages_), end(configuration.stages_), m);
     }
-    
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     template<class ConcreteMessageType>
     inline
     void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::dispatch(ConcreteMessageType& m, CloneMessageTagType)
     {
-        std::for_each(begin(stages_), end(stages_), [this, &m](const StageEnumType stage){
+        const Configuration& configuration = current();
+
+        std::for_each(begin(configuration.stages_), end(configuration.stages_), [this, &m](const StageEnumType stage){
             this->dispatcher_.dispatch(stage, m, clone_message);
         });
     }
-    
+
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    template<class ConcreteMessageType>
+    inline
+    void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::dispatch(ConcreteMessageType& m, CopyOnWriteTagType)
+    {
+        const Configuration& configuration = current();
+
+        std::for_each(begin(configuration.mutatingStages_), end(configuration.mutatingStages_), [this, &m](const StageEnumType stage){
+            this->dispatcher_.dispatch(stage, m, clone_message);
+        });
+
+        dispatcher_.dispatchFanout(begin(configuration.sharedStages_), end(configuration.sharedStages_), m);
+    }
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     inline
     void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::updateStages(const std::vector<StageEnumType>& stages)
     {
-        stages_ = stages;
+        updateStages(stages, {});
     }
-    
+
     template<class Dispatcher, class ProcessingFunctorInterface>
     inline
     void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::updateStages(std::vector<StageEnumType>&& stages)
     {
-        stages_.swap(stages);
+        publish(std::unique_ptr<const Configuration>(new Configuration(std::move(stages), {})));
     }
-}}}
 
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    inline
+    void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::updateStages(const std::vector<StageEnumType>& stages, const std::vector<StageEnumType>& mutatingStages)
+    {
+        publish(std::unique_ptr<const Configuration>(new Configuration(std::vector<StageEnumType>(stages), mutatingStages)));
+    }
+
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    inline
+    const typename FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::Configuration& FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::current(void) const
+    {
+        memory::QuiescentState::online();
+        return *current_.load(std::memory_order_acquire);
+    }
+
+    template<class Dispatcher, class ProcessingFunctorInterface>
+    void FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::publish(std::unique_ptr<const Configuration> configuration)
+    {
+        std::lock_guard<std::mutex> lock(publishLock_);
+
+        current_.store(configuration.get());
+        if(owned_)
+        {
+            retired_.push_back(Retired{ memory::QuiescentState::retire(), std::move(owned_) });
+        }
+        owned_ = std::move(configuration);
+
+        // the calling thread isn't walking a configuration, by contract.
+        memory::QuiescentState::quiescent();
+
+        // free those whose grace period is over.
+        retired_.erase(std::remove_if(begin(retired_), end(retired_), [](const Retired& retired){
+            return memory::QuiescentState::elapsed(retired.epoch);
+        }), end(retired_));
+    }
+}}}
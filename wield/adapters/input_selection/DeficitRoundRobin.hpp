@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace wield { namespace adapters { namespace input_selection {
+
+    // the default message cost for DeficitRoundRobin, every message costs 1.
+    struct UnitCost
+    {
+        template<class MessagePtr>
+        inline std::int64_t operator()(const MessagePtr&) const { return 1; }
+    };
+
+    // This input selection policy implements deficit round robin. Each
+    // visit to an input adds its weight (quantum) to the input's deficit
+    // and messages are taken while the deficit is positive, each message
+    // subtracting its <MessageCost>. Unused deficit carries over to the
+    // next visit unless the input empties.
+    //
+    // Queues only support try_pop, so the cost of a message is charged
+    // after it is taken; an expensive message may leave the deficit
+    // negative, which is repaid on later visits.
+    template<std::size_t NumberOfInputs, class MessageCost = UnitCost>
+    class DeficitRoundRobin
+    {
+    public:
+        DeficitRoundRobin(MessageCost cost = MessageCost());
+
+        // @input the index of the input
+        // @weight the quantum added to @input's deficit per visit, at least 1.
+        void setWeight(const std::size_t input, const std::size_t weight);
+
+        // take a message from the current input if its deficit allows,
+        // otherwise move on to the next input.
+        //
+        // @return true if a message was taken, false if all inputs are empty.
+        template<class Queues, class MessagePtr>
+        bool try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message);
+
+    private:
+        std::array<std::int64_t, NumberOfInputs> quantum_;
+        std::array<std::int64_t, NumberOfInputs> deficit_;
+        std::size_t which_;
+
+        MessageCost cost_;
+    };
+
+
+    template<std::size_t NumberOfInputs, class MessageCost>
+    DeficitRoundRobin<NumberOfInputs, MessageCost>::DeficitRoundRobin(MessageCost cost)
+        : which_(0)
+        , cost_(cost)
+    {
+        quantum_.fill(1);
+        deficit_.fill(0);
+        deficit_[0] = quantum_[0];
+    }
+
+    template<std::size_t NumberOfInputs, class MessageCost>
+    inline
+    void DeficitRoundRobin<NumberOfInputs, MessageCost>::setWeight(const std::size_t input, const std::size_t weight)
+    {
+        quantum_[input] = (weight > 0) ? static_cast<std::int64_t>(weight) : 1;
+
+        if(input == which_)
+        {
+            deficit_[input] = quantum_[input];
+        }
+    }
+
+    template<std::size_t NumberOfInputs, class MessageCost>
+    template<class Queues, class MessagePtr>
+    bool DeficitRoundRobin<NumberOfInputs, MessageCost>::try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message)
+    {
+        if(numberOfQueues == 0)
+        {
+            return false;
+        }
+
+        // an input in debt may need several visits before it is polled
+        // again, so bound the search by queues polled rather than visits.
+        std::size_t queuesPolled = 0;
+
+        while(queuesPolled <= numberOfQueues)
+        {
+            if(deficit_[which_] > 0)
+            {
+                ++queuesPolled;
+                if(queues[which_].try_pop(message))
+                {
+                    deficit_[which_] -= cost_(message);
+                    return true;
+                }
+
+                // an empty input forfeits its remaining deficit.
+                deficit_[which_] = 0;
+            }
+
+            if(++which_ >= numberOfQueues)
+            {
+                which_ = 0;
+            }
+
+            deficit_[which_] += quantum_[which_];
+        }
+
+        return false;
+    }
+}}}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+
+namespace wield { namespace adapters { namespace input_selection {
+
+    // This input selection policy always takes the next message
+    // from the highest priority input which has one. Inputs are
+    // prioritized in the order they were added, the first input
+    // has the highest priority. Weights are ignored.
+    //
+    // Useful for letting control-plane inputs preempt bulk data
+    // inputs; lower priority inputs can starve.
+    template<std::size_t NumberOfInputs>
+    class StrictPriority
+    {
+    public:
+        inline void setWeight(const std::size_t /*input*/, const std::size_t /*weight*/) {}
+
+        // take a message from the first non-empty input.
+        // @queues the input queues
+        // @numberOfQueues the number of inputs in use
+        // @message set to the message taken
+        //
+        // @return true if a message was taken, false otherwise.
+        template<class Queues, class MessagePtr>
+        bool try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message);
+    };
+
+
+    template<std::size_t NumberOfInputs>
+    template<class Queues, class MessagePtr>
+    inline
+    bool StrictPriority<NumberOfInputs>::try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message)
+    {
+        for(std::size_t input = 0; input < numberOfQueues; ++input)
+        {
+            if(queues[input].try_pop(message))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}}}
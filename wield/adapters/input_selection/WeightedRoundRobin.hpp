@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace wield { namespace adapters { namespace input_selection {
+
+    // This input selection policy visits inputs in a round-robin
+    // fashion, draining up to <weight> messages from an input before
+    // moving on to the next. A weight of 1 for every input is the
+    // plain round robin of MultipleInputQueueAdapter.
+    template<std::size_t NumberOfInputs>
+    class WeightedRoundRobin
+    {
+    public:
+        WeightedRoundRobin();
+
+        // @input the index of the input
+        // @weight the number of messages to take from @input per visit, at least 1.
+        void setWeight(const std::size_t input, const std::size_t weight);
+
+        // take a message, staying on the current input until its
+        // weight is used up or it is empty.
+        //
+        // @return true if a message was taken, false if all inputs are empty.
+        template<class Queues, class MessagePtr>
+        bool try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message);
+
+    private:
+        std::array<std::size_t, NumberOfInputs> weights_;
+        std::size_t which_;
+        std::size_t remaining_;
+    };
+
+
+    template<std::size_t NumberOfInputs>
+    WeightedRoundRobin<NumberOfInputs>::WeightedRoundRobin()
+        : which_(0)
+        , remaining_(1)
+    {
+        weights_.fill(1);
+    }
+
+    template<std::size_t NumberOfInputs>
+    inline
+    void WeightedRoundRobin<NumberOfInputs>::setWeight(const std::size_t input, const std::size_t weight)
+    {
+        weights_[input] = (weight > 0) ? weight : 1;
+
+        if(input == which_)
+        {
+            remaining_ = weights_[input];
+        }
+    }
+
+    template<std::size_t NumberOfInputs>
+    template<class Queues, class MessagePtr>
+    bool WeightedRoundRobin<NumberOfInputs>::try_pop(Queues& queues, const std::size_t numberOfQueues, MessagePtr& message)
+    {
+        if(numberOfQueues == 0)
+        {
+            return false;
+        }
+
+        // poll the current input, then each input once more at most.
+        for(std::size_t queuesPolled = 0; queuesPolled <= numberOfQueues; ++queuesPolled)
+        {
+            if(remaining_ > 0 && queues[which_].try_pop(message))
+            {
+                --remaining_;
+                return true;
+            }
+
+            if(++which_ >= numberOfQueues)
+            {
+                which_ = 0;
+            }
+
+            remaining_ = weights_[which_];
+        }
+
+        return false;
+    }
+}}}
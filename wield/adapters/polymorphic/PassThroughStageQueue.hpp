@@ -13,10 +13,9 @@ namespace wield { namespace adapters { namespace polymorphic {
     // This is convenient while experimenting with work breakout
     // during development and performance testing.
     //
-    // I hope to eventually provide tools for doing pass-through
-    // stage combination at compile time (without requiring client
-    // code to introduce virtual function calls for queue functionality)
-    // but that is a long way off I think.
+    // For pass-through stage combination at compile time (without
+    // requiring client code to introduce virtual function calls for
+    // queue functionality) see wield::adapters::FusedQueue.
     template<class ProcessingFunctor, class MessagePtr>
     class PassThroughStageQueue : public QueueInterface<MessagePtr>
     {
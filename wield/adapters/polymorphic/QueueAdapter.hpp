@@ -20,6 +20,9 @@ namespace wield { namespace adapters { namespace polymorphic {
         
         std::size_t unsafe_size(void) const override;
 
+        // the adapted queue, for queues with more to them than push and pop.
+        QueueType& queue(void) { return queue_; }
+
     private:
         QueueAdapter(const QueueAdapter&) = delete;
         QueueAdapter& operator=(const QueueAdapter&) = delete;
@@ -0,0 +1,172 @@
+#pragma once
+#include <wield/DispatcherInterface.hpp>
+#include <wield/Exceptions.hpp>
+#include <wield/adapters/input_selection/WeightedRoundRobin.hpp>
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wield { namespace adapters { namespace polymorphic {
+
+    // A variation of MultipleInputQueueAdapter for when inputs are not
+    // equal. Messages are taken from the inputs according to an
+    // <InputSelectionPolicy> (see wield/adapters/input_selection):
+    // StrictPriority, WeightedRoundRobin or DeficitRoundRobin.
+    //
+    // The input queues are kept in a contiguous array of concrete
+    // QueueAdapters, so polling them from try_pop involves no virtual
+    // calls; only the dispatching side goes through QueueInterface.
+    // Weighted policies drain several messages from one input before
+    // moving on to the next.
+    //
+    // As with MultipleInputQueueAdapter, this class creates dummy stages
+    // for the inputs and registers them with the dispatcher. Schedule
+    // the stage this adapter is passed to.
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy = input_selection::WeightedRoundRobin<NumberOfInputs>>
+    class WeightedMultipleInputQueueAdapter : public Traits::Queue
+    {
+    public:
+        using Message = typename Traits::Message;
+        using MessagePtr = typename Message::ptr;
+        using AdaptedQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, ConcreteQueue>;
+        using ProcessingFunctor = typename Traits::ProcessingFunctor;
+        using Stage = typename Traits::Stage;
+        using StageEnumType = typename Traits::StageEnumType;
+
+        template<typename... Args>
+        WeightedMultipleInputQueueAdapter(DispatcherInterface<StageEnumType, Stage>& dispatcher, ProcessingFunctor& dummyFunctor, Args&&... policyArgs);
+
+        // add an input for @stageName with @weight, the meaning of which
+        // depends on the InputSelectionPolicy. For StrictPriority inputs
+        // are prioritized in the order they are added. @args are passed
+        // to the ConcreteQueue's constructor.
+        template<typename... Args>
+        WeightedMultipleInputQueueAdapter& addQueue(const StageEnumType stageName, const std::size_t weight = 1, Args&&... args);
+
+        // this should never be called.
+        void push(const MessagePtr& ) override;
+
+        // Get a message, selecting the input with the InputSelectionPolicy.
+        bool try_pop(MessagePtr& message) override;
+
+        // Get the unsafe size of all contained queues.
+        std::size_t unsafe_size(void) const override;
+
+    private:
+        // final, so polling through a reference to an input is
+        // resolved at compile-time.
+        class Input final : public AdaptedQueue
+        {
+        public:
+            using AdaptedQueue::AdaptedQueue;
+        };
+
+        // the inputs, contiguous and constructed as they're added.
+        class Inputs
+        {
+        public:
+            Inputs() : size_(0) {}
+            ~Inputs();
+
+            template<typename... Args>
+            Input& emplace_back(Args&&... args);
+
+            Input& operator[](const std::size_t i) { return *reinterpret_cast<Input*>(&storage_[i]); }
+            const Input& operator[](const std::size_t i) const { return *reinterpret_cast<const Input*>(&storage_[i]); }
+
+            std::size_t size(void) const { return size_; }
+
+        private:
+            Inputs(const Inputs&) = delete;
+            Inputs& operator=(const Inputs&) = delete;
+
+        private:
+            typename std::aligned_storage<sizeof(Input), alignof(Input)>::type storage_[NumberOfInputs];
+            std::size_t size_;
+        };
+
+    private:
+        Inputs queues_;
+        InputSelectionPolicy inputSelection_;
+
+        std::deque<Stage> stages_;
+        DispatcherInterface<StageEnumType, Stage>& dispatcher_;
+        ProcessingFunctor& dummyFunctor_;
+    };
+
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    template<typename... Args>
+    WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::WeightedMultipleInputQueueAdapter(DispatcherInterface<StageEnumType, Stage>& dispatcher, ProcessingFunctor& dummyFunctor, Args&&... policyArgs)
+        : inputSelection_(std::forward<Args>(policyArgs)...)
+        , dispatcher_(dispatcher)
+        , dummyFunctor_(dummyFunctor)
+    {
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    template<typename... Args>
+    WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>& WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::addQueue(const StageEnumType stageName, const std::size_t weight, Args&&... args)
+    {
+        if(queues_.size() >= NumberOfInputs)
+        {
+            throw TooManyInputQueuesAdded();
+        }
+
+        Input& input = queues_.emplace_back(std::forward<Args>(args)...);
+        stages_.emplace_back(stageName, dispatcher_, input, dummyFunctor_);
+        inputSelection_.setWeight(queues_.size() - 1, weight);
+
+        return *this;
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    void WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::push(const MessagePtr& )
+    {
+        throw IllegallyPushedMessageOntoQueueAdapter();
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    inline
+    bool WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::try_pop(MessagePtr& message)
+    {
+        return inputSelection_.try_pop(queues_, queues_.size(), message);
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    std::size_t WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::unsafe_size(void) const
+    {
+        std::size_t total = 0;
+        for(std::size_t i = 0; i < queues_.size(); ++i)
+        {
+            total += queues_[i].unsafe_size();
+        }
+
+        return total;
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::Inputs::~Inputs()
+    {
+        for(; size_ != 0; --size_)
+        {
+            (*this)[size_ - 1].~Input();
+        }
+    }
+
+    template<class Traits, class ConcreteQueue, std::size_t NumberOfInputs, class InputSelectionPolicy>
+    template<typename... Args>
+    typename WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::Input&
+    WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, NumberOfInputs, InputSelectionPolicy>::Inputs::emplace_back(Args&&... args)
+    {
+        Input* input = new(&storage_[size_]) Input(std::forward<Args>(args)...);
+        ++size_;
+
+        return *input;
+    }
+
+}}}
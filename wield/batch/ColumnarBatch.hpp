@@ -0,0 +1,274 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+#include <type_traits>
+
+namespace wield { namespace batch {
+
+    // columns are aligned to a cache line, which is also the widest vector
+    // register (AVX-512) a kernel loads from them.
+    static const std::size_t ColumnAlignment = 64;
+
+    // <ColumnView> is one column of a ColumnarBatch: @size values of @T,
+    // contiguous and ColumnAlignment aligned.
+    template<class T>
+    class ColumnView
+    {
+    public:
+        ColumnView(T* data, const std::size_t size)
+            : data_(data)
+            , size_(size)
+        {
+        }
+
+        // tells the compiler the column is aligned, so loops over it
+        // vectorize without peeling.
+        T* data(void) const
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<T*>(__builtin_assume_aligned(data_, ColumnAlignment));
+#else
+            return data_;
+#endif
+        }
+
+        std::size_t size(void) const { return size_; }
+
+        T& operator[](const std::size_t i) const { return data_[i]; }
+
+        T* begin(void) const { return data_; }
+        T* end(void) const { return data_ + size_; }
+
+    private:
+        T* data_;
+        std::size_t size_;
+    };
+
+    // <ColumnarBatch> is a message carrying up to @Capacity records of
+    // numeric @Columns, stored as a structure of arrays: each column is a
+    // fixed, aligned array in the message itself. A stage processes the
+    // whole batch in one processWith, with kernels that stream through a
+    // column rather than chase a pointer per record.
+    //
+    //      enum TickColumns { Symbol, Price, Size };
+    //
+    //      class Ticks : public ColumnarBatch<Message, 1024, std::uint32_t, double, std::uint32_t>
+    //      {
+    //      public:
+    //          void processWith(ProcessingFunctor& process) override { process(*this); }
+    //      };
+    //
+    //      void operator()(Ticks& ticks)
+    //      {
+    //          transform(ticks.column<Price>(), ticks.column<Price>(), [this](double price){ return price * scale_; });
+    //          dispatcher_.dispatch(Stages::Analytics, ticks);
+    //      }
+    //
+    // Fill batches with a ColumnarBatchBuilder, which dispatches each one
+    // as it fills up.
+    //
+    // NOTE: a batch is one allocation of Capacity * sizeof(record) bytes,
+    // size it for the stages' working set: a few thousand records.
+    template<class Base, std::size_t Capacity, class... Columns>
+    class ColumnarBatch : public Base
+    {
+    public:
+        static_assert(Capacity > 0, "a ColumnarBatch must hold at least one record.");
+        static_assert(sizeof...(Columns) > 0, "a ColumnarBatch must have at least one column.");
+
+        template<std::size_t I>
+        using ColumnType = typename std::tuple_element<I, std::tuple<Columns...>>::type;
+
+        ColumnarBatch() : size_(0) {}
+
+        static constexpr std::size_t capacity(void) { return Capacity; }
+
+        std::size_t size(void) const { return size_; }
+        bool empty(void) const { return size_ == 0; }
+        bool full(void) const { return size_ == Capacity; }
+
+        // add a record, a value for each column.
+        // @return false if the batch is full.
+        bool append(const Columns&... values);
+
+        // set the number of records, for kernels filling the columns directly.
+        // @newSize is capped at the capacity.
+        void resize(const std::size_t newSize) { size_ = newSize < Capacity ? newSize : Capacity; }
+
+        void clear(void) { size_ = 0; }
+
+        template<std::size_t I>
+        ColumnView<ColumnType<I>> column(void) { return ColumnView<ColumnType<I>>(std::get<I>(columns_).values, size_); }
+
+        template<std::size_t I>
+        ColumnView<const ColumnType<I>> column(void) const { return ColumnView<const ColumnType<I>>(std::get<I>(columns_).values, size_); }
+
+        // operator new is only guaranteed max_align_t alignment before C++17.
+        static void* operator new(const std::size_t bytes);
+        static void operator delete(void* memory);
+
+    private:
+        template<class T>
+        struct Column
+        {
+            static_assert(std::is_arithmetic<T>::value, "ColumnarBatch columns hold numbers.");
+            alignas(ColumnAlignment) T values[Capacity];
+        };
+
+        template<std::size_t I>
+        void store(void) {}
+
+        template<std::size_t I, class T, class... Rest>
+        void store(const T& value, const Rest&... rest)
+        {
+            std::get<I>(columns_).values[size_] = value;
+            store<I + 1>(rest...);
+        }
+
+    private:
+        std::tuple<Column<Columns>...> columns_;
+        std::size_t size_;
+    };
+
+    // out[i] = f(in[i]) for each record, @out may be @in.
+    template<class T, class U, class Function>
+    void transform(const ColumnView<T>& out, const ColumnView<U>& in, Function f)
+    {
+        T* o = out.data();
+        U* i = in.data();
+        const std::size_t size = in.size();
+
+        for(std::size_t n = 0; n < size; ++n)
+        {
+            o[n] = f(i[n]);
+        }
+    }
+
+    // fold the column into @initial with @f(accumulated, value).
+    template<class T, class Accumulator, class Function>
+    Accumulator accumulate(const ColumnView<T>& in, Accumulator initial, Function f)
+    {
+        const T* i = in.data();
+        const std::size_t size = in.size();
+
+        for(std::size_t n = 0; n < size; ++n)
+        {
+            initial = f(initial, i[n]);
+        }
+
+        return initial;
+    }
+
+    // <ColumnarBatchBuilder> appends records to a @Batch, dispatching it
+    // to @stage once it's full and starting another. Call flush() to send
+    // a partly filled batch, say at the end of each input burst: one not
+    // flushed is freed with the builder.
+    template<class Batch, class Dispatcher>
+    class ColumnarBatchBuilder
+    {
+    public:
+        using StageEnumType = typename Dispatcher::StageEnumType;
+
+        ColumnarBatchBuilder(Dispatcher& dispatcher, const StageEnumType stage);
+
+        template<class... Values>
+        void append(const Values&... values);
+
+        // dispatch the batch being filled, if it has any records.
+        void flush(void);
+
+        // records in the batch being filled.
+        std::size_t pending(void) const { return batch_ != nullptr ? batch_->size() : 0; }
+
+    private:
+        ColumnarBatchBuilder(const ColumnarBatchBuilder&) = delete;
+        ColumnarBatchBuilder& operator=(const ColumnarBatchBuilder&) = delete;
+
+    private:
+        Dispatcher& dispatcher_;
+        const StageEnumType stage_;
+
+        typename Batch::smartptr owner_;
+        Batch* batch_;
+    };
+
+
+    template<class Base, std::size_t Capacity, class... Columns>
+    inline
+    bool ColumnarBatch<Base, Capacity, Columns...>::append(const Columns&... values)
+    {
+        if(size_ == Capacity)
+        {
+            return false;
+        }
+
+        store<0>(values...);
+        ++size_;
+
+        return true;
+    }
+
+    template<class Base, std::size_t Capacity, class... Columns>
+    void* ColumnarBatch<Base, Capacity, Columns...>::operator new(const std::size_t bytes)
+    {
+        // room to align, and to keep what ::operator new returned just below.
+        char* memory = static_cast<char*>(::operator new(bytes + ColumnAlignment + sizeof(void*)));
+
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(memory) + sizeof(void*);
+        char* aligned = reinterpret_cast<char*>((start + ColumnAlignment - 1) & ~(ColumnAlignment - 1));
+
+        reinterpret_cast<void**>(aligned)[-1] = memory;
+        return aligned;
+    }
+
+    template<class Base, std::size_t Capacity, class... Columns>
+    void ColumnarBatch<Base, Capacity, Columns...>::operator delete(void* memory)
+    {
+        if(memory != nullptr)
+        {
+            ::operator delete(static_cast<void**>(memory)[-1]);
+        }
+    }
+
+    template<class Batch, class Dispatcher>
+    ColumnarBatchBuilder<Batch, Dispatcher>::ColumnarBatchBuilder(Dispatcher& dispatcher, const StageEnumType stage)
+        : dispatcher_(dispatcher)
+        , stage_(stage)
+        , batch_(nullptr)
+    {
+    }
+
+    template<class Batch, class Dispatcher>
+    template<class... Values>
+    void ColumnarBatchBuilder<Batch, Dispatcher>::append(const Values&... values)
+    {
+        if(batch_ == nullptr)
+        {
+            batch_ = new Batch();
+            owner_ = typename Batch::smartptr(batch_);
+        }
+
+        batch_->append(values...);
+
+        if(batch_->full())
+        {
+            flush();
+        }
+    }
+
+    template<class Batch, class Dispatcher>
+    void ColumnarBatchBuilder<Batch, Dispatcher>::flush(void)
+    {
+        if(batch_ == nullptr || batch_->empty())
+        {
+            return;
+        }
+
+        dispatcher_.dispatch(stage_, *batch_);
+
+        owner_ = typename Batch::smartptr();
+        batch_ = nullptr;
+    }
+}}
@@ -0,0 +1,60 @@
+#pragma once
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace wield { namespace details {
+
+    // detects whether @Queue provides the optional bulk enqueue
+    //      void push_bulk(Iterator first, Iterator last);
+    template<class Queue, class Iterator>
+    class HasBulkPush
+    {
+        template<class Q>
+        static auto test(int) -> decltype(std::declval<Q&>().push_bulk(std::declval<Iterator>(), std::declval<Iterator>()), std::true_type());
+
+        template<class>
+        static std::false_type test(...);
+
+    public:
+        static const bool value = decltype(test<Queue>(0))::value;
+    };
+
+    // primary template, the queue has no bulk enqueue (or the iterator does
+    // not refer to MessagePtrs): push each message individually.
+    template<class Queue, class MessagePtr, class Iterator, bool use_bulk_push>
+    struct BulkPushImpl
+    {
+        static inline
+        void push(Queue& queue, Iterator first, Iterator last)
+        {
+            for(; first != last; ++first)
+            {
+                queue.push(MessagePtr(&**first));
+            }
+        }
+    };
+
+    // partial specialization forwards the contiguous run to the queue's
+    // bulk enqueue.
+    template<class Queue, class MessagePtr, class Iterator>
+    struct BulkPushImpl<Queue, MessagePtr, Iterator, true>
+    {
+        static inline
+        void push(Queue& queue, Iterator first, Iterator last)
+        {
+            queue.push_bulk(first, last);
+        }
+    };
+
+    // Helper function that pushes the messages referred to by [@first, @last)
+    // onto @queue, using the queue's bulk enqueue when it is available.
+    template<class MessagePtr, class Queue, class Iterator>
+    inline void bulk_push(Queue& queue, Iterator first, Iterator last)
+    {
+        using IsMessagePtrIterator = std::is_same<typename std::iterator_traits<Iterator>::value_type, MessagePtr>;
+
+        BulkPushImpl<Queue, MessagePtr, Iterator, IsMessagePtrIterator::value && HasBulkPush<Queue, Iterator>::value>::push(queue, first, last);
+    }
+
+}}
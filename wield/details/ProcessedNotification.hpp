@@ -0,0 +1,59 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+
+namespace wield { namespace details {
+
+    // detects whether @Queue provides the optional completion notification
+    //      void processed(const MessagePtr& message);
+    // called once a message popped from the queue has been processed.
+    template<class Queue, class MessagePtr>
+    class HasProcessedNotification
+    {
+        template<class Q>
+        static auto test(int) -> decltype(std::declval<Q&>().processed(std::declval<const MessagePtr&>()), std::true_type());
+
+        template<class>
+        static std::false_type test(...);
+
+    public:
+        static const bool value = decltype(test<Queue>(0))::value;
+    };
+
+    // primary template, the queue doesn't want to know: does nothing.
+    template<class Queue, class MessagePtr, bool notify = HasProcessedNotification<Queue, MessagePtr>::value>
+    class ProcessedNotification
+    {
+    public:
+        ProcessedNotification(Queue&, const MessagePtr&) {}
+    };
+
+    // partial specialization calls queue.processed(message) when it goes out
+    // of scope, after the message has been processed or processing threw.
+    //
+    // NOTE: construct it after the smart pointer holding the message, so the
+    // message is still alive when the queue is notified.
+    template<class Queue, class MessagePtr>
+    class ProcessedNotification<Queue, MessagePtr, true>
+    {
+    public:
+        ProcessedNotification(Queue& queue, const MessagePtr& message)
+            : queue_(queue)
+            , message_(message)
+        {
+        }
+
+        ~ProcessedNotification()
+        {
+            queue_.processed(message_);
+        }
+
+    private:
+        ProcessedNotification(const ProcessedNotification&) = delete;
+        ProcessedNotification& operator=(const ProcessedNotification&) = delete;
+
+    private:
+        Queue& queue_;
+        const MessagePtr& message_;
+    };
+}}
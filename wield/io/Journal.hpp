@@ -0,0 +1,395 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wield { namespace io {
+
+    // A journal is a log of serialized messages on disk, split into
+    // segment files of a fixed size in one directory:
+    //      journal-00000000.wj, journal-00000001.wj, ...
+    //
+    // Segments are preallocated and memory-mapped, so appending a record
+    // is a copy into the mapping: the only system calls are those opening
+    // the next segment. Each record carries the stage it is for and when
+    // it was recorded. A record's header is published last, so a reader
+    // in another process can follow a journal while it's being written.
+    struct JournalFormat
+    {
+        static const std::uint64_t Magic = 0x776c646a726e6c31;  // "wldjrnl1"
+
+        struct SegmentHeader
+        {
+            std::uint64_t magic;
+            std::uint64_t journalId;
+            std::uint64_t index;
+            std::uint64_t reserved;
+        };
+
+        enum Kind : std::uint32_t
+        {
+            Unwritten = 0,
+            Record = 1,
+            EndOfSegment = 2
+        };
+
+        // followed by the payload, padded to keep the next header aligned.
+        struct RecordHeader
+        {
+            std::atomic<std::uint32_t> kind;
+            std::uint32_t length;
+            std::uint32_t stage;
+            std::uint32_t reserved;
+            std::int64_t timestamp;
+        };
+
+        static const std::size_t Alignment = 8;
+
+        static std::size_t sizeOf(const std::size_t length)
+        {
+            return sizeof(RecordHeader) + (length + Alignment - 1) / Alignment * Alignment;
+        }
+
+        static std::string segmentPath(const std::string& directory, const std::uint64_t index)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/journal-%08llu.wj", static_cast<unsigned long long>(index));
+            return directory + name;
+        }
+    };
+
+    // <JournalWriter> appends records to a new journal in @directory,
+    // replacing any journal already there. Appending isn't thread safe,
+    // JournalQueue serializes the stage's callers.
+    class JournalWriter
+    {
+    public:
+        // @segmentSize bytes of each segment file.
+        // @maxMessageSize the most bytes a record's payload may take.
+        JournalWriter(const std::string& directory, const std::size_t segmentSize = 64 * 1024 * 1024, const std::size_t maxMessageSize = 4096);
+
+        ~JournalWriter();
+
+        // let @write fill a record's payload in place:
+        //      std::size_t write(char* payload, std::size_t capacity);
+        // returning the number of bytes written. A throwing @write leaves
+        // nothing in the journal.
+        template<class Writer>
+        void append(const std::uint32_t stage, const std::int64_t timestamp, Writer&& write);
+
+        // write the current segment to disk, appending doesn't wait for it.
+        void flush(void);
+
+        // number of segments written so far.
+        std::size_t segments(void) const { return static_cast<std::size_t>(index_ + 1); }
+
+    private:
+        JournalWriter(const JournalWriter&) = delete;
+        JournalWriter& operator=(const JournalWriter&) = delete;
+
+        void openSegment(const std::uint64_t index);
+        void closeSegment(void);
+
+    private:
+        const std::string directory_;
+        const std::size_t segmentSize_;
+        const std::size_t maxMessageSize_;
+        const std::uint64_t journalId_;
+
+        std::uint64_t index_;
+        char* memory_;
+        std::size_t position_;
+    };
+
+    // <JournalReader> reads the records of the journal in @directory in
+    // the order they were appended, in place in the mapped segments.
+    class JournalReader
+    {
+    public:
+        struct Record
+        {
+            std::uint32_t stage = 0;
+            std::int64_t timestamp = 0;
+
+            // valid until the next call to next().
+            const char* data = nullptr;
+            std::size_t length = 0;
+        };
+
+        // @throw std::system_error if there's no journal, InvalidJournal if
+        // the first segment isn't one.
+        explicit JournalReader(const std::string& directory);
+
+        ~JournalReader();
+
+        // read the next record into @record.
+        // @return false at the end of what has been written so far, the
+        // journal may still be growing and a later call can continue.
+        bool next(Record& record);
+
+    private:
+        JournalReader(const JournalReader&) = delete;
+        JournalReader& operator=(const JournalReader&) = delete;
+
+        // @return false if the segment isn't there, or belongs to another journal.
+        bool openSegment(const std::uint64_t index);
+
+    private:
+        const std::string directory_;
+        std::uint64_t journalId_;
+
+        std::uint64_t index_;
+        const char* memory_;
+        std::size_t size_;
+        std::size_t position_;
+    };
+
+
+    inline
+    JournalWriter::JournalWriter(const std::string& directory, const std::size_t segmentSize, const std::size_t maxMessageSize)
+        : directory_(directory)
+        , segmentSize_(segmentSize)
+        , maxMessageSize_(maxMessageSize)
+        , journalId_(static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()) ^ static_cast<std::uint64_t>(::getpid()))
+        , index_(0)
+        , memory_(nullptr)
+        , position_(0)
+    {
+        // room for the header, the largest record and the end of segment marker.
+        if(maxMessageSize == 0
+            || maxMessageSize > UINT32_MAX
+            || segmentSize < sizeof(JournalFormat::SegmentHeader) + JournalFormat::sizeOf(maxMessageSize) + sizeof(JournalFormat::RecordHeader))
+        {
+            throw std::invalid_argument("JournalWriter segments must fit at least one message of the maximum size.");
+        }
+
+        openSegment(0);
+    }
+
+    inline
+    JournalWriter::~JournalWriter()
+    {
+        closeSegment();
+    }
+
+    template<class Writer>
+    void JournalWriter::append(const std::uint32_t stage, const std::int64_t timestamp, Writer&& write)
+    {
+        if(position_ + JournalFormat::sizeOf(maxMessageSize_) + sizeof(JournalFormat::RecordHeader) > segmentSize_)
+        {
+            JournalFormat::RecordHeader* end = new (memory_ + position_) JournalFormat::RecordHeader();
+            end->kind.store(JournalFormat::EndOfSegment, std::memory_order_release);
+
+            closeSegment();
+            openSegment(index_ + 1);
+        }
+
+        JournalFormat::RecordHeader* header = new (memory_ + position_) JournalFormat::RecordHeader();
+        const std::size_t length = write(memory_ + position_ + sizeof(JournalFormat::RecordHeader), maxMessageSize_);
+
+        header->length = static_cast<std::uint32_t>(length);
+        header->stage = stage;
+        header->reserved = 0;
+        header->timestamp = timestamp;
+        header->kind.store(JournalFormat::Record, std::memory_order_release);
+
+        position_ += JournalFormat::sizeOf(length);
+    }
+
+    inline
+    void JournalWriter::flush(void)
+    {
+        if(::msync(memory_, segmentSize_, MS_SYNC) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "JournalWriter: msync");
+        }
+    }
+
+    inline
+    void JournalWriter::openSegment(const std::uint64_t index)
+    {
+        const std::string path = JournalFormat::segmentPath(directory_, index);
+
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "JournalWriter: open " + path);
+        }
+
+        // reserve the blocks up front, where the file system can.
+        int result = ::posix_fallocate(fd, 0, static_cast<off_t>(segmentSize_));
+        if(result == EOPNOTSUPP || result == EINVAL)
+        {
+            result = ::ftruncate(fd, static_cast<off_t>(segmentSize_)) == -1 ? errno : 0;
+        }
+
+        void* memory = result == 0
+            ? ::mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0)
+            : MAP_FAILED;
+
+        if(memory == MAP_FAILED)
+        {
+            const int error = result != 0 ? result : errno;
+            ::close(fd);
+            throw std::system_error(error, std::system_category(), "JournalWriter: preallocating " + path);
+        }
+
+        // the mapping keeps the file open.
+        ::close(fd);
+
+        memory_ = static_cast<char*>(memory);
+        index_ = index;
+
+        JournalFormat::SegmentHeader* header = reinterpret_cast<JournalFormat::SegmentHeader*>(memory_);
+        header->journalId = journalId_;
+        header->index = index;
+        header->reserved = 0;
+        header->magic = JournalFormat::Magic;
+
+        position_ = sizeof(JournalFormat::SegmentHeader);
+    }
+
+    inline
+    void JournalWriter::closeSegment(void)
+    {
+        if(memory_ != nullptr)
+        {
+            ::munmap(memory_, segmentSize_);
+            memory_ = nullptr;
+        }
+    }
+
+    inline
+    JournalReader::JournalReader(const std::string& directory)
+        : directory_(directory)
+        , journalId_(0)
+        , index_(0)
+        , memory_(nullptr)
+        , size_(0)
+        , position_(0)
+    {
+        const std::string path = JournalFormat::segmentPath(directory_, 0);
+
+        struct stat status;
+        if(::stat(path.c_str(), &status) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "JournalReader: " + path);
+        }
+
+        if(!openSegment(0))
+        {
+            throw InvalidJournal();
+        }
+    }
+
+    inline
+    JournalReader::~JournalReader()
+    {
+        if(memory_ != nullptr)
+        {
+            ::munmap(const_cast<char*>(memory_), size_);
+        }
+    }
+
+    inline
+    bool JournalReader::next(Record& record)
+    {
+        for(;;)
+        {
+            if(position_ + sizeof(JournalFormat::RecordHeader) > size_)
+            {
+                throw InvalidJournal();
+            }
+
+            const JournalFormat::RecordHeader* header = reinterpret_cast<const JournalFormat::RecordHeader*>(memory_ + position_);
+            const std::uint32_t kind = header->kind.load(std::memory_order_acquire);
+
+            if(kind == JournalFormat::Record)
+            {
+                const std::size_t length = header->length;
+                if(position_ + JournalFormat::sizeOf(length) > size_)
+                {
+                    throw InvalidJournal();
+                }
+
+                record.stage = header->stage;
+                record.timestamp = header->timestamp;
+                record.data = memory_ + position_ + sizeof(JournalFormat::RecordHeader);
+                record.length = length;
+
+                position_ += JournalFormat::sizeOf(length);
+                return true;
+            }
+
+            // stay at the marker until the writer has opened the next segment.
+            if(kind != JournalFormat::EndOfSegment || !openSegment(index_ + 1))
+            {
+                return false;
+            }
+        }
+    }
+
+    inline
+    bool JournalReader::openSegment(const std::uint64_t index)
+    {
+        const std::string path = JournalFormat::segmentPath(directory_, index);
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd == -1)
+        {
+            return false;
+        }
+
+        struct stat status;
+        void* memory = MAP_FAILED;
+        if(::fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(JournalFormat::SegmentHeader))
+        {
+            memory = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+
+        ::close(fd);
+
+        if(memory == MAP_FAILED)
+        {
+            return false;
+        }
+
+        const std::size_t size = static_cast<std::size_t>(status.st_size);
+        const JournalFormat::SegmentHeader* header = static_cast<const JournalFormat::SegmentHeader*>(memory);
+
+        if(header->magic != JournalFormat::Magic || header->index != index || (index != 0 && header->journalId != journalId_))
+        {
+            ::munmap(memory, size);
+            return false;
+        }
+
+        ::madvise(memory, size, MADV_SEQUENTIAL);
+
+        if(memory_ != nullptr)
+        {
+            ::munmap(const_cast<char*>(memory_), size_);
+        }
+
+        journalId_ = header->journalId;
+        index_ = index;
+        memory_ = static_cast<const char*>(memory);
+        size_ = size;
+        position_ = sizeof(JournalFormat::SegmentHeader);
+
+        return true;
+    }
+}}
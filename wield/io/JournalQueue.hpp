@@ -0,0 +1,259 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/MessageBase.hpp>
+#include <wield/details/SmartPtrCreator.hpp>
+#include <wield/io/Journal.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace wield { namespace io {
+
+    // Queues for recording traffic into a journal and replaying it.
+    // JournalQueue is the queue of a journal stage: messages dispatched
+    // to it are serialized into the journal, with the time they arrived,
+    // for @replayStage. JournalReplay is the queue of an ingress stage
+    // which reads a journal back and dispatches each message to the stage
+    // it was recorded for, at the recorded pace or a multiple of it.
+    //
+    // @Codec is the serialization hook the other io queues use
+    // (serialization::RegistryCodec fits):
+    //     struct Codec
+    //     {
+    //         std::size_t serialize(const Message& message, char* buffer, std::size_t capacity) const;
+    //         Message::ptr deserialize(const char* data, std::size_t length) const;
+    //     };
+
+    template<class StageEnum, class Message, class Codec>
+    class JournalQueue
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        JournalQueue(JournalWriter& journal, const StageEnum replayStage, const Codec& codec = Codec());
+
+        // record @message, the queue's reference is released.
+        void push(const MessagePtr& message);
+
+        // the messages are processed when they're replayed.
+        // @return false, there is never a message to process here.
+        bool try_pop(MessagePtr&) { return false; }
+
+        std::size_t unsafe_size(void) const { return 0; }
+
+        // number of messages recorded so far.
+        std::size_t recorded(void) const { return recorded_.load(std::memory_order_relaxed); }
+
+    private:
+        JournalQueue(const JournalQueue&) = delete;
+        JournalQueue& operator=(const JournalQueue&) = delete;
+
+    private:
+        JournalWriter& journal_;
+        const std::uint32_t replayStage_;
+        const Codec codec_;
+
+        std::mutex mutex_;
+        std::atomic<std::size_t> recorded_;
+    };
+
+    template<class StageEnum, class Message, class Codec>
+    class JournalReplay
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+        using Clock = std::chrono::steady_clock;
+
+        // @dispatcher anything with dispatch(StageEnum, Message&).
+        // @speed 1 replays at the recorded pace, 10 ten times as fast, and
+        // 0 as fast as the pipeline takes the messages.
+        template<class Dispatcher>
+        JournalReplay(
+            Dispatcher& dispatcher,
+            const std::string& directory,
+            const double speed = 1.0,
+            const std::size_t maxMessagesPerVisit = 64,
+            const Codec& codec = Codec());
+
+        // ingress stages are event sources, this should never be called.
+        void push(const MessagePtr&);
+
+        // replay what's due, another thread already doing so makes this a no-op.
+        // @return false, there is never a message to process.
+        bool try_pop(MessagePtr&);
+
+        // dispatch the messages due by @now, up to @maxMessagesPerVisit.
+        // The first message is due on the first call.
+        // @return the number of messages dispatched.
+        // @throw UnknownStageName for a record naming a stage StageEnum
+        // doesn't have, the record is skipped.
+        std::size_t replay(const Clock::time_point now);
+
+        std::size_t unsafe_size(void) const { return 0; }
+
+        // number of messages replayed so far.
+        std::size_t replayed(void) const { return replayed_.load(std::memory_order_relaxed); }
+
+    private:
+        JournalReplay(const JournalReplay&) = delete;
+        JournalReplay& operator=(const JournalReplay&) = delete;
+
+        template<class Dispatcher>
+        static void dispatchTo(void* dispatcher, const StageEnum stage, Message& message)
+        {
+            static_cast<Dispatcher*>(dispatcher)->dispatch(stage, message);
+        }
+
+    private:
+        void* dispatcher_;
+        void (*dispatch_)(void*, const StageEnum, Message&);
+
+        const double speed_;
+        const std::size_t maxMessagesPerVisit_;
+        const Codec codec_;
+
+        std::atomic<bool> replaying_;
+        std::atomic<std::size_t> replayed_;
+
+        // only touched by the thread which claimed replaying_.
+        JournalReader reader_;
+        JournalReader::Record record_;
+        bool haveRecord_;
+
+        bool started_;
+        Clock::time_point start_;
+        std::int64_t firstTimestamp_;
+    };
+
+
+    template<class StageEnum, class Message, class Codec>
+    JournalQueue<StageEnum, Message, Codec>::JournalQueue(JournalWriter& journal, const StageEnum replayStage, const Codec& codec)
+        : journal_(journal)
+        , replayStage_(static_cast<std::uint32_t>(replayStage))
+        , codec_(codec)
+        , recorded_(0)
+    {
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void JournalQueue<StageEnum, Message, Codec>::push(const MessagePtr& message)
+    {
+        // take over the reference the dispatcher added for the queue.
+        typename Message::smartptr owned(details::create_smartptr<Message>(message, no_increment));
+
+        const std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        const Codec& codec = codec_;
+        const auto serialize = [&codec, &message](char* buffer, std::size_t capacity){
+            return codec.serialize(*message, buffer, capacity);
+        };
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        journal_.append(replayStage_, now, serialize);
+
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    template<class Dispatcher>
+    JournalReplay<StageEnum, Message, Codec>::JournalReplay(
+        Dispatcher& dispatcher,
+        const std::string& directory,
+        const double speed,
+        const std::size_t maxMessagesPerVisit,
+        const Codec& codec)
+        : dispatcher_(&dispatcher)
+        , dispatch_(&JournalReplay::dispatchTo<Dispatcher>)
+        , speed_(speed)
+        , maxMessagesPerVisit_(maxMessagesPerVisit)
+        , codec_(codec)
+        , replaying_(false)
+        , replayed_(0)
+        , reader_(directory)
+        , record_()
+        , haveRecord_(false)
+        , started_(false)
+        , start_()
+        , firstTimestamp_(0)
+    {
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void JournalReplay<StageEnum, Message, Codec>::push(const MessagePtr&)
+    {
+        throw IllegallyPushedMessageOntoIngress();
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    bool JournalReplay<StageEnum, Message, Codec>::try_pop(MessagePtr&)
+    {
+        replay(Clock::now());
+        return false;
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    std::size_t JournalReplay<StageEnum, Message, Codec>::replay(const Clock::time_point now)
+    {
+        if(replaying_.load(std::memory_order_relaxed) || replaying_.exchange(true, std::memory_order_acquire))
+        {
+            return 0;
+        }
+
+        struct Release
+        {
+            ~Release() { replaying.store(false, std::memory_order_release); }
+            std::atomic<bool>& replaying;
+        } release{replaying_};
+
+        std::size_t count = 0;
+        while(count < maxMessagesPerVisit_)
+        {
+            // a record read earlier may still be waiting for its time.
+            if(!haveRecord_)
+            {
+                if(!reader_.next(record_))
+                {
+                    break;
+                }
+
+                haveRecord_ = true;
+            }
+
+            if(!started_)
+            {
+                started_ = true;
+                start_ = now;
+                firstTimestamp_ = record_.timestamp;
+            }
+
+            if(speed_ > 0)
+            {
+                const std::chrono::duration<double, std::nano> offset(static_cast<double>(record_.timestamp - firstTimestamp_) / speed_);
+                if(start_ + std::chrono::duration_cast<Clock::duration>(offset) > now)
+                {
+                    break;
+                }
+            }
+
+            haveRecord_ = false;
+            ++count;
+
+            if(record_.stage >= static_cast<std::uint32_t>(StageEnum::NumberOfEntries))
+            {
+                throw UnknownStageName();
+            }
+
+            typename Message::smartptr message(codec_.deserialize(record_.data, record_.length));
+            dispatch_(dispatcher_, static_cast<StageEnum>(record_.stage), *message);
+
+            replayed_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+}}
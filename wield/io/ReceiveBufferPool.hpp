@@ -0,0 +1,269 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+namespace wield { namespace io {
+
+    class ReceiveBufferPool;
+
+    // <ReceiveBuffer> owns one buffer of a ReceiveBufferPool and returns
+    // it to the pool when destroyed. Ingress stages receive into it and
+    // move it into the message they create, so the payload is never copied.
+    class ReceiveBuffer
+    {
+    public:
+        ReceiveBuffer();
+        ReceiveBuffer(ReceiveBuffer&& other);
+        ReceiveBuffer& operator=(ReceiveBuffer&& other);
+        ~ReceiveBuffer();
+
+        explicit operator bool() const { return pool_ != nullptr; }
+
+        char* data(void) const { return data_; }
+        std::size_t capacity(void) const { return capacity_; }
+
+        // number of bytes received into the buffer.
+        std::size_t size(void) const { return size_; }
+        void resize(const std::size_t size) { size_ = size; }
+
+        // where a datagram came from, empty for stream sockets.
+        const sockaddr_storage& source(void) const { return source_; }
+        socklen_t sourceLength(void) const { return sourceLength_; }
+
+        // the socket the data was read from.
+        int socket(void) const { return socket_; }
+
+    private:
+        friend class ReceiveBufferPool;
+        template<class StageEnum, class Message, class MessageFactory> friend class SocketIngress;
+
+        ReceiveBuffer(ReceiveBufferPool& pool, const std::size_t index, char* data, const std::size_t capacity);
+
+        ReceiveBuffer(const ReceiveBuffer&) = delete;
+        ReceiveBuffer& operator=(const ReceiveBuffer&) = delete;
+
+        void release(void);
+
+    private:
+        ReceiveBufferPool* pool_;
+        std::size_t index_;
+        char* data_;
+        std::size_t capacity_;
+        std::size_t size_;
+
+        sockaddr_storage source_;
+        socklen_t sourceLength_;
+        int socket_;
+    };
+
+    // <ReceiveBufferPool> is a fixed number of equally sized buffers
+    // allocated up front in one block. Buffers may be released on any
+    // thread, messages holding them are destroyed wherever they were
+    // last processed. The pool must outlive the buffers taken from it.
+    //
+    // The free buffers are a lock-free stack of indices, so releasing
+    // threads don't contend with the ingress stage for a lock.
+    class ReceiveBufferPool
+    {
+    public:
+        ReceiveBufferPool(const std::size_t bufferSize, const std::size_t numberOfBuffers);
+
+        // allocate the block with @allocator, e.g. a memory::HugePageAllocator.
+        template<class Allocator>
+        ReceiveBufferPool(const std::size_t bufferSize, const std::size_t numberOfBuffers, const Allocator& allocator);
+
+        // @return an empty ReceiveBuffer if the pool is exhausted.
+        ReceiveBuffer acquire(void);
+
+        std::size_t bufferSize(void) const { return bufferSize_; }
+
+        // number of buffers not in use.
+        std::size_t available(void) const;
+
+    private:
+        friend class ReceiveBuffer;
+
+        ReceiveBufferPool(const ReceiveBufferPool&) = delete;
+        ReceiveBufferPool& operator=(const ReceiveBufferPool&) = delete;
+
+        void release(const std::size_t index);
+
+        static const std::uint32_t Nil = std::numeric_limits<std::uint32_t>::max();
+
+        // the top of the stack and a count of its updates, changed
+        // together so a pop can't succeed on a top which was popped
+        // and pushed back in between (ABA).
+        static std::uint64_t head(const std::uint32_t index, const std::uint32_t tag) { return (static_cast<std::uint64_t>(tag) << 32) | index; }
+        static std::uint32_t indexOf(const std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+        static std::uint32_t tagOf(const std::uint64_t head) { return static_cast<std::uint32_t>(head >> 32); }
+
+    private:
+        const std::size_t bufferSize_;
+        std::unique_ptr<char, std::function<void(char*)>> memory_;
+
+        // the buffer below each free buffer on the stack.
+        std::unique_ptr<std::atomic<std::uint32_t>[]> next_;
+        std::atomic<std::uint64_t> free_;
+        std::atomic<std::size_t> available_;
+    };
+
+
+    inline
+    ReceiveBuffer::ReceiveBuffer()
+        : pool_(nullptr)
+        , index_(0)
+        , data_(nullptr)
+        , capacity_(0)
+        , size_(0)
+        , source_()
+        , sourceLength_(0)
+        , socket_(-1)
+    {
+    }
+
+    inline
+    ReceiveBuffer::ReceiveBuffer(ReceiveBufferPool& pool, const std::size_t index, char* data, const std::size_t capacity)
+        : pool_(&pool)
+        , index_(index)
+        , data_(data)
+        , capacity_(capacity)
+        , size_(0)
+        , source_()
+        , sourceLength_(0)
+        , socket_(-1)
+    {
+    }
+
+    inline
+    ReceiveBuffer::ReceiveBuffer(ReceiveBuffer&& other)
+        : pool_(other.pool_)
+        , index_(other.index_)
+        , data_(other.data_)
+        , capacity_(other.capacity_)
+        , size_(other.size_)
+        , source_(other.source_)
+        , sourceLength_(other.sourceLength_)
+        , socket_(other.socket_)
+    {
+        other.pool_ = nullptr;
+    }
+
+    inline
+    ReceiveBuffer& ReceiveBuffer::operator=(ReceiveBuffer&& other)
+    {
+        if(this != &other)
+        {
+            release();
+
+            pool_ = other.pool_;
+            index_ = other.index_;
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            source_ = other.source_;
+            sourceLength_ = other.sourceLength_;
+            socket_ = other.socket_;
+
+            other.pool_ = nullptr;
+        }
+
+        return *this;
+    }
+
+    inline
+    ReceiveBuffer::~ReceiveBuffer()
+    {
+        release();
+    }
+
+    inline
+    void ReceiveBuffer::release(void)
+    {
+        if(pool_ != nullptr)
+        {
+            pool_->release(index_);
+            pool_ = nullptr;
+        }
+    }
+
+    inline
+    ReceiveBufferPool::ReceiveBufferPool(const std::size_t bufferSize, const std::size_t numberOfBuffers)
+        : ReceiveBufferPool(bufferSize, numberOfBuffers, std::allocator<char>())
+    {
+    }
+
+    template<class Allocator>
+    ReceiveBufferPool::ReceiveBufferPool(const std::size_t bufferSize, const std::size_t numberOfBuffers, const Allocator& allocator)
+        : bufferSize_(bufferSize)
+        , next_(new std::atomic<std::uint32_t>[numberOfBuffers])
+        , free_(head(numberOfBuffers != 0 ? 0 : Nil, 0))
+        , available_(numberOfBuffers)
+    {
+        if(numberOfBuffers >= Nil)
+        {
+            throw std::invalid_argument("ReceiveBufferPool: too many buffers.");
+        }
+
+        using CharAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
+
+        CharAllocator bytes(allocator);
+        const std::size_t size = bufferSize * numberOfBuffers;
+
+        memory_ = std::unique_ptr<char, std::function<void(char*)>>(
+            std::allocator_traits<CharAllocator>::allocate(bytes, size),
+            [bytes, size](char* memory) mutable { std::allocator_traits<CharAllocator>::deallocate(bytes, memory, size); });
+
+        for(std::size_t i = 0; i < numberOfBuffers; ++i)
+        {
+            next_[i].store(i + 1 < numberOfBuffers ? static_cast<std::uint32_t>(i + 1) : Nil, std::memory_order_relaxed);
+        }
+    }
+
+    inline
+    ReceiveBuffer ReceiveBufferPool::acquire(void)
+    {
+        std::uint64_t top = free_.load(std::memory_order_acquire);
+        std::uint32_t index = indexOf(top);
+
+        // next_ of a buffer another thread just took may be stale, the
+        // tag makes the exchange fail then.
+        while(index != Nil && !free_.compare_exchange_weak(top, head(next_[index].load(std::memory_order_relaxed), tagOf(top) + 1), std::memory_order_acquire))
+        {
+            index = indexOf(top);
+        }
+
+        if(index == Nil)
+        {
+            return ReceiveBuffer();
+        }
+
+        available_.fetch_sub(1, std::memory_order_relaxed);
+        return ReceiveBuffer(*this, index, memory_.get() + index * bufferSize_, bufferSize_);
+    }
+
+    inline
+    std::size_t ReceiveBufferPool::available(void) const
+    {
+        return available_.load(std::memory_order_relaxed);
+    }
+
+    inline
+    void ReceiveBufferPool::release(const std::size_t index)
+    {
+        std::uint64_t top = free_.load(std::memory_order_relaxed);
+        do
+        {
+            next_[index].store(indexOf(top), std::memory_order_relaxed);
+        }
+        while(!free_.compare_exchange_weak(top, head(static_cast<std::uint32_t>(index), tagOf(top) + 1), std::memory_order_release));
+
+        available_.fetch_add(1, std::memory_order_relaxed);
+    }
+}}
@@ -0,0 +1,183 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/MessageBase.hpp>
+#include <wield/details/SmartPtrCreator.hpp>
+#include <wield/io/SharedMemoryRing.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace wield { namespace io {
+
+    // Queues for splitting a pipeline across processes over a
+    // SharedMemoryRing. SharedMemoryEgressQueue is the queue of the last
+    // stage in one process: messages dispatched to it are serialized into
+    // the ring. SharedMemoryIngressQueue is the queue of the first stage in
+    // the other process: visiting it deserializes a message from the ring
+    // and processes it like any other.
+    //
+    // Messages cross as bytes, never pointers. @Codec is the serialization
+    // hook, typically forwarding to virtuals on the application's message
+    // base class:
+    //     struct Codec
+    //     {
+    //         // @return the number of bytes written to @buffer.
+    //         std::size_t serialize(const Message& message, char* buffer, std::size_t capacity) const;
+    //
+    //         // @return a new message read from @data.
+    //         Message::ptr deserialize(const char* data, std::size_t length) const;
+    //     };
+    // serialize may throw when the message doesn't fit in a slot, the
+    // record is then skipped. serialization::RegistryCodec is a Codec for
+    // messages implementing MessageBase's serialization hooks.
+
+    template<class Message, class Codec>
+    class SharedMemoryEgressQueue
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        // @fullTimeout how long push waits for room in a full ring,
+        // std::chrono::nanoseconds::max() waits for as long as it takes.
+        SharedMemoryEgressQueue(SharedMemoryRing& ring, const std::chrono::nanoseconds fullTimeout = std::chrono::seconds(1), const Codec& codec = Codec());
+
+        // serialize @message into the ring, waiting for room while it's full.
+        // The ring holds a copy, the queue's reference is released.
+        // @throw SharedMemoryRingFull if the ring is still full after the
+        // timeout: the other process has stalled or gone.
+        void push(const MessagePtr& message);
+
+        // serialize @message into the ring, for producers which handle
+        // back-pressure themselves. No reference is taken or released.
+        // @return false if the ring is full.
+        bool try_push(const Message& message);
+
+        // the messages are processed in the other process.
+        // @return false, there is never a message to process here.
+        bool try_pop(MessagePtr&) { return false; }
+
+        std::size_t unsafe_size(void) const { return 0; }
+
+    private:
+        SharedMemoryEgressQueue(const SharedMemoryEgressQueue&) = delete;
+        SharedMemoryEgressQueue& operator=(const SharedMemoryEgressQueue&) = delete;
+
+    private:
+        SharedMemoryRing& ring_;
+        const std::chrono::nanoseconds fullTimeout_;
+        const Codec codec_;
+    };
+
+    template<class Message, class Codec>
+    class SharedMemoryIngressQueue
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        SharedMemoryIngressQueue(SharedMemoryRing& ring, const Codec& codec = Codec());
+
+        // ingress stages are event sources, this should never be called.
+        void push(const MessagePtr&);
+
+        // deserialize the oldest message in the ring.
+        bool try_pop(MessagePtr& message);
+
+        std::size_t unsafe_size(void) const { return ring_.unsafe_size(); }
+
+    private:
+        SharedMemoryIngressQueue(const SharedMemoryIngressQueue&) = delete;
+        SharedMemoryIngressQueue& operator=(const SharedMemoryIngressQueue&) = delete;
+
+    private:
+        SharedMemoryRing& ring_;
+        const Codec codec_;
+    };
+
+
+    template<class Message, class Codec>
+    SharedMemoryEgressQueue<Message, Codec>::SharedMemoryEgressQueue(SharedMemoryRing& ring, const std::chrono::nanoseconds fullTimeout, const Codec& codec)
+        : ring_(ring)
+        , fullTimeout_(fullTimeout)
+        , codec_(codec)
+    {
+    }
+
+    template<class Message, class Codec>
+    void SharedMemoryEgressQueue<Message, Codec>::push(const MessagePtr& message)
+    {
+        // take over the reference the dispatcher added for the queue.
+        typename Message::smartptr owned(details::create_smartptr<Message>(message, no_increment));
+
+        if(try_push(*message))
+        {
+            return;
+        }
+
+        const bool forever = fullTimeout_ == std::chrono::nanoseconds::max();
+        const auto deadline = forever ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + fullTimeout_;
+        do
+        {
+            std::this_thread::yield();
+
+            if(try_push(*message))
+            {
+                return;
+            }
+        }
+        while(forever || std::chrono::steady_clock::now() < deadline);
+
+        throw SharedMemoryRingFull();
+    }
+
+    template<class Message, class Codec>
+    inline
+    bool SharedMemoryEgressQueue<Message, Codec>::try_push(const Message& message)
+    {
+        const Codec& codec = codec_;
+        return ring_.try_push_with([&codec, &message](char* slot, std::size_t slotSize){
+            return codec.serialize(message, slot, slotSize);
+        });
+    }
+
+    template<class Message, class Codec>
+    SharedMemoryIngressQueue<Message, Codec>::SharedMemoryIngressQueue(SharedMemoryRing& ring, const Codec& codec)
+        : ring_(ring)
+        , codec_(codec)
+    {
+    }
+
+    template<class Message, class Codec>
+    void SharedMemoryIngressQueue<Message, Codec>::push(const MessagePtr&)
+    {
+        throw IllegallyPushedMessageOntoIngress();
+    }
+
+    template<class Message, class Codec>
+    bool SharedMemoryIngressQueue<Message, Codec>::try_pop(MessagePtr& message)
+    {
+        MessagePtr m = nullptr;
+
+        const Codec& codec = codec_;
+        const auto deserialize = [&codec, &m](const char* data, std::size_t length){
+            // an empty record is a message which failed to serialize.
+            if(length != 0)
+            {
+                m = codec.deserialize(data, length);
+            }
+        };
+
+        while(ring_.try_pop_with(deserialize))
+        {
+            if(m != nullptr)
+            {
+                // the stage takes over this reference when it processes the message.
+                m->incrementReferenceCount();
+                message = m;
+                return true;
+            }
+        }
+
+        return false;
+    }
+}}
@@ -0,0 +1,318 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wield { namespace io {
+
+    // <SharedMemoryRing> is a bounded queue of byte records in shared
+    // memory, for passing messages between processes. It's mapped from a
+    // file descriptor both processes can reach: a memfd inherited across
+    // fork or passed over a unix socket, or a file under /dev/shm.
+    //
+    // The ring is @capacity slots of @slotSize bytes. Slots are found by
+    // offset from the start of the mapping, never by pointer, so each
+    // process may map it at a different address. Pushing and popping are
+    // lock-free (a sequence number per slot, as in Vyukov's bounded
+    // queue), any number of threads in any number of processes may do
+    // either, and a record is read in place while its slot is held.
+    class SharedMemoryRing
+    {
+    public:
+        // lay a new ring out in @fd, resizing it to fit.
+        SharedMemoryRing(const int fd, const std::size_t capacity, const std::size_t slotSize);
+
+        // attach to the ring another process laid out in @fd.
+        explicit SharedMemoryRing(const int fd);
+
+        ~SharedMemoryRing();
+
+        // copy @length bytes of @data into a slot.
+        // @return false if the ring is full.
+        bool try_push(const void* data, const std::size_t length);
+
+        // reserve a slot and let @write fill it in place:
+        //      std::size_t write(char* slot, std::size_t slotSize);
+        // returning the number of bytes written.
+        // @return false if the ring is full.
+        template<class Writer>
+        bool try_push_with(Writer&& write);
+
+        // take the oldest record and call @read with it in place:
+        //      read(const char* data, std::size_t length);
+        // the slot is released when @read returns.
+        // @return false if the ring is empty.
+        template<class Reader>
+        bool try_pop_with(Reader&& read);
+
+        // number of records in the ring, only a hint while others push and pop.
+        std::size_t unsafe_size(void) const;
+
+        std::size_t capacity(void) const { return header_->capacity; }
+        std::size_t slotSize(void) const { return header_->slotSize; }
+
+    private:
+        SharedMemoryRing(const SharedMemoryRing&) = delete;
+        SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "SharedMemoryRing needs address-free 64 bit atomics.");
+
+        static const std::uint64_t Magic = 0x7769656c64726e67;  // "wieldrng"
+        static const std::size_t CacheLine = 64;
+
+        struct Header
+        {
+            std::atomic<std::uint64_t> magic;
+            std::uint64_t capacity;
+            std::uint64_t slotSize;
+            std::uint64_t stride;
+
+            alignas(CacheLine) std::atomic<std::uint64_t> enqueuePosition;
+            alignas(CacheLine) std::atomic<std::uint64_t> dequeuePosition;
+        };
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> sequence;
+            std::uint64_t length;
+
+            char* data(void) { return reinterpret_cast<char*>(this + 1); }
+        };
+
+        static std::size_t strideOf(const std::size_t slotSize);
+        static std::size_t sizeOf(const std::size_t capacity, const std::size_t stride);
+
+        void map(const int fd, const std::size_t size);
+        Slot& slot(const std::uint64_t position) const;
+
+    private:
+        void* memory_;
+        std::size_t size_;
+        Header* header_;
+    };
+
+
+    inline
+    SharedMemoryRing::SharedMemoryRing(const int fd, const std::size_t capacity, const std::size_t slotSize)
+        : memory_(MAP_FAILED)
+        , size_(0)
+        , header_(nullptr)
+    {
+        if(capacity == 0 || slotSize == 0)
+        {
+            throw std::invalid_argument("SharedMemoryRing needs at least one slot of at least one byte.");
+        }
+
+        const std::size_t stride = strideOf(slotSize);
+        const std::size_t size = sizeOf(capacity, stride);
+
+        if(::ftruncate(fd, static_cast<off_t>(size)) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SharedMemoryRing: ftruncate");
+        }
+
+        map(fd, size);
+
+        header_ = new (memory_) Header();
+        header_->capacity = capacity;
+        header_->slotSize = slotSize;
+        header_->stride = stride;
+        header_->enqueuePosition.store(0, std::memory_order_relaxed);
+        header_->dequeuePosition.store(0, std::memory_order_relaxed);
+
+        for(std::size_t i = 0; i < capacity; ++i)
+        {
+            Slot* s = new (static_cast<char*>(memory_) + sizeof(Header) + i * stride) Slot();
+            s->sequence.store(i, std::memory_order_relaxed);
+            s->length = 0;
+        }
+
+        // publish last, attaching before this sees an invalid ring.
+        header_->magic.store(Magic, std::memory_order_release);
+    }
+
+    inline
+    SharedMemoryRing::SharedMemoryRing(const int fd)
+        : memory_(MAP_FAILED)
+        , size_(0)
+        , header_(nullptr)
+    {
+        struct stat status;
+        if(::fstat(fd, &status) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SharedMemoryRing: fstat");
+        }
+
+        const std::size_t size = static_cast<std::size_t>(status.st_size);
+        if(size < sizeof(Header))
+        {
+            throw InvalidSharedMemoryRing();
+        }
+
+        map(fd, size);
+        header_ = static_cast<Header*>(memory_);
+
+        if(header_->magic.load(std::memory_order_acquire) != Magic
+            || header_->capacity == 0
+            || header_->stride != strideOf(header_->slotSize)
+            || sizeOf(header_->capacity, header_->stride) > size)
+        {
+            ::munmap(memory_, size_);
+            throw InvalidSharedMemoryRing();
+        }
+    }
+
+    inline
+    SharedMemoryRing::~SharedMemoryRing()
+    {
+        if(memory_ != MAP_FAILED)
+        {
+            ::munmap(memory_, size_);
+        }
+    }
+
+    inline
+    bool SharedMemoryRing::try_push(const void* data, const std::size_t length)
+    {
+        if(length > slotSize())
+        {
+            throw MessageTooLargeForSharedMemoryRing();
+        }
+
+        return try_push_with([data, length](char* slot, std::size_t){
+            std::memcpy(slot, data, length);
+            return length;
+        });
+    }
+
+    template<class Writer>
+    bool SharedMemoryRing::try_push_with(Writer&& write)
+    {
+        std::uint64_t position = header_->enqueuePosition.load(std::memory_order_relaxed);
+
+        for(;;)
+        {
+            Slot& s = slot(position);
+            const std::uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+            const std::int64_t difference = static_cast<std::int64_t>(sequence - position);
+
+            if(difference == 0)
+            {
+                if(header_->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    // a throwing writer leaves an empty record rather than a stuck slot.
+                    s.length = 0;
+                    struct Publish
+                    {
+                        ~Publish() { s.sequence.store(position + 1, std::memory_order_release); }
+                        Slot& s;
+                        std::uint64_t position;
+                    } publish{s, position};
+
+                    s.length = write(s.data(), static_cast<std::size_t>(header_->slotSize));
+                    return true;
+                }
+            }
+            else if(difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = header_->enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class Reader>
+    bool SharedMemoryRing::try_pop_with(Reader&& read)
+    {
+        std::uint64_t position = header_->dequeuePosition.load(std::memory_order_relaxed);
+
+        for(;;)
+        {
+            Slot& s = slot(position);
+            const std::uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+            const std::int64_t difference = static_cast<std::int64_t>(sequence - (position + 1));
+
+            if(difference == 0)
+            {
+                if(header_->dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    // hand the slot back to producers even if @read throws.
+                    struct Release
+                    {
+                        ~Release() { s.sequence.store(position + capacity, std::memory_order_release); }
+                        Slot& s;
+                        std::uint64_t position;
+                        std::uint64_t capacity;
+                    } release{s, position, header_->capacity};
+
+                    read(static_cast<const char*>(s.data()), static_cast<std::size_t>(s.length));
+                    return true;
+                }
+            }
+            else if(difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = header_->dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    inline
+    std::size_t SharedMemoryRing::unsafe_size(void) const
+    {
+        const std::uint64_t dequeued = header_->dequeuePosition.load(std::memory_order_relaxed);
+        const std::uint64_t enqueued = header_->enqueuePosition.load(std::memory_order_relaxed);
+
+        return enqueued > dequeued ? static_cast<std::size_t>(enqueued - dequeued) : 0;
+    }
+
+    inline
+    std::size_t SharedMemoryRing::strideOf(const std::size_t slotSize)
+    {
+        // keep every slot's sequence number on its own cache line.
+        const std::size_t size = sizeof(Slot) + slotSize;
+        return (size + CacheLine - 1) / CacheLine * CacheLine;
+    }
+
+    inline
+    std::size_t SharedMemoryRing::sizeOf(const std::size_t capacity, const std::size_t stride)
+    {
+        return sizeof(Header) + capacity * stride;
+    }
+
+    inline
+    void SharedMemoryRing::map(const int fd, const std::size_t size)
+    {
+        memory_ = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(memory_ == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::system_category(), "SharedMemoryRing: mmap");
+        }
+
+        size_ = size;
+    }
+
+    inline
+    SharedMemoryRing::Slot& SharedMemoryRing::slot(const std::uint64_t position) const
+    {
+        const std::size_t index = static_cast<std::size_t>(position % header_->capacity);
+        return *reinterpret_cast<Slot*>(static_cast<char*>(memory_) + sizeof(Header) + index * header_->stride);
+    }
+}}
@@ -0,0 +1,472 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/io/ReceiveBufferPool.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace wield { namespace io {
+
+    // <SocketIngress> is the queue of an ingress stage, it makes the
+    // scheduler poll sockets instead of dedicating a thread per socket.
+    // Linux only, it's built on epoll and recvmmsg.
+    //
+    // Each visit (try_pop) polls the sockets with a zero timeout and
+    // reads what's ready into buffers from a ReceiveBufferPool, up to
+    // @maxMessagesPerVisit. Every datagram, or every read from a stream
+    // socket, is handed to @MessageFactory:
+    //     struct MakePacket
+    //     {
+    //         Message::ptr operator()(wield::io::ReceiveBuffer&& buffer) const { return new Packet(std::move(buffer)); }
+    //     };
+    // and the message is dispatched to the target stage. The message
+    // keeps the buffer, which goes back to the pool when it is destroyed.
+    // Framing stream data is left to the stage receiving it.
+    //
+    // Datagram sockets are read with recvmmsg, a batch per system call.
+    // Listening stream sockets have their connections accepted and added.
+    // Stream sockets the peer closed are removed and closed.
+    //
+    // As with TimerWheel, nothing is pushed onto the ingress stage and
+    // try_pop() never returns a message. When the pool is exhausted
+    // reading stops until messages release their buffers, leaving the
+    // data in the kernel's socket buffers. Up to @maxMessagesPerVisit
+    // buffers are kept spare between visits, size the pool accordingly.
+    template<class StageEnum, class Message, class MessageFactory>
+    class SocketIngress
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        // @dispatcher anything with dispatch(StageEnum, Message&).
+        // @target the stage received messages are dispatched to.
+        template<class Dispatcher>
+        SocketIngress(
+            Dispatcher& dispatcher,
+            const StageEnum target,
+            ReceiveBufferPool& pool,
+            const std::size_t maxMessagesPerVisit = 64,
+            const MessageFactory& factory = MessageFactory());
+
+        ~SocketIngress();
+
+        // take ownership of @socket and poll it, it's made non-blocking.
+        // Call before the scheduler starts visiting the stage.
+        void addSocket(const int socket);
+
+        // ingress stages are event sources, this should never be called.
+        void push(const MessagePtr&);
+
+        // receive and dispatch what's ready, another thread already
+        // doing so makes this a no-op.
+        // @return false, there is never a message to process.
+        bool try_pop(MessagePtr& message);
+
+        // nothing waits to be processed on the ingress stage.
+        std::size_t unsafe_size(void) const { return 0; }
+
+        // number of messages dispatched so far.
+        std::size_t received(void) const { return received_.load(std::memory_order_relaxed); }
+
+    private:
+        SocketIngress(const SocketIngress&) = delete;
+        SocketIngress& operator=(const SocketIngress&) = delete;
+
+        enum class Kind
+        {
+            Datagram,
+            Stream,
+            Listener
+        };
+
+        struct Socket
+        {
+            int fd;
+            Kind kind;
+        };
+
+        template<class Dispatcher>
+        static void dispatchTo(void* dispatcher, const StageEnum target, Message& message)
+        {
+            static_cast<Dispatcher*>(dispatcher)->dispatch(target, message);
+        }
+
+        // @return the number of messages dispatched, at most @budget.
+        std::size_t receiveDatagrams(const int fd, const std::size_t budget);
+        std::size_t receiveStream(const std::size_t index, const std::size_t budget);
+        void accept(const int fd);
+
+        void remove(const std::size_t index);
+
+        // top up spare_ from the pool, @return false if none are spare.
+        bool refill(const std::size_t count);
+
+        // dispatch up to @budget of the buffers in ready_.
+        // @return the number dispatched.
+        std::size_t dispatchReady(const std::size_t budget);
+
+        void dispatch(ReceiveBuffer&& buffer);
+
+    private:
+        void* dispatcher_;
+        void (*dispatch_)(void*, const StageEnum, Message&);
+
+        const StageEnum target_;
+        ReceiveBufferPool& pool_;
+        const std::size_t maxMessagesPerVisit_;
+        const MessageFactory factory_;
+
+        int epoll_;
+
+        // the epoll data of a socket is its index here.
+        std::vector<Socket> sockets_;
+
+        std::atomic<bool> receiving_;
+        std::atomic<std::size_t> received_;
+
+        // only touched by the thread which claimed receiving_.
+        std::vector<epoll_event> events_;
+        std::vector<ReceiveBuffer> spare_;
+
+        // received buffers waiting to be dispatched, from nextReady_ on.
+        // Only left over between visits when a dispatch throws.
+        std::vector<ReceiveBuffer> ready_;
+        std::size_t nextReady_;
+
+        std::vector<mmsghdr> headers_;
+        std::vector<iovec> vectors_;
+    };
+
+
+    template<class StageEnum, class Message, class MessageFactory>
+    template<class Dispatcher>
+    SocketIngress<StageEnum, Message, MessageFactory>::SocketIngress(
+        Dispatcher& dispatcher,
+        const StageEnum target,
+        ReceiveBufferPool& pool,
+        const std::size_t maxMessagesPerVisit,
+        const MessageFactory& factory)
+        : dispatcher_(&dispatcher)
+        , dispatch_(&SocketIngress::dispatchTo<Dispatcher>)
+        , target_(target)
+        , pool_(pool)
+        , maxMessagesPerVisit_(maxMessagesPerVisit)
+        , factory_(factory)
+        , epoll_(::epoll_create1(EPOLL_CLOEXEC))
+        , receiving_(false)
+        , received_(0)
+        , events_(maxMessagesPerVisit)
+        , nextReady_(0)
+        , headers_(maxMessagesPerVisit)
+        , vectors_(maxMessagesPerVisit)
+    {
+        if(epoll_ == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SocketIngress: epoll_create1");
+        }
+
+        spare_.reserve(maxMessagesPerVisit);
+        ready_.reserve(maxMessagesPerVisit);
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    SocketIngress<StageEnum, Message, MessageFactory>::~SocketIngress()
+    {
+        for(const auto& socket : sockets_)
+        {
+            if(socket.fd != -1)
+            {
+                ::close(socket.fd);
+            }
+        }
+
+        ::close(epoll_);
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    void SocketIngress<StageEnum, Message, MessageFactory>::addSocket(const int socket)
+    {
+        int type = 0;
+        int listening = 0;
+        socklen_t length = sizeof(type);
+
+        if(::getsockopt(socket, SOL_SOCKET, SO_TYPE, &type, &length) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SocketIngress: getsockopt(SO_TYPE)");
+        }
+
+        length = sizeof(listening);
+        if(::getsockopt(socket, SOL_SOCKET, SO_ACCEPTCONN, &listening, &length) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SocketIngress: getsockopt(SO_ACCEPTCONN)");
+        }
+
+        const int flags = ::fcntl(socket, F_GETFL);
+        if(flags == -1 || ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SocketIngress: fcntl(O_NONBLOCK)");
+        }
+
+        const Kind kind = type == SOCK_DGRAM ? Kind::Datagram : (listening ? Kind::Listener : Kind::Stream);
+
+        // reuse the slot of a removed socket, so indices stay small.
+        std::size_t index = 0;
+        while(index < sockets_.size() && sockets_[index].fd != -1)
+        {
+            ++index;
+        }
+
+        epoll_event event = epoll_event();
+        event.events = EPOLLIN;
+        event.data.u64 = index;
+
+        if(::epoll_ctl(epoll_, EPOLL_CTL_ADD, socket, &event) == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "SocketIngress: epoll_ctl");
+        }
+
+        if(index == sockets_.size())
+        {
+            sockets_.push_back(Socket{socket, kind});
+        }
+        else
+        {
+            sockets_[index] = Socket{socket, kind};
+        }
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    void SocketIngress<StageEnum, Message, MessageFactory>::push(const MessagePtr&)
+    {
+        throw IllegallyPushedMessageOntoIngress();
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    bool SocketIngress<StageEnum, Message, MessageFactory>::try_pop(MessagePtr&)
+    {
+        if(receiving_.load(std::memory_order_relaxed) || receiving_.exchange(true, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        struct Release
+        {
+            ~Release() { receiving.store(false, std::memory_order_release); }
+            std::atomic<bool>& receiving;
+        } release{receiving_};
+
+        // what the last visit received but didn't dispatch goes first.
+        std::size_t budget = maxMessagesPerVisit_;
+        budget -= dispatchReady(budget);
+        if(budget == 0)
+        {
+            return false;
+        }
+
+        const int ready = ::epoll_wait(epoll_, events_.data(), static_cast<int>(events_.size()), 0);
+
+        for(int i = 0; i < ready && budget != 0; ++i)
+        {
+            const std::size_t index = static_cast<std::size_t>(events_[i].data.u64);
+            const Socket socket = sockets_[index];
+
+            // removed earlier in this visit.
+            if(socket.fd == -1)
+            {
+                continue;
+            }
+
+            switch(socket.kind)
+            {
+            case Kind::Datagram:
+                budget -= receiveDatagrams(socket.fd, budget);
+                break;
+
+            case Kind::Stream:
+                budget -= receiveStream(index, budget);
+                break;
+
+            case Kind::Listener:
+                accept(socket.fd);
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    std::size_t SocketIngress<StageEnum, Message, MessageFactory>::receiveDatagrams(const int fd, const std::size_t budget)
+    {
+        if(!refill(budget))
+        {
+            return 0;
+        }
+
+        const std::size_t count = spare_.size() < budget ? spare_.size() : budget;
+
+        // receive into the last @count spare buffers.
+        const std::size_t first = spare_.size() - count;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            ReceiveBuffer& buffer = spare_[first + i];
+
+            vectors_[i].iov_base = buffer.data();
+            vectors_[i].iov_len = buffer.capacity();
+
+            headers_[i] = mmsghdr();
+            headers_[i].msg_hdr.msg_name = &buffer.source_;
+            headers_[i].msg_hdr.msg_namelen = sizeof(buffer.source_);
+            headers_[i].msg_hdr.msg_iov = &vectors_[i];
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int received = ::recvmmsg(fd, headers_.data(), static_cast<unsigned int>(count), MSG_DONTWAIT, nullptr);
+        if(received <= 0)
+        {
+            return 0;
+        }
+
+        // the filled buffers leave spare_ before any is dispatched, a
+        // dispatch which throws mustn't leave one to be received into again.
+        for(int i = 0; i < received; ++i)
+        {
+            ReceiveBuffer& buffer = spare_[first + static_cast<std::size_t>(i)];
+            buffer.size_ = headers_[i].msg_len;
+            buffer.sourceLength_ = headers_[i].msg_hdr.msg_namelen;
+            buffer.socket_ = fd;
+
+            ready_.push_back(std::move(buffer));
+        }
+
+        spare_.erase(spare_.begin() + static_cast<std::ptrdiff_t>(first), spare_.begin() + static_cast<std::ptrdiff_t>(first) + received);
+
+        // in the order they were received.
+        return dispatchReady(static_cast<std::size_t>(received));
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    std::size_t SocketIngress<StageEnum, Message, MessageFactory>::receiveStream(const std::size_t index, const std::size_t budget)
+    {
+        const int fd = sockets_[index].fd;
+
+        std::size_t count = 0;
+        while(count < budget && refill(1))
+        {
+            ReceiveBuffer& buffer = spare_.back();
+
+            const ssize_t received = ::recv(fd, buffer.data(), buffer.capacity(), MSG_DONTWAIT);
+            if(received > 0)
+            {
+                ReceiveBuffer filled(std::move(buffer));
+                spare_.pop_back();
+
+                filled.size_ = static_cast<std::size_t>(received);
+                filled.sourceLength_ = 0;
+                filled.socket_ = fd;
+
+                dispatch(std::move(filled));
+
+                ++count;
+                continue;
+            }
+
+            if(received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            {
+                remove(index);
+            }
+            break;
+        }
+
+        return count;
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    void SocketIngress<StageEnum, Message, MessageFactory>::accept(const int fd)
+    {
+        for(;;)
+        {
+            const int connection = ::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(connection == -1)
+            {
+                return;
+            }
+
+            // the connection isn't ours until it's added.
+            try
+            {
+                addSocket(connection);
+            }
+            catch(...)
+            {
+                ::close(connection);
+                throw;
+            }
+        }
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    void SocketIngress<StageEnum, Message, MessageFactory>::remove(const std::size_t index)
+    {
+        ::epoll_ctl(epoll_, EPOLL_CTL_DEL, sockets_[index].fd, nullptr);
+        ::close(sockets_[index].fd);
+        sockets_[index].fd = -1;
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    bool SocketIngress<StageEnum, Message, MessageFactory>::refill(const std::size_t count)
+    {
+        while(spare_.size() < count)
+        {
+            ReceiveBuffer buffer = pool_.acquire();
+            if(!buffer)
+            {
+                break;
+            }
+
+            spare_.push_back(std::move(buffer));
+        }
+
+        return !spare_.empty();
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    std::size_t SocketIngress<StageEnum, Message, MessageFactory>::dispatchReady(const std::size_t budget)
+    {
+        std::size_t count = 0;
+        while(nextReady_ < ready_.size() && count < budget)
+        {
+            // taken out first: if the dispatch throws, it's released.
+            ReceiveBuffer buffer(std::move(ready_[nextReady_++]));
+            ++count;
+
+            dispatch(std::move(buffer));
+        }
+
+        if(nextReady_ == ready_.size())
+        {
+            ready_.clear();
+            nextReady_ = 0;
+        }
+
+        return count;
+    }
+
+    template<class StageEnum, class Message, class MessageFactory>
+    void SocketIngress<StageEnum, Message, MessageFactory>::dispatch(ReceiveBuffer&& buffer)
+    {
+        typename Message::smartptr message(factory_(std::move(buffer)));
+        dispatch_(dispatcher_, target_, *message);
+
+        received_.fetch_add(1, std::memory_order_relaxed);
+    }
+}}
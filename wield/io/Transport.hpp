@@ -0,0 +1,695 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/MessageBase.hpp>
+#include <wield/details/SmartPtrCreator.hpp>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace wield { namespace io {
+
+    // Transport stages span a stage graph across processes or hosts over
+    // a connected stream socket, TCP or unix domain. The queue of the last
+    // stage on one side is a TransportEgressQueue, messages dispatched to
+    // it are framed and sent to a named stage on the other side. There a
+    // TransportIngress, the queue of an ingress stage, reads the frames
+    // and dispatches each message to the stage named in its frame.
+    //
+    // Messages cross as bytes. @Codec is the same serialization hook as
+    // the SharedMemory queues use (serialization::RegistryCodec fits):
+    //     struct Codec
+    //     {
+    //         std::size_t serialize(const Message& message, char* buffer, std::size_t capacity) const;
+    //         Message::ptr deserialize(const char* data, std::size_t length) const;
+    //     };
+    //
+    // Each link is flow controlled with credits: the egress starts with
+    // @window credits and spends one per frame it sends, the ingress hands
+    // them back over the same socket as it dispatches the messages. When
+    // the far side falls behind the frames wait in the egress queue, and
+    // once @window frames are waiting, pushing blocks until it catches up,
+    // or gives up with TransportWindowFull after @fullTimeout.
+    //
+    // Linux only, both ends are non-blocking and are polled when the
+    // scheduler visits the stage.
+    struct TransportFrame
+    {
+        // a frame is a header followed by the payload, padded so that the
+        // next frame's header, and payload, are 8 byte aligned.
+        // Header fields and credits are in network byte order.
+        struct Header
+        {
+            std::uint32_t length;
+            std::uint32_t stage;
+        };
+
+        static const std::size_t Alignment = 8;
+
+        static std::size_t sizeOf(const std::size_t length)
+        {
+            return sizeof(Header) + (length + Alignment - 1) / Alignment * Alignment;
+        }
+
+        static void makeNonBlocking(const int socket, const char* what)
+        {
+            const int flags = ::fcntl(socket, F_GETFL);
+            if(flags == -1 || ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1)
+            {
+                throw std::system_error(errno, std::system_category(), what);
+            }
+        }
+    };
+
+    template<class StageEnum, class Message, class Codec>
+    class TransportEgressQueue
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        // take ownership of the connected @socket, it's made non-blocking.
+        // @remoteStage the stage messages are dispatched to on the far side.
+        // @window the number of frames in flight on the link.
+        // @maxMessageSize the most bytes a message serializes to.
+        // @fullTimeout how long push waits for room in a full window,
+        // std::chrono::nanoseconds::max() waits for as long as it takes.
+        TransportEgressQueue(
+            const int socket,
+            const StageEnum remoteStage,
+            const std::size_t window = 256,
+            const std::size_t maxMessageSize = 4096,
+            const std::chrono::nanoseconds fullTimeout = std::chrono::seconds(1),
+            const Codec& codec = Codec());
+
+        ~TransportEgressQueue();
+
+        // frame @message, the queue's reference is released. A full window
+        // of frames is sent straight away, while one can't be the next push
+        // waits for credit.
+        // @throw TransportWindowFull if the window is still full after the
+        // timeout: the far side has stalled. @message isn't sent.
+        // @throw TransportLinkClosed once the far side has gone.
+        void push(const MessagePtr& message);
+
+        // send the waiting frames the link has credit for, with a single
+        // gathering write.
+        // @return false, there is never a message to process here.
+        bool try_pop(MessagePtr& message);
+
+        // frames waiting to be sent.
+        std::size_t unsafe_size(void) const { return queued_.load(std::memory_order_relaxed); }
+
+        // number of frames sent so far.
+        std::size_t sent(void) const { return sent_.load(std::memory_order_relaxed); }
+
+        bool closed(void) const { return closed_.load(std::memory_order_relaxed); }
+
+    private:
+        TransportEgressQueue(const TransportEgressQueue&) = delete;
+        TransportEgressQueue& operator=(const TransportEgressQueue&) = delete;
+
+        // frames gathered by one write.
+        static const std::size_t MaxVectors = 64;
+
+        struct Frame
+        {
+            std::vector<char> bytes;
+            std::size_t length;
+        };
+
+        // the following are called with mutex_ held.
+        void flush(void);
+        void receiveCredits(void);
+        void consume(std::size_t written);
+
+    private:
+        const int socket_;
+        const std::uint32_t remoteStage_;
+        const std::size_t window_;
+        const std::size_t maxMessageSize_;
+        const std::chrono::nanoseconds fullTimeout_;
+        const Codec codec_;
+
+        std::mutex mutex_;
+        std::deque<Frame> pending_;
+        std::vector<Frame> free_;
+        std::vector<iovec> vectors_;
+
+        std::size_t credits_;
+
+        // bytes of the front frame already written, it was charged a credit then.
+        std::size_t offset_;
+        bool frontCharged_;
+
+        char creditBytes_[64];
+        std::size_t creditBytesReceived_;
+
+        std::atomic<bool> closed_;
+        std::atomic<std::size_t> queued_;
+        std::atomic<std::size_t> sent_;
+    };
+
+    template<class StageEnum, class Message, class Codec>
+    class TransportIngress
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+
+        // take ownership of the connected @socket, it's made non-blocking.
+        // @dispatcher anything with dispatch(StageEnum, Message&).
+        // @maxMessageSize must be at least that of the egress.
+        template<class Dispatcher>
+        TransportIngress(
+            Dispatcher& dispatcher,
+            const int socket,
+            const std::size_t maxMessageSize = 4096,
+            const std::size_t maxMessagesPerVisit = 64,
+            const Codec& codec = Codec());
+
+        ~TransportIngress();
+
+        // ingress stages are event sources, this should never be called.
+        void push(const MessagePtr&);
+
+        // read and dispatch the frames which have arrived, up to
+        // @maxMessagesPerVisit, and return their credit to the egress.
+        // Another thread already doing so makes this a no-op.
+        // @return false, there is never a message to process.
+        bool try_pop(MessagePtr& message);
+
+        // nothing waits to be processed on the ingress stage.
+        std::size_t unsafe_size(void) const { return 0; }
+
+        // number of messages dispatched so far.
+        std::size_t received(void) const { return received_.load(std::memory_order_relaxed); }
+
+        bool closed(void) const { return closed_.load(std::memory_order_relaxed); }
+
+    private:
+        TransportIngress(const TransportIngress&) = delete;
+        TransportIngress& operator=(const TransportIngress&) = delete;
+
+        template<class Dispatcher>
+        static void dispatchTo(void* dispatcher, const StageEnum stage, Message& message)
+        {
+            static_cast<Dispatcher*>(dispatcher)->dispatch(stage, message);
+        }
+
+        // @return the number of messages dispatched, at most @budget.
+        std::size_t dispatchFrames(const std::size_t budget);
+
+        // @return false if nothing more could be read.
+        bool receive(void);
+
+        void grantCredits(void);
+
+    private:
+        void* dispatcher_;
+        void (*dispatch_)(void*, const StageEnum, Message&);
+
+        const int socket_;
+        const std::size_t maxMessageSize_;
+        const std::size_t maxMessagesPerVisit_;
+        const Codec codec_;
+
+        std::atomic<bool> receiving_;
+        std::atomic<bool> closed_;
+        std::atomic<std::size_t> received_;
+
+        // only touched by the thread which claimed receiving_.
+        std::vector<char> buffer_;
+        std::size_t begin_;
+        std::size_t end_;
+
+        std::size_t owed_;
+        char creditBytes_[sizeof(std::uint32_t)];
+        std::size_t creditBytesSent_;
+        std::size_t creditBytesLength_;
+    };
+
+
+    template<class StageEnum, class Message, class Codec>
+    const std::size_t TransportEgressQueue<StageEnum, Message, Codec>::MaxVectors;
+
+    template<class StageEnum, class Message, class Codec>
+    TransportEgressQueue<StageEnum, Message, Codec>::TransportEgressQueue(
+        const int socket,
+        const StageEnum remoteStage,
+        const std::size_t window,
+        const std::size_t maxMessageSize,
+        const std::chrono::nanoseconds fullTimeout,
+        const Codec& codec)
+        : socket_(socket)
+        , remoteStage_(static_cast<std::uint32_t>(remoteStage))
+        , window_(window)
+        , maxMessageSize_(maxMessageSize)
+        , fullTimeout_(fullTimeout)
+        , codec_(codec)
+        , credits_(window)
+        , offset_(0)
+        , frontCharged_(false)
+        , creditBytesReceived_(0)
+        , closed_(false)
+        , queued_(0)
+        , sent_(0)
+    {
+        if(window == 0 || maxMessageSize == 0 || maxMessageSize > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::invalid_argument("TransportEgressQueue needs a window of at least one frame, of at least one byte.");
+        }
+
+        TransportFrame::makeNonBlocking(socket, "TransportEgressQueue: fcntl(O_NONBLOCK)");
+        vectors_.reserve(MaxVectors);
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    TransportEgressQueue<StageEnum, Message, Codec>::~TransportEgressQueue()
+    {
+        ::close(socket_);
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportEgressQueue<StageEnum, Message, Codec>::push(const MessagePtr& message)
+    {
+        // take over the reference the dispatcher added for the queue.
+        typename Message::smartptr owned(details::create_smartptr<Message>(message, no_increment));
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // hold the pusher back while the far side catches up.
+        if(pending_.size() >= window_)
+        {
+            const bool forever = fullTimeout_ == std::chrono::nanoseconds::max();
+            const auto deadline = forever ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + fullTimeout_;
+            for(;;)
+            {
+                flush();
+                if(pending_.size() < window_)
+                {
+                    break;
+                }
+
+                if(!forever && std::chrono::steady_clock::now() >= deadline)
+                {
+                    throw TransportWindowFull();
+                }
+
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+
+        if(closed())
+        {
+            throw TransportLinkClosed();
+        }
+
+        Frame frame;
+        if(free_.empty())
+        {
+            frame.bytes.resize(TransportFrame::sizeOf(maxMessageSize_));
+        }
+        else
+        {
+            frame = std::move(free_.back());
+            free_.pop_back();
+        }
+
+        std::size_t length = 0;
+        try
+        {
+            length = codec_.serialize(*message, frame.bytes.data() + sizeof(TransportFrame::Header), maxMessageSize_);
+        }
+        catch(...)
+        {
+            free_.push_back(std::move(frame));
+            throw;
+        }
+
+        const TransportFrame::Header header{ htonl(static_cast<std::uint32_t>(length)), htonl(remoteStage_) };
+        std::memcpy(frame.bytes.data(), &header, sizeof(header));
+
+        frame.length = TransportFrame::sizeOf(length);
+        std::memset(frame.bytes.data() + sizeof(header) + length, 0, frame.length - sizeof(header) - length);
+
+        pending_.push_back(std::move(frame));
+        queued_.fetch_add(1, std::memory_order_relaxed);
+
+        // a full batch goes out now.
+        if(pending_.size() >= window_)
+        {
+            flush();
+        }
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    bool TransportEgressQueue<StageEnum, Message, Codec>::try_pop(MessagePtr&)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush();
+
+        return false;
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportEgressQueue<StageEnum, Message, Codec>::flush(void)
+    {
+        receiveCredits();
+
+        if(closed() && !pending_.empty())
+        {
+            throw TransportLinkClosed();
+        }
+
+        while(!pending_.empty())
+        {
+            // a partly written frame has been paid for already.
+            const std::size_t affordable = credits_ + (frontCharged_ ? 1 : 0);
+            const std::size_t count = std::min(std::min(pending_.size(), affordable), MaxVectors);
+
+            if(count == 0)
+            {
+                return;
+            }
+
+            vectors_.clear();
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t skip = i == 0 ? offset_ : 0;
+
+                iovec vector;
+                vector.iov_base = pending_[i].bytes.data() + skip;
+                vector.iov_len = pending_[i].length - skip;
+                vectors_.push_back(vector);
+            }
+
+            // sendmsg is writev with flags, a vanished peer must not raise SIGPIPE.
+            msghdr header = msghdr();
+            header.msg_iov = vectors_.data();
+            header.msg_iovlen = vectors_.size();
+
+            const ssize_t written = ::sendmsg(socket_, &header, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if(written == -1)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    return;
+                }
+
+                closed_.store(true, std::memory_order_relaxed);
+                if(errno == EPIPE || errno == ECONNRESET)
+                {
+                    throw TransportLinkClosed();
+                }
+
+                throw std::system_error(errno, std::system_category(), "TransportEgressQueue: sendmsg");
+            }
+
+            consume(static_cast<std::size_t>(written));
+        }
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportEgressQueue<StageEnum, Message, Codec>::receiveCredits(void)
+    {
+        while(!closed())
+        {
+            const ssize_t received = ::recv(
+                socket_,
+                creditBytes_ + creditBytesReceived_,
+                sizeof(creditBytes_) - creditBytesReceived_,
+                MSG_DONTWAIT);
+
+            if(received > 0)
+            {
+                creditBytesReceived_ += static_cast<std::size_t>(received);
+
+                std::size_t used = 0;
+                for(; used + sizeof(std::uint32_t) <= creditBytesReceived_; used += sizeof(std::uint32_t))
+                {
+                    std::uint32_t grant = 0;
+                    std::memcpy(&grant, creditBytes_ + used, sizeof(grant));
+                    credits_ += ntohl(grant);
+                }
+
+                creditBytesReceived_ -= used;
+                std::memmove(creditBytes_, creditBytes_ + used, creditBytesReceived_);
+            }
+            else if(received == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            else if(received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                return;
+            }
+            else
+            {
+                closed_.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportEgressQueue<StageEnum, Message, Codec>::consume(std::size_t written)
+    {
+        while(written != 0)
+        {
+            if(!frontCharged_)
+            {
+                --credits_;
+                frontCharged_ = true;
+            }
+
+            Frame& front = pending_.front();
+            const std::size_t remaining = front.length - offset_;
+
+            if(written < remaining)
+            {
+                offset_ += written;
+                return;
+            }
+
+            written -= remaining;
+            offset_ = 0;
+            frontCharged_ = false;
+
+            free_.push_back(std::move(front));
+            pending_.pop_front();
+
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            sent_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    template<class Dispatcher>
+    TransportIngress<StageEnum, Message, Codec>::TransportIngress(
+        Dispatcher& dispatcher,
+        const int socket,
+        const std::size_t maxMessageSize,
+        const std::size_t maxMessagesPerVisit,
+        const Codec& codec)
+        : dispatcher_(&dispatcher)
+        , dispatch_(&TransportIngress::dispatchTo<Dispatcher>)
+        , socket_(socket)
+        , maxMessageSize_(maxMessageSize)
+        , maxMessagesPerVisit_(maxMessagesPerVisit)
+        , codec_(codec)
+        , receiving_(false)
+        , closed_(false)
+        , received_(0)
+        , buffer_(std::max<std::size_t>(64 * 1024, 2 * TransportFrame::sizeOf(maxMessageSize)))
+        , begin_(0)
+        , end_(0)
+        , owed_(0)
+        , creditBytesSent_(0)
+        , creditBytesLength_(0)
+    {
+        TransportFrame::makeNonBlocking(socket, "TransportIngress: fcntl(O_NONBLOCK)");
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    TransportIngress<StageEnum, Message, Codec>::~TransportIngress()
+    {
+        ::close(socket_);
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportIngress<StageEnum, Message, Codec>::push(const MessagePtr&)
+    {
+        throw IllegallyPushedMessageOntoIngress();
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    bool TransportIngress<StageEnum, Message, Codec>::try_pop(MessagePtr&)
+    {
+        if(receiving_.load(std::memory_order_relaxed) || receiving_.exchange(true, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        struct Release
+        {
+            ~Release() { receiving.store(false, std::memory_order_release); }
+            std::atomic<bool>& receiving;
+        } release{receiving_};
+
+        std::size_t budget = maxMessagesPerVisit_;
+        budget -= dispatchFrames(budget);
+
+        while(budget != 0 && receive())
+        {
+            budget -= dispatchFrames(budget);
+        }
+
+        grantCredits();
+        return false;
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    std::size_t TransportIngress<StageEnum, Message, Codec>::dispatchFrames(const std::size_t budget)
+    {
+        std::size_t count = 0;
+        while(count < budget && end_ - begin_ >= sizeof(TransportFrame::Header))
+        {
+            TransportFrame::Header header;
+            std::memcpy(&header, buffer_.data() + begin_, sizeof(header));
+
+            const std::size_t length = ntohl(header.length);
+            if(length > maxMessageSize_)
+            {
+                throw MessageTooLargeForBuffer();
+            }
+
+            const std::size_t frameSize = TransportFrame::sizeOf(length);
+            if(end_ - begin_ < frameSize)
+            {
+                break;
+            }
+
+            // move past the frame first, one which fails to deserialize is dropped.
+            const char* payload = buffer_.data() + begin_ + sizeof(header);
+            begin_ += frameSize;
+            ++owed_;
+            ++count;
+
+            const std::uint32_t stage = ntohl(header.stage);
+            if(stage >= static_cast<std::uint32_t>(StageEnum::NumberOfEntries))
+            {
+                throw UnknownStageName();
+            }
+
+            typename Message::smartptr message(codec_.deserialize(payload, length));
+            dispatch_(dispatcher_, static_cast<StageEnum>(stage), *message);
+
+            received_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    bool TransportIngress<StageEnum, Message, Codec>::receive(void)
+    {
+        if(closed())
+        {
+            return false;
+        }
+
+        // frames are multiples of the alignment, so moving the rest to the front keeps them aligned.
+        if(begin_ != 0)
+        {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+
+        for(;;)
+        {
+            const ssize_t received = ::recv(socket_, buffer_.data() + end_, buffer_.size() - end_, MSG_DONTWAIT);
+            if(received > 0)
+            {
+                end_ += static_cast<std::size_t>(received);
+                return true;
+            }
+
+            if(received == -1 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if(received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                closed_.store(true, std::memory_order_relaxed);
+            }
+
+            return false;
+        }
+    }
+
+    template<class StageEnum, class Message, class Codec>
+    void TransportIngress<StageEnum, Message, Codec>::grantCredits(void)
+    {
+        if(creditBytesLength_ == 0 && owed_ != 0)
+        {
+            const std::uint32_t grant = static_cast<std::uint32_t>(std::min<std::size_t>(owed_, std::numeric_limits<std::uint32_t>::max()));
+            owed_ -= grant;
+
+            const std::uint32_t wire = htonl(grant);
+            std::memcpy(creditBytes_, &wire, sizeof(wire));
+            creditBytesLength_ = sizeof(wire);
+            creditBytesSent_ = 0;
+        }
+
+        while(creditBytesSent_ < creditBytesLength_ && !closed())
+        {
+            const ssize_t sent = ::send(
+                socket_,
+                creditBytes_ + creditBytesSent_,
+                creditBytesLength_ - creditBytesSent_,
+                MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            if(sent > 0)
+            {
+                creditBytesSent_ += static_cast<std::size_t>(sent);
+            }
+            else if(sent == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                // a full socket buffer sends them next visit.
+                return;
+            }
+        }
+
+        creditBytesLength_ = 0;
+        creditBytesSent_ = 0;
+    }
+}}
@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace wield { namespace memory {
+
+    // <BatchArena> is a bump allocator for what processing functors need
+    // only while they process a message: side buffers, strings, vectors.
+    // Allocating is a pointer bump and freeing is a no-op, everything is
+    // freed at once by reset().
+    //
+    // Each scheduler thread has one, current(), which SchedulerBase resets
+    // after each batch a thread spends at a stage. Memory from it must
+    // not outlive the batch: nothing allocated there may be kept in a
+    // message which is dispatched on, or in the functor.
+    //
+    //      void operator()(Quote& quote)
+    //      {
+    //          BatchArenaString symbol(quote.symbol(), BatchArenaAllocator<char>());
+    //          ...
+    //      }
+    //
+    // Blocks are kept across resets, so a thread's steady state makes no
+    // calls to malloc. Allocations larger than a block get a block of
+    // their own, which reset() does free.
+    class BatchArena
+    {
+    public:
+        explicit BatchArena(const std::size_t blockSize = 64 * 1024);
+
+        // @return @bytes aligned to @alignment, a power of two.
+        void* allocate(const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t));
+
+        // free everything allocated since the last reset.
+        void reset(void);
+
+        // bytes handed out since the last reset.
+        std::size_t allocated(void) const { return allocated_; }
+
+        // the calling thread's arena.
+        static BatchArena& current(void);
+
+    private:
+        BatchArena(const BatchArena&) = delete;
+        BatchArena& operator=(const BatchArena&) = delete;
+
+        // start on the next kept block, or a new one.
+        void nextBlock(void);
+
+    private:
+        const std::size_t blockSize_;
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        std::vector<std::unique_ptr<char[]>> oversized_;
+
+        // the block being bumped through.
+        std::size_t block_;
+        char* position_;
+        char* end_;
+
+        std::size_t allocated_;
+    };
+
+    // <BatchArenaAllocator> is a standard allocator drawing on a BatchArena,
+    // the calling thread's unless given one.
+    template<class T>
+    class BatchArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        BatchArenaAllocator() : arena_(&BatchArena::current()) {}
+        explicit BatchArenaAllocator(BatchArena& arena) : arena_(&arena) {}
+
+        template<class U>
+        BatchArenaAllocator(const BatchArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+        T* allocate(const std::size_t n)
+        {
+            if(n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+
+            return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        // freed in bulk when the arena is reset.
+        void deallocate(T*, const std::size_t) {}
+
+    private:
+        template<class U> friend class BatchArenaAllocator;
+        template<class A, class B> friend bool operator==(const BatchArenaAllocator<A>&, const BatchArenaAllocator<B>&);
+
+        BatchArena* arena_;
+    };
+
+    template<class T, class U>
+    bool operator==(const BatchArenaAllocator<T>& lhs, const BatchArenaAllocator<U>& rhs) { return lhs.arena_ == rhs.arena_; }
+
+    template<class T, class U>
+    bool operator!=(const BatchArenaAllocator<T>& lhs, const BatchArenaAllocator<U>& rhs) { return !(lhs == rhs); }
+
+    using BatchArenaString = std::basic_string<char, std::char_traits<char>, BatchArenaAllocator<char>>;
+
+    template<class T>
+    using BatchArenaVector = std::vector<T, BatchArenaAllocator<T>>;
+
+
+    inline
+    BatchArena::BatchArena(const std::size_t blockSize)
+        : blockSize_(blockSize)
+        , block_(0)
+        , position_(nullptr)
+        , end_(nullptr)
+        , allocated_(0)
+    {
+    }
+
+    inline
+    void* BatchArena::allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(position_) + alignment - 1) & ~(alignment - 1);
+
+        if(position_ == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_))
+        {
+            if(bytes + alignment > blockSize_)
+            {
+                oversized_.emplace_back(new char[bytes + alignment]);
+                allocated_ += bytes;
+
+                const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(oversized_.back().get());
+                return reinterpret_cast<void*>((start + alignment - 1) & ~(alignment - 1));
+            }
+
+            nextBlock();
+            aligned = (reinterpret_cast<std::uintptr_t>(position_) + alignment - 1) & ~(alignment - 1);
+        }
+
+        position_ = reinterpret_cast<char*>(aligned + bytes);
+        allocated_ += bytes;
+
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    inline
+    void BatchArena::reset(void)
+    {
+        if(allocated_ == 0)
+        {
+            return;
+        }
+
+        oversized_.clear();
+
+        block_ = 0;
+        position_ = blocks_.empty() ? nullptr : blocks_[0].get();
+        end_ = blocks_.empty() ? nullptr : position_ + blockSize_;
+
+        allocated_ = 0;
+    }
+
+    inline
+    BatchArena& BatchArena::current(void)
+    {
+        static thread_local BatchArena arena;
+        return arena;
+    }
+
+    inline
+    void BatchArena::nextBlock(void)
+    {
+        if(position_ != nullptr)
+        {
+            ++block_;
+        }
+
+        if(block_ == blocks_.size())
+        {
+            blocks_.emplace_back(new char[blockSize_]);
+        }
+
+        position_ = blocks_[block_].get();
+        end_ = position_ + blockSize_;
+    }
+}}
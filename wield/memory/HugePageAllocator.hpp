@@ -0,0 +1,214 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace wield { namespace memory {
+
+    enum class Placement
+    {
+        // wherever the kernel's policy puts it, usually the node of the
+        // thread which first touches each page.
+        Default,
+
+        // on the NUMA node of the thread which allocates it, whoever
+        // touches it first. For structures a thread makes for itself.
+        LocalNode
+    };
+
+    // <HugePages> maps the memory of HugePageAllocator. Large blocks are
+    // backed by huge pages, to cut the TLB misses of walking big rings and
+    // pools: explicit ones (MAP_HUGETLB) when the system has some reserved,
+    // transparent ones (MADV_HUGEPAGE) otherwise, and plain pages when
+    // neither is available. Elsewhere than Linux it's operator new.
+    struct HugePages
+    {
+        // the x86-64 and aarch64 default.
+        static const std::size_t PageSize = 2 * 1024 * 1024;
+
+        // smaller blocks aren't worth a huge page, they come from operator new.
+        static const std::size_t Threshold = PageSize / 2;
+
+        // @return a block of at least @bytes, PageSize aligned on Linux.
+        // @throw std::bad_alloc
+        static void* allocate(const std::size_t bytes, const Placement placement);
+
+        static void deallocate(void* memory, const std::size_t bytes);
+
+        static std::size_t mappedSizeOf(const std::size_t bytes)
+        {
+            return (bytes + PageSize - 1) / PageSize * PageSize;
+        }
+
+    private:
+        static void bindToLocalNode(void* memory, const std::size_t bytes);
+    };
+
+    // <HugePageAllocator> is a standard allocator for wield's preallocated
+    // structures: the slots of a ReorderingQueue, the buffers of a
+    // ReceiveBufferPool, ThreadAssignments, or any std container.
+    //
+    //      using Slots = wield::memory::HugePageAllocator<std::atomic<MessagePtr>>;
+    //      ReorderingQueue<MessagePtr, BySequence, Queue, Slots> queue(1 << 20, timeout);
+    //
+    // Blocks under HugePages::Threshold come from operator new. Allocate
+    // once, up front: mapping memory is a system call.
+    template<class T, Placement P = Placement::Default>
+    class HugePageAllocator
+    {
+    public:
+        using value_type = T;
+
+        template<class U>
+        struct rebind
+        {
+            using other = HugePageAllocator<U, P>;
+        };
+
+        HugePageAllocator() noexcept {}
+
+        template<class U>
+        HugePageAllocator(const HugePageAllocator<U, P>&) noexcept {}
+
+        T* allocate(const std::size_t n);
+        void deallocate(T* memory, const std::size_t n);
+    };
+
+    // huge pages on the allocating thread's node, for per-thread structures.
+    template<class T>
+    using NodeLocalAllocator = HugePageAllocator<T, Placement::LocalNode>;
+
+    template<class T, class U, Placement P>
+    bool operator==(const HugePageAllocator<T, P>&, const HugePageAllocator<U, P>&) { return true; }
+
+    template<class T, class U, Placement P>
+    bool operator!=(const HugePageAllocator<T, P>&, const HugePageAllocator<U, P>&) { return false; }
+
+
+    template<class T, Placement P>
+    T* HugePageAllocator<T, P>::allocate(const std::size_t n)
+    {
+        if(n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+
+        const std::size_t bytes = n * sizeof(T);
+        if(bytes < HugePages::Threshold)
+        {
+            return static_cast<T*>(::operator new(bytes));
+        }
+
+        return static_cast<T*>(HugePages::allocate(bytes, P));
+    }
+
+    template<class T, Placement P>
+    void HugePageAllocator<T, P>::deallocate(T* memory, const std::size_t n)
+    {
+        const std::size_t bytes = n * sizeof(T);
+        if(bytes < HugePages::Threshold)
+        {
+            ::operator delete(memory);
+            return;
+        }
+
+        HugePages::deallocate(memory, bytes);
+    }
+
+#if defined(__linux__)
+
+    inline
+    void* HugePages::allocate(const std::size_t bytes, const Placement placement)
+    {
+        const std::size_t size = mappedSizeOf(bytes);
+
+        void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(memory == MAP_FAILED)
+        {
+            // no huge pages reserved: over-map to align the block to a huge
+            // page, so transparent huge pages can back all of it.
+            char* mapped = static_cast<char*>(::mmap(nullptr, size + PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if(mapped == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+
+            char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(mapped) + PageSize - 1) / PageSize * PageSize);
+
+            const std::size_t head = static_cast<std::size_t>(aligned - mapped);
+            if(head != 0)
+            {
+                ::munmap(mapped, head);
+            }
+
+            const std::size_t tail = PageSize - head;
+            if(tail != 0)
+            {
+                ::munmap(aligned + size, tail);
+            }
+
+            // only advice, kernels without THP carry on with plain pages.
+            ::madvise(aligned, size, MADV_HUGEPAGE);
+            memory = aligned;
+        }
+
+        if(placement == Placement::LocalNode)
+        {
+            bindToLocalNode(memory, size);
+        }
+
+        return memory;
+    }
+
+    inline
+    void HugePages::deallocate(void* memory, const std::size_t bytes)
+    {
+        ::munmap(memory, mappedSizeOf(bytes));
+    }
+
+    inline
+    void HugePages::bindToLocalNode(void* memory, const std::size_t bytes)
+    {
+        // raw system calls, rather than a dependency on libnuma.
+        unsigned int cpu = 0;
+        unsigned int node = 0;
+        if(::syscall(SYS_getcpu, &cpu, &node, nullptr) == -1 || node >= sizeof(unsigned long) * 8)
+        {
+            return;
+        }
+
+        // nothing is touched yet, pages are placed on @node as they fault in.
+        static const int PreferredPolicy = 1;  // MPOL_PREFERRED
+        const unsigned long nodeMask = 1UL << node;
+
+        ::syscall(SYS_mbind, memory, bytes, PreferredPolicy, &nodeMask, sizeof(nodeMask) * 8, 0);
+    }
+
+#else
+
+    inline
+    void* HugePages::allocate(const std::size_t bytes, const Placement)
+    {
+        return ::operator new(bytes);
+    }
+
+    inline
+    void HugePages::deallocate(void* memory, const std::size_t)
+    {
+        ::operator delete(memory);
+    }
+
+    inline
+    void HugePages::bindToLocalNode(void*, const std::size_t)
+    {
+    }
+
+#endif
+}}
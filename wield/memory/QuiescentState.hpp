@@ -0,0 +1,167 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace wield { namespace memory {
+
+    // <QuiescentState> lets a writer which replaced shared data find out
+    // when no thread can still be reading the old copy, while readers do
+    // no more than load the pointer to it: quiescent state based
+    // reclamation.
+    //
+    // A thread is quiescent when it holds nothing it read from shared
+    // data. SchedulerBase reports this after each batch a thread spends at
+    // a stage, threads processing outside a scheduler call quiescent()
+    // themselves. A reader calls online() before it first reads, from then
+    // on writers wait for it, until the thread exits.
+    //
+    // A writer swaps in the new data and calls retire() to begin a grace
+    // period, the old data can be freed once elapsed() says every online
+    // thread has been quiescent since. A thread which stays online without
+    // reporting holds the old data back, it isn't freed early.
+    // See dynamic::FanoutProcessingFunctor.
+    class QuiescentState
+    {
+    public:
+        // make the calling thread one writers wait for, a thread local
+        // check once it is.
+        static void online(void);
+
+        // report the calling thread holds nothing read from shared data.
+        static void quiescent(void);
+
+        // begin a grace period, after replacing the shared data.
+        // @return the epoch to pass to elapsed().
+        static std::uint64_t retire(void);
+
+        // @return true once every online thread has been quiescent since
+        // @epoch began.
+        static bool elapsed(const std::uint64_t epoch);
+
+    private:
+        // a thread's record. They are never freed, those of threads which
+        // exited are reused.
+        struct Record
+        {
+            // the epoch at the thread's last quiescent state.
+            std::atomic<std::uint64_t> seen;
+            std::atomic<bool> inUse;
+            Record* next;
+
+            // the next record's seen is on another cache line.
+            char padding[64];
+        };
+
+        // seen by a record no thread is reading through.
+        static const std::uint64_t Offline = 0;
+
+        // takes part for as long as its thread runs.
+        struct Participant
+        {
+            Participant();
+            ~Participant();
+
+            Record* record;
+        };
+
+        static std::atomic<std::uint64_t>& epoch(void);
+        static std::atomic<Record*>& records(void);
+
+        // the calling thread's record.
+        static Record& self(void);
+    };
+
+
+    inline
+    void QuiescentState::online(void)
+    {
+        self();
+    }
+
+    inline
+    void QuiescentState::quiescent(void)
+    {
+        Record& record = self();
+        record.seen.store(epoch().load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    inline
+    std::uint64_t QuiescentState::retire(void)
+    {
+        // readers which see the new epoch see the data replaced before it.
+        return epoch().fetch_add(1) + 1;
+    }
+
+    inline
+    bool QuiescentState::elapsed(const std::uint64_t epoch)
+    {
+        for(Record* record = records().load(); record != nullptr; record = record->next)
+        {
+            const std::uint64_t seen = record->seen.load();
+            if(seen != Offline && seen < epoch)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline
+    QuiescentState::Participant::Participant()
+        : record(nullptr)
+    {
+        for(Record* r = records().load(); r != nullptr && record == nullptr; r = r->next)
+        {
+            bool inUse = false;
+            if(r->inUse.compare_exchange_strong(inUse, true))
+            {
+                record = r;
+            }
+        }
+
+        if(record == nullptr)
+        {
+            record = new Record();
+            record->seen.store(Offline, std::memory_order_relaxed);
+            record->inUse.store(true, std::memory_order_relaxed);
+            record->next = records().load();
+            while(!records().compare_exchange_weak(record->next, record))
+            {
+            }
+        }
+
+        // a writer scanning the records after this either sees the thread
+        // online, or replaced its data before the thread's first read.
+        record->seen.store(epoch().load());
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    inline
+    QuiescentState::Participant::~Participant()
+    {
+        record->seen.store(Offline, std::memory_order_release);
+        record->inUse.store(false, std::memory_order_release);
+    }
+
+    inline
+    std::atomic<std::uint64_t>& QuiescentState::epoch(void)
+    {
+        static std::atomic<std::uint64_t> epoch(Offline + 1);
+        return epoch;
+    }
+
+    inline
+    std::atomic<QuiescentState::Record*>& QuiescentState::records(void)
+    {
+        static std::atomic<Record*> records(nullptr);
+        return records;
+    }
+
+    inline
+    QuiescentState::Record& QuiescentState::self(void)
+    {
+        static thread_local Participant participant;
+        return *participant.record;
+    }
+}}
@@ -2,6 +2,9 @@
 #include <wield/schedulers/utils/NumberOfThreads.hpp>
 #include <wield/schedulers/utils/ThreadAssignments.hpp>
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 namespace wield { namespace schedulers { namespace color {
@@ -12,6 +15,11 @@ namespace wield { namespace schedulers { namespace color {
     // a work queue. All threads in the system share
     // the queue.
     //
+    // A stage name dequeued while the stage is at its max concurrency is
+    // set aside for the stage rather than dropped, its message is still
+    // queued. The names set aside go back on the work queue when a thread
+    // leaves the stage.
+    //
     // Caveat: <Queue> type must be concurrent. This
     // implementation of color uses a non-blocking
     // queue and will burn cores. TODO: implement
@@ -52,11 +60,21 @@ namespace wield { namespace schedulers { namespace color {
         // get the next stage from the work queue.
         StageEnumType dequeNextStage();
 
+        // try to assign @threadId to @next, setting its name aside if the
+        // stage is full. @return true if assigned.
+        bool tryAssign(const std::size_t threadId, const StageEnumType next);
+
+        // put the names set aside for @stage back on the work queue.
+        void requeueDeferred(const StageEnumType stage);
+
     private:
         Dispatcher& dispatcher_;
         Queue& workQueue_;
 
         ThreadAssignments threadAssignments_;
+
+        // names dequeued while their stage was full, per stage.
+        std::array<std::atomic<std::size_t>, ThreadAssignments::NumberOfStages> deferred_;
     };
     
 
@@ -67,6 +85,10 @@ namespace wield { namespace schedulers { namespace color {
         , dispatcher_(dispatcher)
         , workQueue_(queue)
     {
+        for(auto& deferred : deferred_)
+        {
+            deferred.store(0, std::memory_order_relaxed);
+        }
     }
 
     template<class DispatcherType, class Queue, class PollingPolicy>
@@ -77,6 +99,10 @@ namespace wield { namespace schedulers { namespace color {
         , workQueue_(queue)
         , threadAssignments_(maxNumberOfThreads)
     {
+        for(auto& deferred : deferred_)
+        {
+            deferred.store(0, std::memory_order_relaxed);
+        }
     }
 
     template<class DispatcherType, class Queue, class PollingPolicy>
@@ -87,6 +113,10 @@ namespace wield { namespace schedulers { namespace color {
         , workQueue_(queue)
         , threadAssignments_(maxConcurrency)
     {
+        for(auto& deferred : deferred_)
+        {
+            deferred.store(0, std::memory_order_relaxed);
+        }
     }
 
     template<class DispatcherType, class Queue, class PollingPolicy>
@@ -97,6 +127,10 @@ namespace wield { namespace schedulers { namespace color {
         , workQueue_(queue)
         , threadAssignments_(maxConcurrency, maxNumberOfThreads)
     {
+        for(auto& deferred : deferred_)
+        {
+            deferred.store(0, std::memory_order_relaxed);
+        }
     }
 
     template<class DispatcherType, class Queue, class PollingPolicy>
@@ -109,15 +143,20 @@ namespace wield { namespace schedulers { namespace color {
     template<class DispatcherType, class Queue, class PollingPolicy>
     typename DispatcherType::StageType& Color<DispatcherType, Queue, PollingPolicy>::nextStage(const std::size_t threadId)
     {
-        threadAssignments_.removeCurrentAssignment(threadId);
+        const StageEnumType previous = threadAssignments_.removeCurrentAssignment(threadId);
+        if(previous != StageEnumType::NumberOfEntries)
+        {
+            requeueDeferred(previous);
+        }
 
         auto next = StageEnumType::NumberOfEntries;
 
         do {
             next = dequeNextStage();
-            const auto success = threadAssignments_.tryAssign(threadId, next);
 
-            if(!success)
+            // an empty work queue leaves next as NumberOfEntries,
+            // which is not a valid stage to assign to.
+            if(next != StageEnumType::NumberOfEntries && !tryAssign(threadId, next))
             {
                 next = StageEnumType::NumberOfEntries;
             }
@@ -129,6 +168,43 @@ namespace wield { namespace schedulers { namespace color {
         return dispatcher_[next];
     }
 
+    template<class DispatcherType, class Queue, class PollingPolicy>
+    bool Color<DispatcherType, Queue, PollingPolicy>::tryAssign(const std::size_t threadId, const StageEnumType next)
+    {
+        if(threadAssignments_.tryAssign(threadId, next))
+        {
+            return true;
+        }
+
+        std::atomic<std::size_t>& deferred = deferred_[static_cast<std::size_t>(next)];
+        deferred.fetch_add(1);
+
+        // a thread may have left the stage before the name was set aside,
+        // without seeing it: look again, and take the name back if there's
+        // room now. Otherwise the stage has a visitor, which requeues the
+        // name when it leaves.
+        if(!threadAssignments_.tryAssign(threadId, next))
+        {
+            return false;
+        }
+
+        std::size_t count = deferred.load();
+        while(count != 0 && !deferred.compare_exchange_weak(count, count - 1))
+        {
+        }
+
+        return true;
+    }
+
+    template<class DispatcherType, class Queue, class PollingPolicy>
+    void Color<DispatcherType, Queue, PollingPolicy>::requeueDeferred(const StageEnumType stage)
+    {
+        for(std::size_t count = deferred_[static_cast<std::size_t>(stage)].exchange(0); count != 0; --count)
+        {
+            workQueue_.push(stage);
+        }
+    }
+
     template<class DispatcherType, class Queue, class PollingPolicy>
     inline
     typename DispatcherType::StageEnumType Color<DispatcherType, Queue, PollingPolicy>::dequeNextStage()
@@ -21,6 +21,16 @@ namespace wield { namespace schedulers { namespace color {
         template<class ConcreteMessageType>
         void dispatch(StageEnumType stageName, ConcreteMessageType& message, CloneMessageTagType cloneTag);
 
+        // send a batch of messages to a stage, the stage name
+        // is enqueued for each message of the batch.
+        template<class Iterator>
+        void dispatchBatch(StageEnumType stageName, Iterator first, Iterator last);
+
+        // send one message to several stages, each stage
+        // name is enqueued.
+        template<class StageIterator>
+        void dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename Stage::MessageType& message);
+
     private:
         Queue& queue_;
     };
@@ -48,5 +58,33 @@ namespace wield { namespace schedulers { namespace color {
         base_t::dispatch(stageName, message, cloneTag);
         queue_.push(stageName);
     }
+
+    template<class StageEnumType, class Stage, class StageNameQueue>
+    template<class Iterator>
+    inline
+    void Dispatcher<StageEnumType, Stage, StageNameQueue>::dispatchBatch(StageEnumType stageName, Iterator first, Iterator last)
+    {
+        base_t::dispatchBatch(stageName, first, last);
+
+        // a visit processes one message, a name per message
+        // keeps the whole batch reachable.
+        for(; first != last; ++first)
+        {
+            queue_.push(stageName);
+        }
+    }
+
+    template<class StageEnumType, class Stage, class StageNameQueue>
+    template<class StageIterator>
+    inline
+    void Dispatcher<StageEnumType, Stage, StageNameQueue>::dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename Stage::MessageType& message)
+    {
+        base_t::dispatchFanout(firstStage, lastStage, message);
+
+        for(; firstStage != lastStage; ++firstStage)
+        {
+            queue_.push(*firstStage);
+        }
+    }
     
 }}}
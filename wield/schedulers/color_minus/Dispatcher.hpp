@@ -2,6 +2,8 @@
 #include <wield/DispatcherBase.hpp>
 #include <wield/schedulers/utils/MessageCount.hpp>
 
+#include <iterator>
+
 namespace wield { namespace schedulers { namespace color_minus {
 
     // This dispatcher is for use with the Color- scheduling policy.
@@ -25,6 +27,16 @@ namespace wield { namespace schedulers { namespace color_minus {
         template<class ConcreteMessageType>
         void dispatch(StageEnumType stageName, ConcreteMessageType& message, CloneMessageTagType cloneTag);
 
+        // send a batch of messages to a stage, the counter
+        // is updated once for the whole batch.
+        template<class Iterator>
+        void dispatchBatch(StageEnumType stageName, Iterator first, Iterator last);
+
+        // send one message to several stages, the counter
+        // of each stage is updated.
+        template<class StageIterator>
+        void dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename Stage::MessageType& message);
+
     private:
         MessageCount& stats_;
     };
@@ -53,4 +65,26 @@ namespace wield { namespace schedulers { namespace color_minus {
         stats_.increment(stageName);
     }
 
+    template<class StageEnumType, class Stage>
+    template<class Iterator>
+    inline
+    void Dispatcher<StageEnumType, Stage>::dispatchBatch(StageEnumType stageName, Iterator first, Iterator last)
+    {
+        base_t::dispatchBatch(stageName, first, last);
+        stats_.increment(stageName, static_cast<std::size_t>(std::distance(first, last)));
+    }
+
+    template<class StageEnumType, class Stage>
+    template<class StageIterator>
+    inline
+    void Dispatcher<StageEnumType, Stage>::dispatchFanout(StageIterator firstStage, StageIterator lastStage, typename Stage::MessageType& message)
+    {
+        base_t::dispatchFanout(firstStage, lastStage, message);
+
+        for(; firstStage != lastStage; ++firstStage)
+        {
+            stats_.increment(*firstStage);
+        }
+    }
+
 }}}
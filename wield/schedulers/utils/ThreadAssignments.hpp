@@ -3,12 +3,15 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <numeric>
 #include <vector>
 
 namespace wield { namespace schedulers { namespace utils {
 
-    template<class StageEnumType>
+    // @Allocator allocates the per-thread assignments, e.g. a
+    // memory::HugePageAllocator.
+    template<class StageEnumType, class Allocator = std::allocator<StageEnumType>>
     class ThreadAssignments
     {
     public:
@@ -55,14 +58,14 @@ namespace wield { namespace schedulers { namespace utils {
         void init();
 
     private:
-        std::vector<StageEnumType> threadAssignment_;
+        std::vector<StageEnumType, Allocator> threadAssignment_;
         std::array<std::atomic_size_t, NumberOfStages> threadsPerStage_;
         MaxConcurrencyContainer maximumConcurrency_;
     };
 
 
-    template<class StageEnumType>
-    ThreadAssignments<StageEnumType>::ThreadAssignments(const std::size_t numberOfThreads)
+    template<class StageEnumType, class Allocator>
+    ThreadAssignments<StageEnumType, Allocator>::ThreadAssignments(const std::size_t numberOfThreads)
         : threadAssignment_(numberOfThreads, StageEnumType::NumberOfEntries)
     {
         // assign every element in maximumConcurrency to 1.
@@ -74,40 +77,40 @@ namespace wield { namespace schedulers { namespace utils {
         init();
     }
 
-    template<class StageEnumType>
-    ThreadAssignments<StageEnumType>::ThreadAssignments(const MaxConcurrencyContainer& concurrency)
+    template<class StageEnumType, class Allocator>
+    ThreadAssignments<StageEnumType, Allocator>::ThreadAssignments(const MaxConcurrencyContainer& concurrency)
         : threadAssignment_(std::accumulate(begin(concurrency), end(concurrency), 0), StageEnumType::NumberOfEntries)
         , maximumConcurrency_(concurrency)
     {
         init();
     }
     
-    template<class StageEnumType>
-    ThreadAssignments<StageEnumType>::ThreadAssignments(const MaxConcurrencyContainer& concurrency, const std::size_t numberOfThreads)
+    template<class StageEnumType, class Allocator>
+    ThreadAssignments<StageEnumType, Allocator>::ThreadAssignments(const MaxConcurrencyContainer& concurrency, const std::size_t numberOfThreads)
         : threadAssignment_(numberOfThreads, StageEnumType::NumberOfEntries)
         , maximumConcurrency_(concurrency)
     {
         init();
     }
 
-    template<class StageEnumType>
-    ThreadAssignments<StageEnumType>::ThreadAssignments(MaxConcurrencyContainer&& concurrency)
+    template<class StageEnumType, class Allocator>
+    ThreadAssignments<StageEnumType, Allocator>::ThreadAssignments(MaxConcurrencyContainer&& concurrency)
         : threadAssignment_(std::accumulate(begin(concurrency), end(concurrency), 0), StageEnumType::NumberOfEntries)
         , maximumConcurrency_(std::move(concurrency))
     {
         init();
     }
 
-    template<class StageEnumType>
-    ThreadAssignments<StageEnumType>::ThreadAssignments(MaxConcurrencyContainer&& concurrency, const std::size_t numberOfThreads)
+    template<class StageEnumType, class Allocator>
+    ThreadAssignments<StageEnumType, Allocator>::ThreadAssignments(MaxConcurrencyContainer&& concurrency, const std::size_t numberOfThreads)
         : threadAssignment_(numberOfThreads, StageEnumType::NumberOfEntries)
         , maximumConcurrency_(std::move(concurrency))
     {
         init();
     }
 
-    template<class StageEnumType>
-    void ThreadAssignments<StageEnumType>::init()
+    template<class StageEnumType, class Allocator>
+    void ThreadAssignments<StageEnumType, Allocator>::init()
     {
 		for(auto& t : threadsPerStage_)
 		{
@@ -115,14 +118,14 @@ namespace wield { namespace schedulers { namespace utils {
 		}
     }
 
-    template<class StageEnumType>
-    StageEnumType ThreadAssignments<StageEnumType>::currentAssignment(const std::size_t threadId)
+    template<class StageEnumType, class Allocator>
+    StageEnumType ThreadAssignments<StageEnumType, Allocator>::currentAssignment(const std::size_t threadId)
     {
         return threadAssignment_[threadId];
     }
 
-    template<class StageEnumType>
-    StageEnumType ThreadAssignments<StageEnumType>::removeCurrentAssignment(const std::size_t threadId)
+    template<class StageEnumType, class Allocator>
+    StageEnumType ThreadAssignments<StageEnumType, Allocator>::removeCurrentAssignment(const std::size_t threadId)
     {
         const auto currentAssignment = threadAssignment_[threadId];
 
@@ -136,8 +139,8 @@ namespace wield { namespace schedulers { namespace utils {
         return currentAssignment;
     }
 
-    template<class StageEnumType>
-    bool ThreadAssignments<StageEnumType>::tryAssign(const std::size_t threadId, StageEnumType next)
+    template<class StageEnumType, class Allocator>
+    bool ThreadAssignments<StageEnumType, Allocator>::tryAssign(const std::size_t threadId, StageEnumType next)
     {
         const std::size_t nextIndex = static_cast<std::size_t>(next);
 
@@ -0,0 +1,65 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace wield { namespace serialization {
+
+    // A serialized message is an <Envelope> followed by the payload the
+    // message wrote with serializeInto(). The envelope is 8 bytes, so a
+    // payload written to an 8 byte aligned buffer stays 8 byte aligned and
+    // can be read in place.
+    struct Envelope
+    {
+        std::uint32_t typeId;
+        std::uint32_t length;
+    };
+
+    static_assert(sizeof(Envelope) == 8, "Envelope must be packed, it's a wire format.");
+
+    // write @message, envelope and payload, into @buffer.
+    // @return the number of bytes written.
+    // @throw MessageNotSerializable, MessageTooLargeForBuffer
+    template<class Message>
+    std::size_t serialize(const Message& message, char* buffer, const std::size_t capacity)
+    {
+        const std::uint32_t typeId = message.typeId();
+        if(typeId == 0)
+        {
+            throw MessageNotSerializable();
+        }
+
+        if(capacity < sizeof(Envelope))
+        {
+            throw MessageTooLargeForBuffer();
+        }
+
+        const std::size_t length = message.serializeInto(buffer + sizeof(Envelope), capacity - sizeof(Envelope));
+
+        const Envelope envelope{ typeId, static_cast<std::uint32_t>(length) };
+        std::memcpy(buffer, &envelope, sizeof(envelope));
+
+        return sizeof(Envelope) + length;
+    }
+
+    // read the envelope at the front of @data.
+    // @return false if @length is too short to hold it and its payload.
+    inline bool peek(const char* data, const std::size_t length, Envelope& envelope)
+    {
+        if(length < sizeof(Envelope))
+        {
+            return false;
+        }
+
+        std::memcpy(&envelope, data, sizeof(envelope));
+        return envelope.length <= length - sizeof(Envelope);
+    }
+
+    // @return the payload following the envelope at @data.
+    inline const char* payloadOf(const char* data)
+    {
+        return data + sizeof(Envelope);
+    }
+}}
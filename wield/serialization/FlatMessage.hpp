@@ -0,0 +1,101 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/serialization/Envelope.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace wield { namespace serialization {
+
+    // <FlatMessage> implements the serialization of a message whose state
+    // is a single plain old data @Payload: serializing it is a memcpy, and
+    // a receiver can read the payload straight out of the buffer with
+    // view() without creating a message at all.
+    //
+    //      struct QuotePayload { std::uint64_t price; std::uint32_t size; };
+    //
+    //      class Quote : public FlatMessage<Quote, MyMessageBase, QuotePayload, 7>
+    //      {
+    //      public:
+    //          using FlatMessage::FlatMessage;
+    //          void processWith(MyProcessingFunctor& process) override { process(*this); }
+    //      };
+    //
+    // @Derived must be constructible from a const Payload&. @Id is the
+    // message's type id in a MessageRegistry, it must not be 0.
+    template<class Derived, class Base, class Payload, std::uint32_t Id>
+    class FlatMessage : public Base
+    {
+    public:
+        static_assert(std::is_pod<Payload>::value, "FlatMessage payloads are copied as bytes, they must be plain old data.");
+        static_assert(Id != 0, "type id 0 is reserved for messages which can't be serialized.");
+
+        using PayloadType = Payload;
+        static const std::uint32_t TypeId = Id;
+
+        FlatMessage(const Payload& payload)
+            : payload_(payload)
+        {
+        }
+
+        const Payload& payload(void) const { return payload_; }
+        Payload& payload(void) { return payload_; }
+
+        std::uint32_t typeId() const override { return Id; }
+        std::size_t serializeInto(char* buffer, const std::size_t capacity) const override;
+
+        // @return a new message read from the payload bytes at @data.
+        // @throw MessageTooLargeForBuffer if @length is short of a payload.
+        static typename Base::ptr deserialize(const char* data, const std::size_t length);
+
+        // @return the payload at @data in place, or nullptr if @length is
+        // short of a payload or @data isn't aligned for one.
+        static const Payload* view(const char* data, const std::size_t length);
+
+    private:
+        Payload payload_;
+    };
+
+
+    template<class Derived, class Base, class Payload, std::uint32_t Id>
+    const std::uint32_t FlatMessage<Derived, Base, Payload, Id>::TypeId;
+
+    template<class Derived, class Base, class Payload, std::uint32_t Id>
+    std::size_t FlatMessage<Derived, Base, Payload, Id>::serializeInto(char* buffer, const std::size_t capacity) const
+    {
+        if(capacity < sizeof(Payload))
+        {
+            throw MessageTooLargeForBuffer();
+        }
+
+        std::memcpy(buffer, &payload_, sizeof(Payload));
+        return sizeof(Payload);
+    }
+
+    template<class Derived, class Base, class Payload, std::uint32_t Id>
+    typename Base::ptr FlatMessage<Derived, Base, Payload, Id>::deserialize(const char* data, const std::size_t length)
+    {
+        if(length < sizeof(Payload))
+        {
+            throw MessageTooLargeForBuffer();
+        }
+
+        Payload payload;
+        std::memcpy(&payload, data, sizeof(Payload));
+
+        return new Derived(payload);
+    }
+
+    template<class Derived, class Base, class Payload, std::uint32_t Id>
+    const Payload* FlatMessage<Derived, Base, Payload, Id>::view(const char* data, const std::size_t length)
+    {
+        if(length < sizeof(Payload) || reinterpret_cast<std::uintptr_t>(data) % alignof(Payload) != 0)
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<const Payload*>(data);
+    }
+}}
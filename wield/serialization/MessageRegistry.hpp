@@ -0,0 +1,161 @@
+#pragma once
+#include <wield/Exceptions.hpp>
+#include <wield/serialization/Envelope.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace wield { namespace serialization {
+
+    // <MessageRegistry> maps the type ids of serialized messages back to
+    // the concrete message classes, so a receiver can turn bytes into the
+    // right message without knowing in advance what was sent.
+    //
+    // Each type id is registered with a factory:
+    //      Message::ptr factory(const char* payload, std::size_t length);
+    // returning a new message read from the payload. FlatMessage provides
+    // one, other messages supply their own.
+    //
+    // Factories are kept in a table indexed by type id, so ids should be
+    // small and dense. Register every type before the pipeline starts,
+    // after that the registry is only read and any thread may use it.
+    template<class Message>
+    class MessageRegistry
+    {
+    public:
+        using MessagePtr = typename Message::ptr;
+        using Factory = MessagePtr (*)(const char* payload, std::size_t length);
+
+        static const std::uint32_t MaxTypeId = 0xffff;
+
+        // register @ConcreteMessage (a FlatMessage, or anything with its
+        // TypeId and static deserialize) under its own type id.
+        template<class ConcreteMessage>
+        MessageRegistry& add(void);
+
+        // @throw DuplicateMessageTypeRegistration if @typeId is taken.
+        MessageRegistry& add(const std::uint32_t typeId, Factory factory);
+
+        bool contains(const std::uint32_t typeId) const;
+
+        // write @message, envelope and payload, into @buffer.
+        // @return the number of bytes written.
+        std::size_t serialize(const Message& message, char* buffer, const std::size_t capacity) const;
+
+        // @return a new message read from the envelope and payload at @data.
+        // @throw UnknownMessageType, MessageTooLargeForBuffer if @data is truncated.
+        MessagePtr deserialize(const char* data, const std::size_t length) const;
+
+        // read a @ConcreteMessage's payload in place, without creating a message.
+        // @return nullptr if @data holds another type of message, or can't be
+        // read in place (see FlatMessage::view).
+        template<class ConcreteMessage>
+        static const typename ConcreteMessage::PayloadType* view(const char* data, const std::size_t length);
+
+    private:
+        std::vector<Factory> factories_;
+    };
+
+    // <RegistryCodec> is the Codec of the io::SharedMemory queues for
+    // messages serialized through a registry. It refers to @registry,
+    // which must outlive it.
+    template<class Message>
+    class RegistryCodec
+    {
+    public:
+        RegistryCodec(const MessageRegistry<Message>& registry)
+            : registry_(&registry)
+        {
+        }
+
+        std::size_t serialize(const Message& message, char* buffer, const std::size_t capacity) const
+        {
+            return registry_->serialize(message, buffer, capacity);
+        }
+
+        typename Message::ptr deserialize(const char* data, const std::size_t length) const
+        {
+            return registry_->deserialize(data, length);
+        }
+
+    private:
+        const MessageRegistry<Message>* registry_;
+    };
+
+
+    template<class Message>
+    const std::uint32_t MessageRegistry<Message>::MaxTypeId;
+
+    template<class Message>
+    template<class ConcreteMessage>
+    MessageRegistry<Message>& MessageRegistry<Message>::add(void)
+    {
+        return add(ConcreteMessage::TypeId, &ConcreteMessage::deserialize);
+    }
+
+    template<class Message>
+    MessageRegistry<Message>& MessageRegistry<Message>::add(const std::uint32_t typeId, Factory factory)
+    {
+        if(typeId == 0 || typeId > MaxTypeId || factory == nullptr)
+        {
+            throw std::invalid_argument("MessageRegistry::add() needs a factory and a type id in [1, MaxTypeId].");
+        }
+
+        if(contains(typeId))
+        {
+            throw DuplicateMessageTypeRegistration();
+        }
+
+        if(typeId >= factories_.size())
+        {
+            factories_.resize(typeId + 1, nullptr);
+        }
+
+        factories_[typeId] = factory;
+        return *this;
+    }
+
+    template<class Message>
+    bool MessageRegistry<Message>::contains(const std::uint32_t typeId) const
+    {
+        return typeId < factories_.size() && factories_[typeId] != nullptr;
+    }
+
+    template<class Message>
+    std::size_t MessageRegistry<Message>::serialize(const Message& message, char* buffer, const std::size_t capacity) const
+    {
+        return serialization::serialize(message, buffer, capacity);
+    }
+
+    template<class Message>
+    typename MessageRegistry<Message>::MessagePtr MessageRegistry<Message>::deserialize(const char* data, const std::size_t length) const
+    {
+        Envelope envelope;
+        if(!peek(data, length, envelope))
+        {
+            throw MessageTooLargeForBuffer();
+        }
+
+        if(!contains(envelope.typeId))
+        {
+            throw UnknownMessageType();
+        }
+
+        return factories_[envelope.typeId](payloadOf(data), envelope.length);
+    }
+
+    template<class Message>
+    template<class ConcreteMessage>
+    const typename ConcreteMessage::PayloadType* MessageRegistry<Message>::view(const char* data, const std::size_t length)
+    {
+        Envelope envelope;
+        if(!peek(data, length, envelope) || envelope.typeId != ConcreteMessage::TypeId)
+        {
+            return nullptr;
+        }
+
+        return ConcreteMessage::view(payloadOf(data), envelope.length);
+    }
+}}
@@ -0,0 +1,108 @@
+#pragma once
+#include <wield/simulation/Stage.hpp>
+#include <wield/schedulers/utils/MessageCount.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace wield { namespace simulation {
+
+    // the default DispatchHook, the scheduling policy needs nothing
+    // from the dispatcher beyond stage lookup.
+    struct NoDispatchHook
+    {
+        template<typename StageEnum>
+        void dispatched(const StageEnum) {}
+    };
+
+    // Enqueue the name of the stage on every dispatch, the simulated
+    // counterpart of color::Dispatcher. Use with simulation::StageNameQueue.
+    template<class StageNameQueue>
+    class StageNameQueueHook
+    {
+    public:
+        StageNameQueueHook(StageNameQueue& queue) : queue_(queue) {}
+
+        template<typename StageEnum>
+        void dispatched(const StageEnum stage) { queue_.push(stage); }
+
+    private:
+        StageNameQueue& queue_;
+    };
+
+    // Count every dispatch, the simulated counterpart of color_minus::Dispatcher.
+    template<typename StageEnum>
+    class MessageCountHook
+    {
+    public:
+        using MessageCount = schedulers::utils::MessageCount<StageEnum>;
+
+        MessageCountHook(MessageCount& stats) : stats_(stats) {}
+
+        void dispatched(const StageEnum stage) { stats_.increment(stage); }
+
+    private:
+        MessageCount& stats_;
+    };
+
+    // The dispatcher given to a scheduling policy under simulation. It owns
+    // one simulated Stage per StageEnum entry. @DispatchHook is told about
+    // every message the simulator dispatches, which is how policies that
+    // rely on a specialized dispatcher (Color, Color-) see the traffic.
+    template<typename StageEnum, class DispatchHook = NoDispatchHook>
+    class Dispatcher
+    {
+    public:
+        static_assert(std::is_enum<StageEnum>::value, "StageEnum parameter is not an enum type.");
+
+        using StageEnumType = StageEnum;
+        using StageType = Stage<StageEnum>;
+        static const std::size_t NumberOfStages = static_cast<std::size_t>(StageEnum::NumberOfEntries);
+
+        template<typename... Args>
+        Dispatcher(Args&&... args);
+
+        // Stage lookup function, as DispatcherBase::operator[].
+        StageType& operator[](const StageEnumType stageName);
+
+        // called by the simulator when a message is queued on @stageName.
+        void dispatched(const StageEnumType stageName);
+
+    private:
+        Dispatcher(const Dispatcher&) = delete;
+        Dispatcher& operator=(const Dispatcher&) = delete;
+
+    private:
+        std::array<std::unique_ptr<StageType>, NumberOfStages> stages_;
+        DispatchHook hook_;
+    };
+
+
+    template<typename StageEnum, class DispatchHook>
+    template<typename... Args>
+    Dispatcher<StageEnum, DispatchHook>::Dispatcher(Args&&... args)
+        : hook_(std::forward<Args>(args)...)
+    {
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            stages_[s].reset(new StageType(static_cast<StageEnum>(s)));
+        }
+    }
+
+    template<typename StageEnum, class DispatchHook>
+    inline
+    typename Dispatcher<StageEnum, DispatchHook>::StageType& Dispatcher<StageEnum, DispatchHook>::operator[](const StageEnumType stageName)
+    {
+        return *stages_[static_cast<std::size_t>(stageName)];
+    }
+
+    template<typename StageEnum, class DispatchHook>
+    inline
+    void Dispatcher<StageEnum, DispatchHook>::dispatched(const StageEnumType stageName)
+    {
+        hook_.dispatched(stageName);
+    }
+}}
@@ -0,0 +1,121 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+namespace wield { namespace simulation {
+
+    // virtual time and durations in the simulation.
+    using Duration = std::chrono::nanoseconds;
+
+    // the random engine the simulator draws every sample from, seeded
+    // from Configuration::seed so a run is reproducible.
+    using Engine = std::mt19937_64;
+
+    // A distribution of durations, used for stage service times and
+    // for the gaps between arrivals of an arrival process.
+    class Distribution
+    {
+    public:
+        // always @value.
+        static Distribution constant(const Duration value);
+
+        // exponentially distributed with mean @mean.
+        static Distribution exponential(const Duration mean);
+
+        // uniformly distributed on [@min, @max].
+        static Distribution uniform(const Duration min, const Duration max);
+
+        // gaps between arrivals at @ratePerSecond, evenly spaced.
+        static Distribution constantRate(const double ratePerSecond);
+
+        // gaps between arrivals at @ratePerSecond, a Poisson process.
+        static Distribution poisson(const double ratePerSecond);
+
+        Duration sample(Engine& engine) const;
+        Duration mean() const;
+
+    private:
+        enum class Kind
+        {
+            Constant,
+            Exponential,
+            Uniform
+        };
+
+        Distribution(const Kind kind, const double a, const double b);
+
+    private:
+        Kind kind_;
+        double a_;      // constant: value, exponential: mean, uniform: min (nanoseconds)
+        double b_;      // uniform: max (nanoseconds)
+    };
+
+
+    inline
+    Distribution::Distribution(const Kind kind, const double a, const double b)
+        : kind_(kind)
+        , a_(a)
+        , b_(b)
+    {
+    }
+
+    inline
+    Distribution Distribution::constant(const Duration value)
+    {
+        return Distribution(Kind::Constant, static_cast<double>(value.count()), 0);
+    }
+
+    inline
+    Distribution Distribution::exponential(const Duration mean)
+    {
+        return Distribution(Kind::Exponential, static_cast<double>(mean.count()), 0);
+    }
+
+    inline
+    Distribution Distribution::uniform(const Duration min, const Duration max)
+    {
+        return Distribution(Kind::Uniform, static_cast<double>(min.count()), static_cast<double>(max.count()));
+    }
+
+    inline
+    Distribution Distribution::constantRate(const double ratePerSecond)
+    {
+        return Distribution(Kind::Constant, 1e9 / ratePerSecond, 0);
+    }
+
+    inline
+    Distribution Distribution::poisson(const double ratePerSecond)
+    {
+        return Distribution(Kind::Exponential, 1e9 / ratePerSecond, 0);
+    }
+
+    inline
+    Duration Distribution::sample(Engine& engine) const
+    {
+        double nanoseconds = a_;
+
+        switch(kind_)
+        {
+        case Kind::Exponential:
+            nanoseconds = a_ > 0 ? std::exponential_distribution<double>(1.0 / a_)(engine) : 0;
+            break;
+
+        case Kind::Uniform:
+            nanoseconds = std::uniform_real_distribution<double>(a_, b_)(engine);
+            break;
+
+        case Kind::Constant:
+            break;
+        }
+
+        return Duration(static_cast<Duration::rep>(nanoseconds + 0.5));
+    }
+
+    inline
+    Duration Distribution::mean() const
+    {
+        const double nanoseconds = kind_ == Kind::Uniform ? (a_ + b_) / 2 : a_;
+        return Duration(static_cast<Duration::rep>(nanoseconds + 0.5));
+    }
+}}
@@ -0,0 +1,102 @@
+#pragma once
+#include <wield/simulation/Distribution.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace wield { namespace simulation {
+
+    // The outcome of a simulation run, all times are virtual.
+    struct Report
+    {
+        struct StageReport
+        {
+            std::uint64_t processed;    // messages serviced by the stage
+            std::size_t maxDepth;       // deepest the stage's queue got
+            std::size_t finalDepth;     // queue depth when the run ended
+            Duration busy;              // time spent servicing messages
+        };
+
+        struct DepthSample
+        {
+            Duration time;
+            std::vector<std::size_t> depths;    // indexed by stage
+        };
+
+        Duration duration;
+
+        std::uint64_t arrivals;     // messages entering the graph
+        std::uint64_t departures;   // messages leaving the graph
+        double throughput;          // departures per (virtual) second
+
+        // latency from arrival to departure.
+        Duration p50;
+        Duration p90;
+        Duration p99;
+        Duration p999;
+        Duration max;
+
+        std::vector<StageReport> stages;        // indexed by stage
+        std::vector<double> coreUtilization;    // fraction of the run spent servicing messages, indexed by core
+
+        // queue depths every Configuration::sampleInterval.
+        std::vector<DepthSample> queueDepths;
+    };
+
+    // write @report's totals as a single JSON object.
+    inline
+    void writeSummary(std::ostream& os, const Report& report)
+    {
+        os << "{\"duration_ns\":" << report.duration.count()
+           << ",\"arrivals\":" << report.arrivals
+           << ",\"departures\":" << report.departures
+           << ",\"throughput\":" << report.throughput
+           << ",\"p50_ns\":" << report.p50.count()
+           << ",\"p90_ns\":" << report.p90.count()
+           << ",\"p99_ns\":" << report.p99.count()
+           << ",\"p999_ns\":" << report.p999.count()
+           << ",\"max_ns\":" << report.max.count()
+           << ",\"stages\":[";
+
+        for(std::size_t s = 0; s < report.stages.size(); ++s)
+        {
+            const auto& stage = report.stages[s];
+            os << (s == 0 ? "" : ",")
+               << "{\"processed\":" << stage.processed
+               << ",\"max_depth\":" << stage.maxDepth
+               << ",\"final_depth\":" << stage.finalDepth
+               << ",\"busy_ns\":" << stage.busy.count() << "}";
+        }
+
+        os << "],\"core_utilization\":[";
+        for(std::size_t c = 0; c < report.coreUtilization.size(); ++c)
+        {
+            os << (c == 0 ? "" : ",") << report.coreUtilization[c];
+        }
+        os << "]}" << std::endl;
+    }
+
+    // write @report's queue depth trace as CSV, one row per sample.
+    inline
+    void writeQueueDepthTrace(std::ostream& os, const Report& report)
+    {
+        os << "time_ns";
+        for(std::size_t s = 0; s < report.stages.size(); ++s)
+        {
+            os << ",stage" << s;
+        }
+        os << std::endl;
+
+        for(const auto& sample : report.queueDepths)
+        {
+            os << sample.time.count();
+            for(const auto depth : sample.depths)
+            {
+                os << ',' << depth;
+            }
+            os << std::endl;
+        }
+    }
+}}
@@ -0,0 +1,432 @@
+#pragma once
+#include <wield/simulation/Distribution.hpp>
+#include <wield/simulation/Report.hpp>
+#include <wield/simulation/Stage.hpp>
+#include <wield/simulation/StageGraph.hpp>
+#include <wield/simulation/StageNameQueue.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace wield { namespace simulation {
+
+    struct Configuration
+    {
+        Configuration();
+
+        // number of simulated cores (scheduler threads). The scheduling
+        // policy must have been constructed for at least this many threads.
+        std::size_t cores;
+
+        // virtual time charged for polling an empty queue, and for each
+        // call to nextStage().
+        Duration pollCost;
+        Duration scheduleCost;
+
+        // how often queue depths are recorded, 0 disables the trace.
+        Duration sampleInterval;
+
+        std::uint64_t seed;
+    };
+
+    // <Simulator> runs an unmodified scheduling policy against simulated
+    // cores in virtual time. Each simulated core follows the loop of
+    // SchedulerBase::process(): ask the policy for nextStage(), then poll
+    // the stage's queue, servicing a message per poll, for as long as
+    // continueProcessing() says so, calling batchStart()/batchEnd() around
+    // the visit. Servicing a message takes a service time drawn from the
+    // StageGraph, during which the core is busy; the message is then
+    // dispatched along the graph's edges.
+    //
+    // The @SchedulingPolicy must be instantiated with a simulation::Dispatcher,
+    // e.g.
+    //     using Dispatcher = simulation::Dispatcher<Stages>;
+    //     using Policy = schedulers::RoundRobin<Dispatcher, ExhaustivePollingPolicy<Stages>>;
+    //
+    // Cores with nothing to do are parked until the next message arrives
+    // rather than simulating every empty poll. A run is deterministic for
+    // a given Configuration::seed, as long as the policy is (RandomVisit
+    // draws from std::random_device).
+    //
+    // CAVEAT: a policy whose nextStage() waits for a stage another thread
+    // is visiting can wait forever, since nothing else happens in the
+    // simulation until nextStage() returns. Color- does so with more than
+    // one core. Color doesn't: it sets aside the names of stages at their
+    // max concurrency, and once simulation::StageNameQueue runs out of
+    // names the core is parked.
+    template<class SchedulingPolicy>
+    class Simulator
+    {
+    public:
+        using Dispatcher = typename SchedulingPolicy::Dispatcher;
+        using StageEnumType = typename Dispatcher::StageEnumType;
+        using StageType = typename Dispatcher::StageType;
+        using PollingInformation = typename SchedulingPolicy::PollingInformation;
+
+        Simulator(Dispatcher& dispatcher, SchedulingPolicy& schedulingPolicy, const StageGraph<StageEnumType>& graph, const Configuration& configuration = Configuration());
+
+        // simulate @duration of virtual time, call once per Simulator.
+        Report run(const Duration duration);
+
+    private:
+        Simulator(const Simulator&) = delete;
+        Simulator& operator=(const Simulator&) = delete;
+
+        enum class EventType
+        {
+            Arrival,            // index is the stage
+            CoreReady,          // index is the core, which needs a stage
+            Poll,               // index is the core
+            ServiceComplete,    // index is the core
+            Sample
+        };
+
+        struct Event
+        {
+            Duration time;
+            std::uint64_t sequence;     // breaks ties in scheduling order
+            EventType type;
+            std::size_t index;
+        };
+
+        struct Later
+        {
+            bool operator()(const Event& lhs, const Event& rhs) const
+            {
+                return lhs.time > rhs.time || (lhs.time == rhs.time && lhs.sequence > rhs.sequence);
+            }
+        };
+
+        struct Core
+        {
+            StageType* stage;
+            std::unique_ptr<PollingInformation> polling;
+            Job job;
+            Duration serviceStart;
+            Duration busy;
+            bool parked;
+        };
+
+        void schedule(const Duration time, const EventType type, const std::size_t index);
+
+        void arrival(const std::size_t stage);
+        void coreReady(const std::size_t core);
+        void poll(const std::size_t core);
+        void serviceComplete(const std::size_t core);
+        void sample();
+
+        // queue @job on @stage and wake any parked cores.
+        void dispatch(const StageEnumType stage, const Job& job);
+
+        // the core finished with a message (or found none), after @delay
+        // either poll again or end the batch.
+        void continueOrEndBatch(const std::size_t core, const Duration delay);
+
+        Report report() const;
+
+    private:
+        static const std::size_t NumberOfStages = static_cast<std::size_t>(StageEnumType::NumberOfEntries);
+
+        Dispatcher& dispatcher_;
+        SchedulingPolicy& schedulingPolicy_;
+        const StageGraph<StageEnumType>& graph_;
+        const Configuration configuration_;
+
+        Engine engine_;
+        std::priority_queue<Event, std::vector<Event>, Later> events_;
+        std::uint64_t sequence_;
+        Duration now_;
+        Duration duration_;
+
+        std::vector<Core> cores_;
+        std::size_t queued_;            // messages queued over all stages
+        std::uint64_t nextJobId_;
+
+        std::uint64_t arrivals_;
+        std::vector<Duration::rep> latencies_;
+        std::vector<Report::StageReport> stages_;
+        std::vector<Report::DepthSample> queueDepths_;
+    };
+
+
+    inline
+    Configuration::Configuration()
+        : cores(1)
+        , pollCost(50)
+        , scheduleCost(100)
+        , sampleInterval(0)
+        , seed(1)
+    {
+    }
+
+    template<class SchedulingPolicy>
+    Simulator<SchedulingPolicy>::Simulator(Dispatcher& dispatcher, SchedulingPolicy& schedulingPolicy, const StageGraph<StageEnumType>& graph, const Configuration& configuration)
+        : dispatcher_(dispatcher)
+        , schedulingPolicy_(schedulingPolicy)
+        , graph_(graph)
+        , configuration_(configuration)
+        , engine_(configuration.seed)
+        , sequence_(0)
+        , now_(0)
+        , duration_(0)
+        , cores_(configuration.cores)
+        , queued_(0)
+        , nextJobId_(0)
+        , arrivals_(0)
+        , stages_(NumberOfStages)
+    {
+        for(auto& core : cores_)
+        {
+            core.stage = nullptr;
+            core.busy = Duration(0);
+            core.parked = true;     // until the first message arrives.
+        }
+
+        for(auto& stage : stages_)
+        {
+            stage.processed = 0;
+            stage.maxDepth = 0;
+            stage.finalDepth = 0;
+            stage.busy = Duration(0);
+        }
+    }
+
+    template<class SchedulingPolicy>
+    Report Simulator<SchedulingPolicy>::run(const Duration duration)
+    {
+        duration_ = duration;
+
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            const auto& model = graph_[static_cast<StageEnumType>(s)];
+            if(model.hasArrivals)
+            {
+                schedule(model.interarrivalTime.sample(engine_), EventType::Arrival, s);
+            }
+        }
+
+        if(configuration_.sampleInterval.count() > 0)
+        {
+            schedule(Duration(0), EventType::Sample, 0);
+        }
+
+        while(!events_.empty() && events_.top().time <= duration_)
+        {
+            const Event event = events_.top();
+            events_.pop();
+            now_ = event.time;
+
+            switch(event.type)
+            {
+            case EventType::Arrival:            arrival(event.index); break;
+            case EventType::CoreReady:          coreReady(event.index); break;
+            case EventType::Poll:               poll(event.index); break;
+            case EventType::ServiceComplete:    serviceComplete(event.index); break;
+            case EventType::Sample:             sample(); break;
+            }
+        }
+
+        now_ = duration_;
+        return report();
+    }
+
+    template<class SchedulingPolicy>
+    inline
+    void Simulator<SchedulingPolicy>::schedule(const Duration time, const EventType type, const std::size_t index)
+    {
+        events_.push(Event{ time, sequence_++, type, index });
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::arrival(const std::size_t stage)
+    {
+        arrivals_++;
+        dispatch(static_cast<StageEnumType>(stage), Job{ nextJobId_++, now_ });
+
+        // never schedule the next arrival at the same instant, a zero
+        // gap would stop virtual time advancing.
+        const Duration gap = std::max(Duration(1), graph_[static_cast<StageEnumType>(stage)].interarrivalTime.sample(engine_));
+        schedule(now_ + gap, EventType::Arrival, stage);
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::coreReady(const std::size_t c)
+    {
+        Core& core = cores_[c];
+
+        try
+        {
+            core.stage = &schedulingPolicy_.nextStage(c);
+        }
+        catch(const details::NoWork&)
+        {
+            core.stage = nullptr;
+            core.parked = true;
+            return;
+        }
+
+        core.polling.reset(new PollingInformation(c, core.stage->name()));
+        schedulingPolicy_.batchStart(*core.polling);
+
+        schedule(now_ + configuration_.scheduleCost, EventType::Poll, c);
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::poll(const std::size_t c)
+    {
+        Core& core = cores_[c];
+        auto& queue = core.stage->queue_;
+
+        if(queue.empty())
+        {
+            core.polling->incrementMessageCount(false);
+            continueOrEndBatch(c, configuration_.pollCost);
+            return;
+        }
+
+        core.job = queue.front();
+        queue.pop_front();
+        queued_--;
+
+        core.polling->incrementMessageCount(true);
+
+        core.serviceStart = now_;
+        schedule(now_ + graph_[core.stage->name()].serviceTime.sample(engine_), EventType::ServiceComplete, c);
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::serviceComplete(const std::size_t c)
+    {
+        Core& core = cores_[c];
+        const StageEnumType stageName = core.stage->name();
+
+        const Duration service = now_ - core.serviceStart;
+        core.busy += service;
+
+        auto& stage = stages_[static_cast<std::size_t>(stageName)];
+        stage.processed++;
+        stage.busy += service;
+
+        bool departed = true;
+        for(const auto& edge : graph_[stageName].edges)
+        {
+            if(edge.probability >= 1.0 || std::uniform_real_distribution<double>(0, 1)(engine_) < edge.probability)
+            {
+                dispatch(edge.to, core.job);
+                departed = false;
+            }
+        }
+
+        if(departed)
+        {
+            latencies_.push_back((now_ - core.job.injected).count());
+        }
+
+        continueOrEndBatch(c, Duration(0));
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::sample()
+    {
+        Report::DepthSample depthSample;
+        depthSample.time = now_;
+
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            depthSample.depths.push_back(dispatcher_[static_cast<StageEnumType>(s)].unsafe_size());
+        }
+
+        queueDepths_.push_back(std::move(depthSample));
+        schedule(now_ + configuration_.sampleInterval, EventType::Sample, 0);
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::dispatch(const StageEnumType stageName, const Job& job)
+    {
+        StageType& stage = dispatcher_[stageName];
+        stage.queue_.push_back(job);
+        queued_++;
+
+        auto& stageReport = stages_[static_cast<std::size_t>(stageName)];
+        stageReport.maxDepth = std::max(stageReport.maxDepth, stage.queue_.size());
+
+        dispatcher_.dispatched(stageName);
+
+        for(std::size_t c = 0; c < cores_.size(); ++c)
+        {
+            if(cores_[c].parked)
+            {
+                cores_[c].parked = false;
+                schedule(now_, EventType::CoreReady, c);
+            }
+        }
+    }
+
+    template<class SchedulingPolicy>
+    void Simulator<SchedulingPolicy>::continueOrEndBatch(const std::size_t c, const Duration delay)
+    {
+        Core& core = cores_[c];
+
+        if(schedulingPolicy_.continueProcessing(*core.polling))
+        {
+            schedule(now_ + delay, EventType::Poll, c);
+            return;
+        }
+
+        schedulingPolicy_.batchEnd(*core.polling);
+        core.polling.reset();
+
+        if(queued_ == 0)
+        {
+            core.parked = true;
+        }
+        else
+        {
+            schedule(now_ + delay, EventType::CoreReady, c);
+        }
+    }
+
+    template<class SchedulingPolicy>
+    Report Simulator<SchedulingPolicy>::report() const
+    {
+        Report report;
+        report.duration = duration_;
+        report.arrivals = arrivals_;
+        report.departures = latencies_.size();
+
+        const double seconds = duration_.count() / 1e9;
+        report.throughput = seconds > 0 ? report.departures / seconds : 0;
+
+        std::vector<Duration::rep> sorted(latencies_);
+        std::sort(begin(sorted), end(sorted));
+
+        auto percentile = [&sorted](const double p)
+        {
+            return sorted.empty() ? Duration(0) : Duration(sorted[std::min(static_cast<std::size_t>(p * sorted.size()), sorted.size() - 1)]);
+        };
+
+        report.p50 = percentile(0.50);
+        report.p90 = percentile(0.90);
+        report.p99 = percentile(0.99);
+        report.p999 = percentile(0.999);
+        report.max = sorted.empty() ? Duration(0) : Duration(sorted.back());
+
+        report.stages = stages_;
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            report.stages[s].finalDepth = dispatcher_[static_cast<StageEnumType>(s)].unsafe_size();
+        }
+
+        for(const auto& core : cores_)
+        {
+            report.coreUtilization.push_back(duration_.count() > 0 ? static_cast<double>(core.busy.count()) / duration_.count() : 0);
+        }
+
+        report.queueDepths = queueDepths_;
+        return report;
+    }
+}}
@@ -0,0 +1,51 @@
+#pragma once
+#include <wield/simulation/Distribution.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace wield { namespace simulation {
+
+    template<class SchedulingPolicy>
+    class Simulator;
+
+    // a simulated message, all the simulator needs to know is when
+    // it entered the graph.
+    struct Job
+    {
+        std::uint64_t id;
+        Duration injected;
+    };
+
+    // The simulated counterpart of StageBase, handed to the scheduling
+    // policy through simulation::Dispatcher::operator[]. The simulator
+    // does the work of StageBase::process() itself so it can advance
+    // virtual time for each message.
+    template<typename StageEnum>
+    class Stage
+    {
+    public:
+        using StageEnumType = StageEnum;
+
+        Stage(const StageEnum stageName)
+            : stageName_(stageName)
+        {
+        }
+
+        StageEnum name(void) const { return stageName_; }
+
+        std::size_t unsafe_size(void) const { return queue_.size(); }
+
+    private:
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+        template<class SchedulingPolicy>
+        friend class Simulator;
+
+    private:
+        const StageEnum stageName_;
+        std::deque<Job> queue_;
+    };
+}}
@@ -0,0 +1,104 @@
+#pragma once
+#include <wield/simulation/Distribution.hpp>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace wield { namespace simulation {
+
+    // A model of a stage graph for the simulator: how long each stage
+    // takes to process a message, where it sends it next and where
+    // messages enter the graph.
+    //
+    // By default a stage takes no time, has no outgoing edges and no
+    // arrivals. A message leaves the graph (and its latency is recorded)
+    // when its stage takes none of its outgoing edges.
+    template<typename StageEnum>
+    class StageGraph
+    {
+    public:
+        static_assert(std::is_enum<StageEnum>::value, "StageEnum parameter is not an enum type.");
+
+        using StageEnumType = StageEnum;
+        static const std::size_t NumberOfStages = static_cast<std::size_t>(StageEnum::NumberOfEntries);
+
+        struct Edge
+        {
+            StageEnum to;
+            double probability;
+        };
+
+        struct StageModel
+        {
+            StageModel();
+
+            Distribution serviceTime;
+            std::vector<Edge> edges;
+
+            bool hasArrivals;
+            Distribution interarrivalTime;
+        };
+
+        // the time @stage takes to process one message.
+        StageGraph& serviceTime(const StageEnum stage, const Distribution& serviceTime);
+
+        // after processing a message, @from dispatches it to @to with
+        // @probability. Each edge is followed independently, so several
+        // edges of probability 1 fan a message out, and an edge back to an
+        // earlier stage with probability < 1 makes a loop which terminates.
+        StageGraph& edge(const StageEnum from, const StageEnum to, const double probability = 1.0);
+
+        // messages arrive at @stage from outside the graph with gaps drawn
+        // from @interarrivalTime, e.g. Distribution::poisson(100000).
+        StageGraph& arrivals(const StageEnum stage, const Distribution& interarrivalTime);
+
+        const StageModel& operator[](const StageEnum stage) const;
+
+    private:
+        std::array<StageModel, NumberOfStages> stages_;
+    };
+
+
+    template<typename StageEnum>
+    StageGraph<StageEnum>::StageModel::StageModel()
+        : serviceTime(Distribution::constant(Duration(0)))
+        , hasArrivals(false)
+        , interarrivalTime(Distribution::constant(Duration(0)))
+    {
+    }
+
+    template<typename StageEnum>
+    inline
+    StageGraph<StageEnum>& StageGraph<StageEnum>::serviceTime(const StageEnum stage, const Distribution& serviceTime)
+    {
+        stages_[static_cast<std::size_t>(stage)].serviceTime = serviceTime;
+        return *this;
+    }
+
+    template<typename StageEnum>
+    inline
+    StageGraph<StageEnum>& StageGraph<StageEnum>::edge(const StageEnum from, const StageEnum to, const double probability)
+    {
+        stages_[static_cast<std::size_t>(from)].edges.push_back(Edge{ to, probability });
+        return *this;
+    }
+
+    template<typename StageEnum>
+    inline
+    StageGraph<StageEnum>& StageGraph<StageEnum>::arrivals(const StageEnum stage, const Distribution& interarrivalTime)
+    {
+        auto& model = stages_[static_cast<std::size_t>(stage)];
+        model.hasArrivals = true;
+        model.interarrivalTime = interarrivalTime;
+        return *this;
+    }
+
+    template<typename StageEnum>
+    inline
+    const typename StageGraph<StageEnum>::StageModel& StageGraph<StageEnum>::operator[](const StageEnum stage) const
+    {
+        return stages_[static_cast<std::size_t>(stage)];
+    }
+}}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+
+namespace wield { namespace simulation {
+
+    namespace details {
+
+        // thrown out of a scheduling policy's nextStage() when a simulated
+        // thread would wait for work, the simulator parks the thread until
+        // the next dispatch.
+        struct NoWork {};
+    }
+
+    // The stage name queue for simulating the Color scheduling policy.
+    //
+    // Color::nextStage() polls its stage name queue until a name appears.
+    // With real threads another thread eventually dispatches something, in
+    // the simulator nothing else happens until nextStage() returns, so an
+    // empty queue ends the call instead of returning false.
+    template<typename StageEnum>
+    class StageNameQueue
+    {
+    public:
+        void push(const StageEnum stage) { queue_.push_back(stage); }
+
+        bool try_pop(StageEnum& stage)
+        {
+            if(queue_.empty())
+            {
+                throw details::NoWork();
+            }
+
+            stage = queue_.front();
+            queue_.pop_front();
+            return true;
+        }
+
+        std::size_t unsafe_size(void) const { return queue_.size(); }
+
+    private:
+        std::deque<StageEnum> queue_;
+    };
+}}
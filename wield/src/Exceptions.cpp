@@ -11,5 +11,80 @@ namespace wield {
         : std::runtime_error("Pushed message onto MultipleInputQueueAdapter rather than contained queue.")
     {
     }
+
+    TooManyInputQueuesAdded::TooManyInputQueuesAdded()
+        : std::runtime_error("WeightedMultipleInputQueueAdapter::addQueue() added more queues than NumberOfInputs.")
+    {
+    }
+
+    IllegallyPushedMessageOntoTimerWheel::IllegallyPushedMessageOntoTimerWheel()
+        : std::runtime_error("Pushed message onto TimerWheel, schedule() timeouts instead.")
+    {
+    }
+
+    IllegallyPushedMessageOntoIngress::IllegallyPushedMessageOntoIngress()
+        : std::runtime_error("Pushed message onto SocketIngress, ingress stages only dispatch what they receive.")
+    {
+    }
+
+    InvalidSharedMemoryRing::InvalidSharedMemoryRing()
+        : std::runtime_error("SharedMemoryRing attached to memory which doesn't hold a ring.")
+    {
+    }
+
+    MessageTooLargeForSharedMemoryRing::MessageTooLargeForSharedMemoryRing()
+        : std::runtime_error("Message doesn't fit in a SharedMemoryRing slot.")
+    {
+    }
+
+    SharedMemoryRingFull::SharedMemoryRingFull()
+        : std::runtime_error("SharedMemoryEgressQueue the ring stayed full, the other process isn't consuming it.")
+    {
+    }
+
+    MessageNotSerializable::MessageNotSerializable()
+        : std::runtime_error("Serialized a message which doesn't override MessageBase::serializeInto().")
+    {
+    }
+
+    MessageTooLargeForBuffer::MessageTooLargeForBuffer()
+        : std::runtime_error("Serialized message doesn't fit in the buffer.")
+    {
+    }
+
+    UnknownMessageType::UnknownMessageType()
+        : std::runtime_error("MessageRegistry::deserialize() type id of the message isn't registered.")
+    {
+    }
+
+    DuplicateMessageTypeRegistration::DuplicateMessageTypeRegistration()
+        : std::runtime_error("MessageRegistry::add() duplicate registration of type id.")
+    {
+    }
+
+    TransportLinkClosed::TransportLinkClosed()
+        : std::runtime_error("TransportEgressQueue the far side of the link has closed it.")
+    {
+    }
+
+    TransportWindowFull::TransportWindowFull()
+        : std::runtime_error("TransportEgressQueue the window stayed full, the far side isn't returning credit.")
+    {
+    }
+
+    UnknownStageName::UnknownStageName()
+        : std::runtime_error("The stage named by a received message isn't one of the StageEnum's.")
+    {
+    }
+
+    InvalidJournal::InvalidJournal()
+        : std::runtime_error("JournalReader the segment file isn't a journal, or is corrupt.")
+    {
+    }
+
+    FanoutOfUniquelyOwnedMessage::FanoutOfUniquelyOwnedMessage()
+        : std::runtime_error("MessageBase::incrementReferenceCount() a uniquely owned message can't be fanned out, dispatch a clone to each stage.")
+    {
+    }
 }
 
@@ -0,0 +1,257 @@
+#pragma once
+#include <wield/CloneMessageTag.hpp>
+#include <wield/Exceptions.hpp>
+#include <wield/static_graph/StageGraph.hpp>
+#include <wield/static_graph/StageHandle.hpp>
+#include <wield/static_graph/details/StaticRoute.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+namespace wield { namespace static_graph {
+
+    /* Dispatcher
+
+       A dispatcher generated from a compile-time <StageGraph>. Where DispatcherBase
+       keeps an array of pointers to a single Stage type (forcing every stage to share
+       a queue type, or to go through polymorphic::QueueInterface), this dispatcher keeps
+       a pointer to each stage's concrete type. Routing is resolved either at compile
+       time (dispatch<StageName>()) or through a static switch over the stage names
+       (dispatch(stageName, ...)), so queue push/pop and processing functor invocation
+       involve no virtual calls and can be inlined.
+
+       Scheduling policies work unchanged, operator[] returns a <StageHandle> which
+       routes process() to the concrete stage.
+    */
+    template<class Graph>
+    class Dispatcher
+    {
+    public:
+        using StageGraphType = Graph;
+        using StageEnumType = typename Graph::StageEnumType;
+        using MessageType = typename Graph::MessageType;
+        using StageType = StageHandle<Dispatcher>;
+
+        template<StageEnumType StageName>
+        using ConcreteStageType = typename Graph::template StageType<static_cast<std::size_t>(StageName)>;
+
+        Dispatcher();
+
+        // Register a <static_graph::Stage> with the Dispatcher,
+        // called by the stage's constructor.
+        // @stage is the pointer to the stage
+        template<StageEnumType StageName>
+        void registerStage(ConcreteStageType<StageName>* stage);
+
+        // Send a message to a stage, routed at compile-time.
+        // @message is the message to send
+        template<StageEnumType StageName>
+        void dispatch(MessageType& message);
+
+        // Send a copy of a message to a stage, routed at compile-time.
+        // @message the message to send
+        // @clone a tag type for tag-dispatching this overloaded function
+        template<StageEnumType StageName, class ConcreteMessageType>
+        void dispatch(ConcreteMessageType& message, CloneMessageTagType);
+
+        // Send a message to a stage
+        // @stageName the stage to dispatch the message to.
+        // @message is the message to send
+        void dispatch(StageEnumType stageName, MessageType& message);
+
+        // Send a copy of a message to a stage
+        // @stageName the stage to dispatch the message to.
+        // @message the message to send
+        // @clone a tag type for tag-dispatching this overloaded function
+        template<class ConcreteMessageType>
+        void dispatch(StageEnumType stageName, ConcreteMessageType& message, CloneMessageTagType);
+
+        // Send a batch of messages to a stage in one operation, routed at compile-time.
+        // @first, @last a forward iterator range over messages (raw or smart pointers)
+        template<StageEnumType StageName, class Iterator>
+        void dispatchBatch(Iterator first, Iterator last);
+
+        // Send a batch of messages to a stage in one operation
+        // @stageName the stage to dispatch the messages to.
+        // @first, @last a forward iterator range over messages (raw or smart pointers)
+        template<class Iterator>
+        void dispatchBatch(StageEnumType stageName, Iterator first, Iterator last);
+
+        // Send one message to several stages
+        // @firstStage, @lastStage a forward iterator range over the names of the destination stages.
+        // @message the message to send, the references for all destinations are added at once.
+        template<class StageIterator>
+        void dispatchFanout(StageIterator firstStage, StageIterator lastStage, MessageType& message);
+
+        // Push a message onto a stage's queue without touching the reference count.
+        void push(StageEnumType stageName, const typename MessageType::ptr& message);
+
+        // Process a message on a stage.
+        // @return true if a message was processed, false otherwise.
+        bool process(StageEnumType stageName);
+
+        // Concrete stage lookup function
+        template<StageEnumType StageName>
+        ConcreteStageType<StageName>& stage();
+
+        // Stage lookup function
+        // @stageName is the name of the stage to get a handle to.
+        //
+        // @return a reference to the requested stage's handle.
+        StageType& operator[](StageEnumType stageName);
+
+    private:
+        Dispatcher(const Dispatcher&) = delete;
+        Dispatcher& operator=(const Dispatcher&) = delete;
+
+        using Route = details::StaticRoute<0, Graph::NumberOfStages>;
+
+    private:
+        typename Graph::StagePointers stages_;
+        std::array<StageType, Graph::NumberOfStages> handles_;
+    };
+
+
+    template<class Graph>
+    Dispatcher<Graph>::Dispatcher()
+        : stages_()     // value-initialize all stage pointers to nullptr.
+    {
+        for(std::size_t i = 0; i < handles_.size(); ++i)
+        {
+            handles_[i] = StageType(*this, static_cast<StageEnumType>(i));
+        }
+    }
+
+    template<class Graph>
+    template<typename Dispatcher<Graph>::StageEnumType StageName>
+    void Dispatcher<Graph>::registerStage(ConcreteStageType<StageName>* stage)
+    {
+        auto& registered = std::get<static_cast<std::size_t>(StageName)>(stages_);
+        if(nullptr != registered)
+        {
+            throw wield::DuplicateStageRegistrationException();
+        }
+
+        registered = stage;
+    }
+
+    template<class Graph>
+    template<typename Dispatcher<Graph>::StageEnumType StageName>
+    inline
+    void Dispatcher<Graph>::dispatch(MessageType& message)
+    {
+        // increment the reference count so the message isn't deleted while
+        // in the queue.
+        message.incrementReferenceCount();
+
+        std::get<static_cast<std::size_t>(StageName)>(stages_)->push(&message);
+    }
+
+    template<class Graph>
+    template<typename Dispatcher<Graph>::StageEnumType StageName, class ConcreteMessageType>
+    inline
+    void Dispatcher<Graph>::dispatch(ConcreteMessageType& message, CloneMessageTagType)
+    {
+        static_assert(std::is_base_of<MessageType, ConcreteMessageType>::value, "ConcreteMessageType must be derived from Message.");
+
+        typename MessageType::ptr clone = new ConcreteMessageType(message);
+        clone->incrementReferenceCount();
+
+        std::get<static_cast<std::size_t>(StageName)>(stages_)->push(clone);
+    }
+
+    template<class Graph>
+    inline
+    void Dispatcher<Graph>::dispatch(StageEnumType stageName, MessageType& message)
+    {
+        message.incrementReferenceCount();
+        push(stageName, &message);
+    }
+
+    template<class Graph>
+    template<class ConcreteMessageType>
+    inline
+    void Dispatcher<Graph>::dispatch(StageEnumType stageName, ConcreteMessageType& message, CloneMessageTagType)
+    {
+        static_assert(std::is_base_of<MessageType, ConcreteMessageType>::value, "ConcreteMessageType must be derived from Message.");
+
+        typename MessageType::ptr clone = new ConcreteMessageType(message);
+        clone->incrementReferenceCount();
+
+        push(stageName, clone);
+    }
+
+    template<class Graph>
+    template<typename Dispatcher<Graph>::StageEnumType StageName, class Iterator>
+    inline
+    void Dispatcher<Graph>::dispatchBatch(Iterator first, Iterator last)
+    {
+        for(Iterator it = first; it != last; ++it)
+        {
+            (*it)->incrementReferenceCount();
+        }
+
+        std::get<static_cast<std::size_t>(StageName)>(stages_)->push(first, last);
+    }
+
+    template<class Graph>
+    template<class Iterator>
+    inline
+    void Dispatcher<Graph>::dispatchBatch(StageEnumType stageName, Iterator first, Iterator last)
+    {
+        for(Iterator it = first; it != last; ++it)
+        {
+            (*it)->incrementReferenceCount();
+        }
+
+        details::BatchPushVisitor<Iterator> visitor(first, last);
+        Route::apply(static_cast<std::size_t>(stageName), stages_, visitor);
+    }
+
+    template<class Graph>
+    template<class StageIterator>
+    inline
+    void Dispatcher<Graph>::dispatchFanout(StageIterator firstStage, StageIterator lastStage, MessageType& message)
+    {
+        message.incrementReferenceCount(static_cast<std::size_t>(std::distance(firstStage, lastStage)));
+
+        for(; firstStage != lastStage; ++firstStage)
+        {
+            push(*firstStage, &message);
+        }
+    }
+
+    template<class Graph>
+    inline
+    void Dispatcher<Graph>::push(StageEnumType stageName, const typename MessageType::ptr& message)
+    {
+        details::PushVisitor<typename MessageType::ptr> visitor(message);
+        Route::apply(static_cast<std::size_t>(stageName), stages_, visitor);
+    }
+
+    template<class Graph>
+    inline
+    bool Dispatcher<Graph>::process(StageEnumType stageName)
+    {
+        details::ProcessVisitor visitor;
+        return Route::apply(static_cast<std::size_t>(stageName), stages_, visitor);
+    }
+
+    template<class Graph>
+    template<typename Dispatcher<Graph>::StageEnumType StageName>
+    inline
+    typename Dispatcher<Graph>::template ConcreteStageType<StageName>& Dispatcher<Graph>::stage()
+    {
+        return *std::get<static_cast<std::size_t>(StageName)>(stages_);
+    }
+
+    template<class Graph>
+    inline
+    typename Dispatcher<Graph>::StageType& Dispatcher<Graph>::operator[](StageEnumType stageName)
+    {
+        return handles_[static_cast<std::size_t>(stageName)];
+    }
+}}
@@ -0,0 +1,108 @@
+#pragma once
+#include <wield/MessageBase.hpp>
+
+#include <wield/details/BulkPush.hpp>
+#include <wield/details/ProcessedNotification.hpp>
+#include <wield/details/SmartPtrCreator.hpp>
+
+#include <type_traits>
+
+namespace wield { namespace static_graph {
+
+    /* Stage
+       @StageEnum the enum defining names of all stages.
+       @StageName the name of this stage.
+       @ProcessingFunctor this stage's concrete processing functor type.
+       @Message the message base class.
+       @QueueType the concrete type of queue this stage will get inputs from.
+
+       The compile-time counterpart of <StageBase>. The stage name is a template
+       parameter and the stage registers with a <static_graph::Dispatcher>, so each
+       stage in the graph may have a different queue and processing functor type
+       without resorting to polymorphic queue adapters.
+    */
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Message, class QueueType>
+    class Stage
+    {
+    public:
+        static_assert(std::is_enum<StageEnum>::value, "StageEnum parameter is not an enum type.");
+
+        using StageEnumType = StageEnum;
+        using MessageType = Message;
+        using ProcessingFunctorType = ProcessingFunctor;
+        using Queue = QueueType;
+
+        template<class Dispatcher>
+        Stage(Dispatcher& dispatcher, QueueType& queue, ProcessingFunctor& processingFunctor);
+
+        // Insert a message onto the stage's queue
+        // @m the message to insert
+        void push(const typename MessageType::ptr& m);
+
+        // Insert a run of messages onto the stage's queue, using the
+        // queue's push_bulk(first, last) when it provides one.
+        // @first, @last the range of messages to insert
+        template<class Iterator>
+        void push(Iterator first, Iterator last);
+
+        // process a message:
+        // pump the queue, if there is a message, process it.
+        // @return true if a message was processed, false otherwise.
+        bool process(void);
+
+        // get the stage's name
+        static constexpr StageEnum name(void) { return StageName; }
+
+    private:
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+    private:
+        ProcessingFunctor& processingFunctor_;
+        QueueType& queue_;
+    };
+
+
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Message, class QueueType>
+    template<class Dispatcher>
+    Stage<StageEnum, StageName, ProcessingFunctor, Message, QueueType>::Stage(Dispatcher& dispatcher, QueueType& queue, ProcessingFunctor& processingFunctor)
+        : processingFunctor_(processingFunctor)
+        , queue_(queue)
+    {
+        dispatcher.template registerStage<StageName>(this);
+    }
+
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Message, class QueueType>
+    inline
+    void Stage<StageEnum, StageName, ProcessingFunctor, Message, QueueType>::push(const typename MessageType::ptr& m)
+    {
+        queue_.push(m);
+    }
+
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Message, class QueueType>
+    template<class Iterator>
+    inline
+    void Stage<StageEnum, StageName, ProcessingFunctor, Message, QueueType>::push(Iterator first, Iterator last)
+    {
+        wield::details::bulk_push<typename MessageType::ptr>(queue_, first, last);
+    }
+
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Message, class QueueType>
+    inline
+    bool Stage<StageEnum, StageName, ProcessingFunctor, Message, QueueType>::process(void)
+    {
+        typename MessageType::ptr m = nullptr;
+        if(queue_.try_pop(m))
+        {
+            typename MessageType::smartptr message(wield::details::create_smartptr<MessageType>(m, no_increment));
+
+            // tell queues which need to know (e.g. KeyedQueue) when processing is done.
+            wield::details::ProcessedNotification<QueueType, typename MessageType::ptr> notify(queue_, m);
+
+            message->processWith(processingFunctor_);
+            return true;
+        }
+
+        return false;
+    }
+}}
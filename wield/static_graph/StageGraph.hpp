@@ -0,0 +1,83 @@
+#pragma once
+#include <wield/static_graph/Stage.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace wield { namespace static_graph {
+
+    // Describes a single stage of a compile-time stage graph.
+    //
+    // @StageEnum the enum defining names of all stages.
+    // @StageName the name of the stage being described.
+    // @ProcessingFunctor the *concrete* processing functor type of the stage.
+    // @Queue the *concrete* queue type of the stage (no QueueInterface required).
+    template<typename StageEnum, StageEnum StageName, class ProcessingFunctor, class Queue>
+    struct StageDescription
+    {
+        static_assert(std::is_enum<StageEnum>::value, "StageEnum parameter is not an enum type.");
+
+        using StageEnumType = StageEnum;
+        using ProcessingFunctorType = ProcessingFunctor;
+        using QueueType = Queue;
+
+        static constexpr StageEnum name(void) { return StageName; }
+    };
+
+    namespace details {
+
+        // verify the stage descriptions are listed in StageEnum order,
+        // so a stage name can be used directly as an index into the graph.
+        template<std::size_t Index, class... StageDescriptions>
+        struct InStageEnumOrder : std::true_type {};
+
+        template<std::size_t Index, class Description, class... StageDescriptions>
+        struct InStageEnumOrder<Index, Description, StageDescriptions...>
+            : std::integral_constant<bool,
+                static_cast<std::size_t>(Description::name()) == Index &&
+                InStageEnumOrder<Index + 1, StageDescriptions...>::value>
+        {
+        };
+    }
+
+    // A compile-time description of the stage graph, a type list
+    // of <StageDescription>s from which a statically typed
+    // <static_graph::Dispatcher> is generated.
+    //
+    // @StageEnum the enum defining names of all stages.
+    // @Message the message base class shared by all stages.
+    // @StageDescriptions one <StageDescription> per StageEnum entry, in StageEnum order.
+    template<typename StageEnum, class Message, class... StageDescriptions>
+    struct StageGraph
+    {
+        static_assert(std::is_enum<StageEnum>::value, "StageEnum parameter is not an enum type.");
+        static_assert(sizeof...(StageDescriptions) == static_cast<std::size_t>(StageEnum::NumberOfEntries), "StageGraph must describe every stage in StageEnum.");
+        static_assert(details::InStageEnumOrder<0, StageDescriptions...>::value, "StageGraph stage descriptions must be listed in StageEnum order.");
+
+        using StageEnumType = StageEnum;
+        using MessageType = Message;
+
+        static const std::size_t NumberOfStages = sizeof...(StageDescriptions);
+
+        template<std::size_t Index>
+        using Description = typename std::tuple_element<Index, std::tuple<StageDescriptions...>>::type;
+
+        // the concrete stage type for the stage at @Index
+        template<std::size_t Index>
+        using StageType = Stage<
+            StageEnum,
+            Description<Index>::name(),
+            typename Description<Index>::ProcessingFunctorType,
+            Message,
+            typename Description<Index>::QueueType>;
+
+        // one pointer per stage, each to its concrete stage type.
+        using StagePointers = std::tuple<Stage<
+            StageEnum,
+            StageDescriptions::name(),
+            typename StageDescriptions::ProcessingFunctorType,
+            Message,
+            typename StageDescriptions::QueueType>*...>;
+    };
+}}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+
+namespace wield { namespace static_graph {
+
+    // <StageHandle> is what a <static_graph::Dispatcher> hands to scheduling
+    // policies. Scheduling policies and SchedulerBase only need a stage's name
+    // and its process() method; the handle provides these and forwards to the
+    // concretely typed stage through the dispatcher's static routing.
+    template<class Dispatcher>
+    class StageHandle
+    {
+    public:
+        using StageEnumType = typename Dispatcher::StageEnumType;
+        using MessageType = typename Dispatcher::MessageType;
+
+        StageHandle();
+        StageHandle(Dispatcher& dispatcher, const StageEnumType stageName);
+
+        // Insert a message onto the stage's queue
+        // @m the message to insert
+        void push(const typename MessageType::ptr& m);
+
+        // process a message on the stage.
+        // @return true if a message was processed, false otherwise.
+        bool process(void);
+
+        // get the stage's name
+        StageEnumType name(void) const;
+
+    private:
+        Dispatcher* dispatcher_;
+        StageEnumType stageName_;
+    };
+
+
+    template<class Dispatcher>
+    StageHandle<Dispatcher>::StageHandle()
+        : dispatcher_(nullptr)
+        , stageName_(StageEnumType::NumberOfEntries)
+    {
+    }
+
+    template<class Dispatcher>
+    StageHandle<Dispatcher>::StageHandle(Dispatcher& dispatcher, const StageEnumType stageName)
+        : dispatcher_(&dispatcher)
+        , stageName_(stageName)
+    {
+    }
+
+    template<class Dispatcher>
+    inline
+    void StageHandle<Dispatcher>::push(const typename MessageType::ptr& m)
+    {
+        dispatcher_->push(stageName_, m);
+    }
+
+    template<class Dispatcher>
+    inline
+    bool StageHandle<Dispatcher>::process(void)
+    {
+        return dispatcher_->process(stageName_);
+    }
+
+    template<class Dispatcher>
+    inline
+    typename StageHandle<Dispatcher>::StageEnumType StageHandle<Dispatcher>::name(void) const
+    {
+        return stageName_;
+    }
+}}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+
+namespace wield { namespace static_graph { namespace details {
+
+    // Route a run-time stage index to the concretely typed stage
+    // pointer in @stages and apply @visitor to it.
+    //
+    // The recursion unrolls into a chain of comparisons against
+    // compile-time constants, which the optimizer lowers to a jump
+    // table (or a single call when the index is a constant) - each
+    // branch invokes a concrete stage, so push/process are inlinable.
+    //
+    // The last stage is the fall-through case; as with DispatcherBase
+    // passing an invalid stage name is undefined behavior.
+    template<std::size_t Index, std::size_t NumberOfStages, bool IsLastStage = (Index + 1 == NumberOfStages)>
+    struct StaticRoute
+    {
+        template<class StagePointers, class Visitor>
+        static inline
+        typename Visitor::result_type apply(const std::size_t stageIndex, StagePointers& stages, Visitor& visitor)
+        {
+            if(stageIndex == Index)
+            {
+                return visitor(std::get<Index>(stages));
+            }
+
+            return StaticRoute<Index + 1, NumberOfStages>::apply(stageIndex, stages, visitor);
+        }
+    };
+
+    template<std::size_t Index, std::size_t NumberOfStages>
+    struct StaticRoute<Index, NumberOfStages, true>
+    {
+        template<class StagePointers, class Visitor>
+        static inline
+        typename Visitor::result_type apply(const std::size_t, StagePointers& stages, Visitor& visitor)
+        {
+            return visitor(std::get<Index>(stages));
+        }
+    };
+
+    // visitor pushing a message onto a stage.
+    template<class MessagePtr>
+    struct PushVisitor
+    {
+        using result_type = void;
+
+        explicit PushVisitor(const MessagePtr& message) : message_(message) {}
+
+        template<class Stage>
+        inline void operator()(Stage* stage) { stage->push(message_); }
+
+        const MessagePtr& message_;
+    };
+
+    // visitor pushing a run of messages onto a stage.
+    template<class Iterator>
+    struct BatchPushVisitor
+    {
+        using result_type = void;
+
+        BatchPushVisitor(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+        template<class Stage>
+        inline void operator()(Stage* stage) { stage->push(first_, last_); }
+
+        Iterator first_;
+        Iterator last_;
+    };
+
+    // visitor asking a stage to process a message.
+    struct ProcessVisitor
+    {
+        using result_type = bool;
+
+        template<class Stage>
+        inline bool operator()(Stage* stage) { return stage->process(); }
+    };
+}}}
@@ -0,0 +1,154 @@
+#pragma once
+#include <queue_benchmark/Histogram.hpp>
+#include <queue_benchmark/Item.hpp>
+#include <queue_benchmark/Pattern.hpp>
+#include <queue_benchmark/Result.hpp>
+#include <queue_benchmark/platform/Affinity.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace queue_benchmark {
+
+    // Push @operations items through a queue of QueueUnderTest::Concrete
+    // type, arranged as @pattern. Producers and consumers only see the
+    // queue as QueueUnderTest::Interface.
+    //
+    // The run is closed loop: at most @window items are in the queue at any
+    // time, a producer waits for a consumer to pop one before pushing more.
+    // Producers stamp each item as it is pushed and consumers record the
+    // push-to-pop latency, so the latency is that of the two operations
+    // and a queue at most @window deep, rather than of however far the
+    // producers got ahead. The clock reads are the same for every queue
+    // and are included in the throughput.
+    //
+    // If @pin is set, producers are pinned to cores 0..P-1 and consumers
+    // to the cores after them (wrapping around the hardware cores).
+    template<class QueueUnderTest>
+    Result runBenchmark(const Pattern& pattern, const std::size_t operations, const std::size_t window, const bool pin)
+    {
+        using Interface = typename QueueUnderTest::Interface;
+
+        typename QueueUnderTest::Concrete concrete;
+        Interface& queue = concrete;
+
+        // preallocate every item, each producer gets a contiguous share.
+        std::vector<Item> items(operations);
+
+        std::atomic<bool> go(false);
+        std::atomic<std::size_t> producersDone(0);
+        std::atomic<std::size_t> inFlight(0);
+        std::vector<Histogram> histograms(pattern.consumers);
+
+        std::vector<std::thread> threads;
+        for(std::size_t p = 0; p < pattern.producers; ++p)
+        {
+            Item* first = items.data() + operations * p / pattern.producers;
+            Item* last = items.data() + operations * (p + 1) / pattern.producers;
+
+            threads.emplace_back([&queue, &go, &producersDone, &inFlight, window, first, last]()
+            {
+                while(!go.load(std::memory_order_acquire))
+                {
+                }
+
+                for(Item* item = first; item != last; ++item)
+                {
+                    // take a place in the window.
+                    std::size_t queued = inFlight.load(std::memory_order_relaxed);
+                    while(queued >= window || !inFlight.compare_exchange_weak(queued, queued + 1, std::memory_order_relaxed))
+                    {
+                        if(queued >= window)
+                        {
+                            std::this_thread::yield();
+                            queued = inFlight.load(std::memory_order_relaxed);
+                        }
+                    }
+
+                    item->pushed = Clock::now();
+                    queue.push(item);
+                }
+
+                producersDone.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        const std::size_t numberOfProducers = pattern.producers;
+        for(std::size_t c = 0; c < pattern.consumers; ++c)
+        {
+            Histogram& histogram = histograms[c];
+
+            threads.emplace_back([&queue, &go, &producersDone, &inFlight, &histogram, numberOfProducers]()
+            {
+                while(!go.load(std::memory_order_acquire))
+                {
+                }
+
+                // the place in the window is given back once the latency is taken.
+                auto record = [&histogram, &inFlight](const ItemPtr item)
+                {
+                    histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - item->pushed).count());
+                    inFlight.fetch_sub(1, std::memory_order_relaxed);
+                };
+
+                ItemPtr item = nullptr;
+                for(;;)
+                {
+                    if(queue.try_pop(item))
+                    {
+                        record(item);
+                    }
+                    else if(producersDone.load(std::memory_order_acquire) == numberOfProducers)
+                    {
+                        // every item has been pushed, drain what is left.
+                        while(queue.try_pop(item))
+                        {
+                            record(item);
+                        }
+                        break;
+                    }
+                }
+            });
+        }
+
+        bool pinned = pin;
+        if(pin)
+        {
+            for(std::size_t t = 0; t < threads.size(); ++t)
+            {
+                pinned = platform::pinToCore(threads[t], t) && pinned;
+            }
+        }
+
+        const TimePoint start = Clock::now();
+        go.store(true, std::memory_order_release);
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const TimePoint end = Clock::now();
+
+        Result result;
+        result.queue = QueueUnderTest::name();
+        result.pattern = Pattern::name(pattern.kind);
+        result.producers = pattern.producers;
+        result.consumers = pattern.consumers;
+        result.pinned = pinned;
+        result.operations = operations;
+        result.window = window;
+
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        result.throughput = result.seconds > 0 ? operations / result.seconds : 0;
+
+        for(const auto& histogram : histograms)
+        {
+            result.latency.merge(histogram);
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace queue_benchmark {
+
+    // A latency histogram with power-of-two nanosecond buckets: bucket b
+    // counts samples in [2^(b-1), 2^b). Recording is a couple of
+    // instructions so each consumer keeps its own and they are merged
+    // once the run is over.
+    class Histogram
+    {
+    public:
+        static const std::size_t NumberOfBuckets = 64;
+
+        Histogram();
+
+        void record(const std::int64_t nanoseconds);
+        void merge(const Histogram& other);
+
+        std::uint64_t count() const { return count_; }
+        std::int64_t max() const { return max_; }
+
+        // an upper bound on the @p quantile (0 < @p <= 1), in nanoseconds.
+        std::int64_t percentile(const double p) const;
+
+        const std::array<std::uint64_t, NumberOfBuckets>& buckets() const { return buckets_; }
+
+    private:
+        std::array<std::uint64_t, NumberOfBuckets> buckets_;
+        std::uint64_t count_;
+        std::int64_t max_;
+    };
+}
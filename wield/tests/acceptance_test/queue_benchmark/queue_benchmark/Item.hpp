@@ -0,0 +1,16 @@
+#pragma once
+#include <queue_benchmark/TimePoint.hpp>
+
+namespace queue_benchmark {
+
+    // The element passed through the queues under test. Items are
+    // preallocated by each producer so the benchmark measures the
+    // queue, not the allocator.
+    struct Item
+    {
+        TimePoint pushed;
+    };
+
+    // queues are benchmarked with pointer elements, like Message::ptr.
+    using ItemPtr = Item*;
+}
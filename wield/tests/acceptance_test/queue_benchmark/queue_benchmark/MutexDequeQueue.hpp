@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace queue_benchmark {
+
+    // The baseline every other queue is compared against: a std::deque
+    // guarded by a std::mutex, satisfying wield's queue concept.
+    template<class T>
+    class MutexDequeQueue
+    {
+    public:
+        void push(const T& value)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            queue_.push_back(value);
+        }
+
+        bool try_pop(T& value)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if(queue_.empty())
+            {
+                return false;
+            }
+
+            value = queue_.front();
+            queue_.pop_front();
+            return true;
+        }
+
+        std::size_t unsafe_size(void) const
+        {
+            return queue_.size();
+        }
+
+    private:
+        std::deque<T> queue_;
+        std::mutex lock_;
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <queue_benchmark/Pattern.hpp>
+#include <queue_benchmark/Result.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace queue_benchmark {
+
+    // Command line options, every run is the cross product of
+    // queues x patterns x pinning.
+    //
+    //   --queue=concurrent_queue,polymorphic_concurrent_queue,mutex_deque
+    //   --pattern=spsc,mpsc,mpmc
+    //   --producers=4                  producers for mpsc and mpmc
+    //   --consumers=4                  consumers for mpmc
+    //   --operations=1000000           items pushed per run
+    //   --window=1024                  items in flight (closed loop)
+    //   --pin=off,on                   pin threads to cores
+    //   --format=json                  json|csv
+    struct Options
+    {
+        Options();
+
+        // @return false (after writing the reason to @error) if
+        // @argv contains an unknown or malformed option.
+        bool parse(int argc, char* argv[], const std::vector<std::string>& queueNames, std::ostream& error);
+
+        static void usage(std::ostream& os);
+
+        std::vector<std::string> queues;    // empty means every queue
+        std::vector<Pattern::Kind> patterns;
+        std::vector<bool> pin;
+
+        std::size_t producers;
+        std::size_t consumers;
+        std::size_t operations;
+        std::size_t window;
+
+        Format format;
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace queue_benchmark {
+
+    // The producer/consumer arrangement of a run.
+    struct Pattern
+    {
+        enum class Kind
+        {
+            SPSC,   // single producer, single consumer (a stage fed by one stage)
+            MPSC,   // many producers, single consumer (a stage fed by many stages)
+            MPMC    // many producers, many consumers (a stage visited by many threads)
+        };
+
+        // SPSC ignores @producers and @consumers, MPSC ignores @consumers.
+        static Pattern create(const Kind kind, const std::size_t producers, const std::size_t consumers);
+
+        // parse "spsc", "mpsc" or "mpmc". @return false if @name is unknown.
+        static bool parse(const std::string& name, Kind& kind);
+
+        static const char* name(const Kind kind);
+
+        Kind kind;
+        std::size_t producers;
+        std::size_t consumers;
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <queue_benchmark/Item.hpp>
+#include <queue_benchmark/MutexDequeQueue.hpp>
+#include <queue_benchmark/platform/ConcurrentQueue.hpp>
+
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+#include <wield/adapters/polymorphic/QueueInterface.hpp>
+
+namespace queue_benchmark {
+
+    // Each queue under test names the type the benchmark owns (Concrete)
+    // and the type producers and consumers call through (Interface). They
+    // differ only when measuring an adapter, e.g. calling the polymorphic
+    // QueueAdapter through its QueueInterface costs a virtual call per op.
+    //
+    // To benchmark a new queue, add a struct here and an entry to the
+    // table in main.cpp. Any type satisfying wield's queue concept (push,
+    // try_pop, unsafe_size) of ItemPtr can be used.
+    template<class ConcreteQueue, class InterfaceQueue = ConcreteQueue>
+    struct QueueUnderTest
+    {
+        using Concrete = ConcreteQueue;
+        using Interface = InterfaceQueue;
+    };
+
+    struct TbbQueue : QueueUnderTest<Concurrency::concurrent_queue<ItemPtr>>
+    {
+        static const char* name() { return "concurrent_queue"; }
+    };
+
+    struct PolymorphicTbbQueue : QueueUnderTest<
+        wield::adapters::polymorphic::QueueAdapter<ItemPtr, Concurrency::concurrent_queue<ItemPtr>>,
+        wield::adapters::polymorphic::QueueInterface<ItemPtr>>
+    {
+        static const char* name() { return "polymorphic_concurrent_queue"; }
+    };
+
+    struct MutexDeque : QueueUnderTest<MutexDequeQueue<ItemPtr>>
+    {
+        static const char* name() { return "mutex_deque"; }
+    };
+}
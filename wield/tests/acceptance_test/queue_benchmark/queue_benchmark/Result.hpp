@@ -0,0 +1,37 @@
+#pragma once
+#include <queue_benchmark/Histogram.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace queue_benchmark {
+
+    // The measurements of one (queue, pattern) run.
+    struct Result
+    {
+        std::string queue;
+        std::string pattern;
+
+        std::size_t producers;
+        std::size_t consumers;
+        bool pinned;
+
+        std::size_t operations;     // items pushed (and popped)
+        std::size_t window;         // items in the queue at most
+        double seconds;
+        double throughput;          // items per second
+
+        // push to pop latency of every item.
+        Histogram latency;
+    };
+
+    enum class Format
+    {
+        Json,       // one JSON object per line, including the histogram
+        Csv
+    };
+
+    void writeHeader(std::ostream& os, const Format format);
+    void write(std::ostream& os, const Format format, const Result& result);
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <chrono>
+
+namespace queue_benchmark {
+
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+
+namespace queue_benchmark { namespace platform {
+
+    // pin @thread to @core (modulo the number of hardware cores).
+    // @return false if pinning is not supported or failed.
+    bool pinToCore(std::thread& thread, const std::size_t core);
+}}
@@ -0,0 +1,31 @@
+#include <queue_benchmark/platform/Affinity.hpp>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace queue_benchmark { namespace platform {
+
+    bool pinToCore(std::thread& thread, const std::size_t core)
+    {
+        const std::size_t numberOfCores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+        const std::size_t target = core % numberOfCores;
+
+#ifdef _WIN32
+        const DWORD_PTR mask = static_cast<DWORD_PTR>(1) << target;
+        return SetThreadAffinityMask(thread.native_handle(), mask) != 0;
+#elif defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(target, &cpus);
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+        (void)thread;
+        (void)target;
+        return false;
+#endif
+    }
+}}
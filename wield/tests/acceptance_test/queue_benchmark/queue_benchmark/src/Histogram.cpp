@@ -0,0 +1,65 @@
+#include <queue_benchmark/Histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace queue_benchmark {
+
+    Histogram::Histogram()
+        : count_(0)
+        , max_(0)
+    {
+        buckets_.fill(0);
+    }
+
+    void Histogram::record(const std::int64_t nanoseconds)
+    {
+        std::uint64_t value = nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0;
+
+        std::size_t bucket = 0;
+        while(value != 0 && bucket + 1 < NumberOfBuckets)
+        {
+            value >>= 1;
+            ++bucket;
+        }
+
+        buckets_[bucket]++;
+        count_++;
+        max_ = std::max(max_, nanoseconds);
+    }
+
+    void Histogram::merge(const Histogram& other)
+    {
+        for(std::size_t b = 0; b < NumberOfBuckets; ++b)
+        {
+            buckets_[b] += other.buckets_[b];
+        }
+
+        count_ += other.count_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::int64_t Histogram::percentile(const double p) const
+    {
+        if(count_ == 0)
+        {
+            return 0;
+        }
+
+        const std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(p * count_));
+
+        std::uint64_t seen = 0;
+        for(std::size_t b = 0; b < NumberOfBuckets; ++b)
+        {
+            seen += buckets_[b];
+            if(seen >= rank)
+            {
+                // the bucket's exclusive upper bound, never more than the max seen.
+                const std::int64_t upper = b == 0 ? 1 : static_cast<std::int64_t>(1ULL << std::min<std::size_t>(b, 62));
+                return std::min(upper, max_);
+            }
+        }
+
+        return max_;
+    }
+}
@@ -0,0 +1,139 @@
+#include <queue_benchmark/Options.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace queue_benchmark {
+
+    namespace {
+
+        std::vector<std::string> split(const std::string& text)
+        {
+            std::vector<std::string> items;
+            std::istringstream is(text);
+            std::string item;
+            while(std::getline(is, item, ','))
+            {
+                if(!item.empty())
+                {
+                    items.push_back(item);
+                }
+            }
+            return items;
+        }
+
+        bool parseCount(const std::string& text, std::size_t& count)
+        {
+            char* end = nullptr;
+            const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+            if(text.empty() || *end != '\0' || value == 0)
+            {
+                return false;
+            }
+
+            count = static_cast<std::size_t>(value);
+            return true;
+        }
+    }
+
+    Options::Options()
+        : patterns({ Pattern::Kind::SPSC, Pattern::Kind::MPSC, Pattern::Kind::MPMC })
+        , pin({ false, true })
+        , producers(4)
+        , consumers(4)
+        , operations(1000000)
+        , window(1024)
+        , format(Format::Json)
+    {
+    }
+
+    bool Options::parse(int argc, char* argv[], const std::vector<std::string>& queueNames, std::ostream& error)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto equals = argument.find('=');
+            const std::string key = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+            bool valid = true;
+            if(key == "--queue")
+            {
+                queues = split(value);
+                for(const auto& queue : queues)
+                {
+                    valid = valid && std::find(begin(queueNames), end(queueNames), queue) != end(queueNames);
+                }
+                valid = valid && !queues.empty();
+            }
+            else if(key == "--pattern")
+            {
+                patterns.clear();
+                for(const auto& name : split(value))
+                {
+                    Pattern::Kind kind;
+                    valid = valid && Pattern::parse(name, kind);
+                    patterns.push_back(kind);
+                }
+                valid = valid && !patterns.empty();
+            }
+            else if(key == "--pin")
+            {
+                pin.clear();
+                for(const auto& setting : split(value))
+                {
+                    valid = valid && (setting == "on" || setting == "off");
+                    pin.push_back(setting == "on");
+                }
+                valid = valid && !pin.empty();
+            }
+            else if(key == "--producers")
+            {
+                valid = parseCount(value, producers);
+            }
+            else if(key == "--consumers")
+            {
+                valid = parseCount(value, consumers);
+            }
+            else if(key == "--operations")
+            {
+                valid = parseCount(value, operations);
+            }
+            else if(key == "--window")
+            {
+                valid = parseCount(value, window);
+            }
+            else if(key == "--format")
+            {
+                valid = value == "json" || value == "csv";
+                format = value == "csv" ? Format::Csv : Format::Json;
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if(!valid)
+            {
+                error << "invalid option: " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Options::usage(std::ostream& os)
+    {
+        os << "usage: queue_benchmark [options]\n"
+           << "  --queue=concurrent_queue,polymorphic_concurrent_queue,mutex_deque\n"
+           << "  --pattern=spsc,mpsc,mpmc\n"
+           << "  --producers=4                 producers for mpsc and mpmc\n"
+           << "  --consumers=4                 consumers for mpmc\n"
+           << "  --operations=1000000          items pushed per run\n"
+           << "  --window=1024                 items in flight\n"
+           << "  --pin=off,on                  pin threads to cores\n"
+           << "  --format=json                 json|csv" << std::endl;
+    }
+}
@@ -0,0 +1,40 @@
+#include <queue_benchmark/Pattern.hpp>
+
+namespace queue_benchmark {
+
+    Pattern Pattern::create(const Kind kind, const std::size_t producers, const std::size_t consumers)
+    {
+        Pattern pattern;
+        pattern.kind = kind;
+        pattern.producers = kind == Kind::SPSC ? 1 : producers;
+        pattern.consumers = kind == Kind::MPMC ? consumers : 1;
+
+        return pattern;
+    }
+
+    bool Pattern::parse(const std::string& name, Kind& kind)
+    {
+        for(const auto candidate : { Kind::SPSC, Kind::MPSC, Kind::MPMC })
+        {
+            if(name == Pattern::name(candidate))
+            {
+                kind = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const char* Pattern::name(const Kind kind)
+    {
+        switch(kind)
+        {
+        case Kind::SPSC:    return "spsc";
+        case Kind::MPSC:    return "mpsc";
+        case Kind::MPMC:    return "mpmc";
+        }
+
+        return "unknown";
+    }
+}
@@ -0,0 +1,60 @@
+#include <queue_benchmark/Result.hpp>
+
+namespace queue_benchmark {
+
+    void writeHeader(std::ostream& os, const Format format)
+    {
+        if(format == Format::Csv)
+        {
+            os << "queue,pattern,producers,consumers,pinned,operations,window,seconds,throughput,"
+               << "p50_ns,p90_ns,p99_ns,p999_ns,max_ns" << std::endl;
+        }
+    }
+
+    void write(std::ostream& os, const Format format, const Result& r)
+    {
+        const Histogram& h = r.latency;
+
+        if(format == Format::Csv)
+        {
+            os << r.queue << ',' << r.pattern << ',' << r.producers << ',' << r.consumers << ','
+               << (r.pinned ? "true" : "false") << ',' << r.operations << ',' << r.window << ','
+               << r.seconds << ',' << r.throughput << ','
+               << h.percentile(0.50) << ',' << h.percentile(0.90) << ',' << h.percentile(0.99) << ','
+               << h.percentile(0.999) << ',' << h.max() << std::endl;
+            return;
+        }
+
+        os << "{\"queue\":\"" << r.queue << "\""
+           << ",\"pattern\":\"" << r.pattern << "\""
+           << ",\"producers\":" << r.producers
+           << ",\"consumers\":" << r.consumers
+           << ",\"pinned\":" << (r.pinned ? "true" : "false")
+           << ",\"operations\":" << r.operations
+           << ",\"window\":" << r.window
+           << ",\"seconds\":" << r.seconds
+           << ",\"throughput\":" << r.throughput
+           << ",\"p50_ns\":" << h.percentile(0.50)
+           << ",\"p90_ns\":" << h.percentile(0.90)
+           << ",\"p99_ns\":" << h.percentile(0.99)
+           << ",\"p999_ns\":" << h.percentile(0.999)
+           << ",\"max_ns\":" << h.max();
+
+        // bucket b counts latencies in [2^(b-1), 2^b) ns, trailing empty buckets are dropped.
+        std::size_t last = 0;
+        for(std::size_t b = 0; b < Histogram::NumberOfBuckets; ++b)
+        {
+            if(h.buckets()[b] != 0)
+            {
+                last = b + 1;
+            }
+        }
+
+        os << ",\"histogram_log2_ns\":[";
+        for(std::size_t b = 0; b < last; ++b)
+        {
+            os << (b == 0 ? "" : ",") << h.buckets()[b];
+        }
+        os << "]}" << std::endl;
+    }
+}
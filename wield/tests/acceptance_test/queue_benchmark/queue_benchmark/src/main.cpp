@@ -0,0 +1,68 @@
+#include <queue_benchmark/Benchmark.hpp>
+#include <queue_benchmark/Options.hpp>
+#include <queue_benchmark/QueuesUnderTest.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using namespace queue_benchmark;
+
+    using Runner = Result(*)(const Pattern&, const std::size_t, const std::size_t, const bool);
+
+    // every queue the benchmark knows about, in the order they are run.
+    const std::vector<std::pair<std::string, Runner>>& runners()
+    {
+        static const std::vector<std::pair<std::string, Runner>> runners = {
+            { MutexDeque::name(),           &runBenchmark<MutexDeque> },
+            { TbbQueue::name(),             &runBenchmark<TbbQueue> },
+            { PolymorphicTbbQueue::name(),  &runBenchmark<PolymorphicTbbQueue> },
+        };
+
+        return runners;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace queue_benchmark;
+
+    std::vector<std::string> queueNames;
+    for(const auto& runner : runners())
+    {
+        queueNames.push_back(runner.first);
+    }
+
+    Options options;
+    if(!options.parse(argc, argv, queueNames, std::cerr))
+    {
+        Options::usage(std::cerr);
+        return 1;
+    }
+
+    writeHeader(std::cout, options.format);
+
+    for(const auto& runner : runners())
+    {
+        if(!options.queues.empty() && std::find(begin(options.queues), end(options.queues), runner.first) == end(options.queues))
+        {
+            continue;
+        }
+
+        for(const auto kind : options.patterns)
+        {
+            const Pattern pattern = Pattern::create(kind, options.producers, options.consumers);
+
+            for(const bool pin : options.pin)
+            {
+                write(std::cout, options.format, runner.second(pattern, options.operations, options.window, pin));
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <queue_stress/Dispatcher.hpp>
+#include <queue_stress/TimePoint.hpp>
+
+#include <queue_stress/stage/StatsProcessingFunctor.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <vector>
+
+namespace queue_stress {
+
+    // Command line options for the open-loop mode:
+    //
+    //   --open-loop
+    //   --rates=100000,200000,400000   offered rates to sweep, messages per second
+    //   --duration=5                   seconds per rate
+    //   --arrivals=constant            constant|poisson
+    struct OpenLoopOptions
+    {
+        enum class Arrivals
+        {
+            Constant,   // evenly spaced sends
+            Poisson     // exponentially distributed gaps
+        };
+
+        OpenLoopOptions();
+
+        // @return false (after writing the reason to @error) if @argv
+        // contains an unknown or malformed option. @openLoop is set if
+        // --open-loop was given.
+        bool parse(int argc, char* argv[], bool& openLoop, std::ostream& error);
+
+        static void usage(std::ostream& os);
+
+        Arrivals arrivals;
+        std::vector<double> rates;
+        std::chrono::seconds duration;
+    };
+
+    // One point on the throughput vs. latency curve.
+    struct RatePoint
+    {
+        double offeredRate;         // messages per second asked for
+        double achievedRate;        // messages per second processed by the last stage
+
+        std::size_t sent;
+        std::size_t dropped;        // dispatches which threw
+
+        // how far behind schedule the generator got, if this is large
+        // the generator (not the stages) limited the offered rate.
+        std::int64_t maxSendLag;
+
+        // latency from intended send time to the last stage, nanoseconds.
+        std::int64_t p50;
+        std::int64_t p90;
+        std::int64_t p99;
+        std::int64_t p999;
+        std::int64_t max;
+    };
+
+    void writeHeader(std::ostream& os);
+    std::ostream& operator<<(std::ostream& os, const RatePoint& point);
+
+    // An open-loop load generator: messages are sent on a schedule fixed
+    // in advance (constant or Poisson arrivals at the offered rate), never
+    // waiting for earlier messages to complete. Latency is measured from
+    // each message's intended send time, so when the generator falls
+    // behind (the pipeline pushes back, or the thread is descheduled)
+    // the delay is charged to the latency rather than silently skipped,
+    // avoiding coordinated omission.
+    //
+    // The generator paces by spinning on the steady clock, it keeps one
+    // core busy for the duration of a run.
+    class OpenLoopGenerator
+    {
+    public:
+        OpenLoopGenerator(Dispatcher& dispatcher, stage::StatsProcessingFunctor& stats, std::size_t& sequenceNumber);
+
+        // send at @rate messages per second for @duration, wait for the
+        // pipeline to drain and summarize the run.
+        RatePoint run(const double rate, const std::chrono::seconds duration, const OpenLoopOptions::Arrivals arrivals);
+
+    private:
+        OpenLoopGenerator(const OpenLoopGenerator&) = delete;
+        OpenLoopGenerator& operator=(const OpenLoopGenerator&) = delete;
+
+    private:
+        Dispatcher& dispatcher_;
+        stage::StatsProcessingFunctor& stats_;
+        std::size_t& sequenceNumber_;
+
+        std::mt19937_64 engine_;
+    };
+}
@@ -3,6 +3,8 @@
 
 namespace queue_stress {
 
-    using TimePoint = std::chrono::time_point<std::chrono::high_resolution_clock>;
+    // steady, so the open-loop generator can pace against it.
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::time_point<Clock>;
 
 }
@@ -1,6 +1,7 @@
 #pragma once 
 #include <queue_stress/Message.hpp>
 #include <queue_stress/ProcessingFunctorBase.hpp>
+#include <queue_stress/TimePoint.hpp>
 
 #include <cstddef>
 
@@ -14,11 +15,26 @@ namespace queue_stress { namespace message {
         {
         }
 
+        // @intendedSendTime is when the open-loop generator scheduled
+        // the message to be sent, which may be earlier than when it
+        // was actually sent if the generator fell behind.
+        TestMessage(const std::size_t sequenceNumber, const TimePoint intendedSendTime)
+            : sequenceNumber_(sequenceNumber)
+            , intendedSendTime_(intendedSendTime)
+        {
+        }
+
         std::size_t sequenceNumber()
         {
             return sequenceNumber_;
         }
 
+        // the epoch if the message was not sent by the open-loop generator.
+        TimePoint intendedSendTime() const
+        {
+            return intendedSendTime_;
+        }
+
         void processWith(ProcessingFunctorBase& pf) override 
         {
             pf(*this);
@@ -26,5 +42,6 @@ namespace queue_stress { namespace message {
 
     private:
         std::size_t sequenceNumber_;
+        TimePoint intendedSendTime_;
     };
 }}
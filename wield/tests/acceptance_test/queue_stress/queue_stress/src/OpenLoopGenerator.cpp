@@ -0,0 +1,193 @@
+#include <queue_stress/OpenLoopGenerator.hpp>
+
+#include <queue_stress/message/TestMessage.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace queue_stress {
+
+    namespace {
+
+        std::int64_t percentile(const std::vector<std::int64_t>& sorted, const double p)
+        {
+            if(sorted.empty())
+            {
+                return 0;
+            }
+
+            const std::size_t index = static_cast<std::size_t>(p * sorted.size());
+            return sorted[std::min(index, sorted.size() - 1)];
+        }
+    }
+
+    OpenLoopOptions::OpenLoopOptions()
+        : arrivals(Arrivals::Constant)
+        , rates({ 100000, 200000, 400000, 800000, 1600000 })
+        , duration(5)
+    {
+    }
+
+    bool OpenLoopOptions::parse(int argc, char* argv[], bool& openLoop, std::ostream& error)
+    {
+        openLoop = false;
+
+        for(int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto equals = argument.find('=');
+            const std::string key = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+            bool valid = true;
+            if(key == "--open-loop")
+            {
+                openLoop = true;
+            }
+            else if(key == "--rates")
+            {
+                rates.clear();
+
+                std::istringstream is(value);
+                std::string rate;
+                while(std::getline(is, rate, ','))
+                {
+                    char* end = nullptr;
+                    const double r = std::strtod(rate.c_str(), &end);
+                    valid = valid && !rate.empty() && *end == '\0' && r > 0;
+                    rates.push_back(r);
+                }
+                valid = valid && !rates.empty();
+            }
+            else if(key == "--duration")
+            {
+                char* end = nullptr;
+                const long seconds = std::strtol(value.c_str(), &end, 10);
+                valid = !value.empty() && *end == '\0' && seconds > 0;
+                duration = std::chrono::seconds(seconds);
+            }
+            else if(key == "--arrivals")
+            {
+                valid = value == "constant" || value == "poisson";
+                arrivals = value == "poisson" ? Arrivals::Poisson : Arrivals::Constant;
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if(!valid)
+            {
+                error << "invalid option: " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void OpenLoopOptions::usage(std::ostream& os)
+    {
+        os << "usage: queue_stress                       closed loop, as fast as possible\n"
+           << "       queue_stress --open-loop [options] open loop rate sweep\n"
+           << "  --rates=100000,200000,400000  offered rates, messages per second\n"
+           << "  --duration=5                  seconds per rate\n"
+           << "  --arrivals=constant           constant|poisson" << std::endl;
+    }
+
+    void writeHeader(std::ostream& os)
+    {
+        os << "offered_rate,achieved_rate,sent,dropped,max_send_lag_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns" << std::endl;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const RatePoint& point)
+    {
+        return os << point.offeredRate << ',' << point.achievedRate << ','
+                  << point.sent << ',' << point.dropped << ',' << point.maxSendLag << ','
+                  << point.p50 << ',' << point.p90 << ',' << point.p99 << ',' << point.p999 << ',' << point.max;
+    }
+
+    OpenLoopGenerator::OpenLoopGenerator(Dispatcher& dispatcher, stage::StatsProcessingFunctor& stats, std::size_t& sequenceNumber)
+        : dispatcher_(dispatcher)
+        , stats_(stats)
+        , sequenceNumber_(sequenceNumber)
+        , engine_(std::random_device()())
+    {
+    }
+
+    RatePoint OpenLoopGenerator::run(const double rate, const std::chrono::seconds duration, const OpenLoopOptions::Arrivals arrivals)
+    {
+        const double meanGap = 1e9 / rate;       // nanoseconds
+        std::exponential_distribution<double> poisson(1.0 / meanGap);
+
+        // the pipeline is drained, clear the previous run's latencies
+        // and make room for this one's so recording never reallocates.
+        const std::size_t expected = static_cast<std::size_t>(rate * duration.count() * 1.1);
+        stats_.takeLatencies(expected);
+
+        const std::size_t processedBefore = stats_.processed();
+
+        RatePoint point;
+        point.offeredRate = rate;
+        point.sent = 0;
+        point.dropped = 0;
+        point.maxSendLag = 0;
+
+        const TimePoint start = Clock::now();
+        const TimePoint stop = start + duration;
+
+        // the schedule is kept in double nanoseconds from start so constant
+        // gaps which are not a whole number of nanoseconds don't drift.
+        double offset = 0;
+        TimePoint intended = start;
+
+        while(intended < stop)
+        {
+            TimePoint now = Clock::now();
+            while(now < intended)
+            {
+                now = Clock::now();
+            }
+
+            point.maxSendLag = std::max<std::int64_t>(point.maxSendLag, std::chrono::duration_cast<std::chrono::nanoseconds>(now - intended).count());
+
+            try
+            {
+                message::TestMessage::smartptr message(new message::TestMessage(sequenceNumber_++, intended));
+                dispatcher_.dispatch(Stages::Stage1, *message);
+                point.sent++;
+            }
+            catch(const std::exception&)
+            {
+                point.dropped++;
+            }
+
+            offset += arrivals == OpenLoopOptions::Arrivals::Poisson ? poisson(engine_) : meanGap;
+            intended = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::nano>(offset));
+        }
+
+        // wait for every message sent to reach the last stage.
+        while(stats_.processed() - processedBefore < point.sent)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const TimePoint drained = Clock::now();
+        point.achievedRate = point.sent / std::chrono::duration<double>(drained - start).count();
+
+        std::vector<std::int64_t> latencies = stats_.takeLatencies(0);
+        std::sort(begin(latencies), end(latencies));
+
+        point.p50 = percentile(latencies, 0.50);
+        point.p90 = percentile(latencies, 0.90);
+        point.p99 = percentile(latencies, 0.99);
+        point.p999 = percentile(latencies, 0.999);
+        point.max = latencies.empty() ? 0 : latencies.back();
+
+        return point;
+    }
+}
@@ -3,6 +3,7 @@
 #include <thread>
 #include <boost/timer/timer.hpp>
 
+#include <queue_stress/OpenLoopGenerator.hpp>
 #include <queue_stress/Traits.hpp>
 
 #include <queue_stress/stage/ForwardingProcessingFunctor.hpp>
@@ -11,10 +12,18 @@
 void createMessage(queue_stress::Traits::Dispatcher& dispatcher, const std::size_t sequenceNumber);
 void tryCreateMessage(queue_stress::Traits::Dispatcher& dispatcher, const std::size_t sequenceNumber);
 
-int main() 
+int main(int argc, char* argv[]) 
 {
     using namespace queue_stress;
 
+    bool openLoop = false;
+    OpenLoopOptions openLoopOptions;
+    if(!openLoopOptions.parse(argc, argv, openLoop, std::cerr))
+    {
+        OpenLoopOptions::usage(std::cerr);
+        return 1;
+    }
+
     using Dispatcher = Traits::Dispatcher;
     using Message = Traits::Message;
     using Scheduler = Traits::Scheduler;
@@ -44,6 +53,22 @@ int main()
     Scheduler scheduler(dispatcher);
     scheduler.start();
 
+    if(openLoop)
+    {
+        OpenLoopGenerator generator(dispatcher, stats, sequenceNumber);
+
+        writeHeader(std::cout);
+        for(const auto rate : openLoopOptions.rates)
+        {
+            std::cout << generator.run(rate, openLoopOptions.duration, openLoopOptions.arrivals) << std::endl;
+        }
+
+        scheduler.stop();
+        scheduler.join();
+
+        return 0;
+    }
+
     boost::timer::cpu_timer timer;
     while(sequenceNumber < 100000000)
     {
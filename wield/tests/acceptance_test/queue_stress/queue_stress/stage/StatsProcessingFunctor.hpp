@@ -4,8 +4,11 @@
 
 #include <queue_stress/message/TestMessage.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 namespace queue_stress { namespace stage {
 
@@ -14,20 +17,52 @@ namespace queue_stress { namespace stage {
     public:
         StatsProcessingFunctor()
             : count_(0)
+            , processed_(0)
         {
         }
 
-        void operator()(message::TestMessage&) override
+        void operator()(message::TestMessage& message) override
         {
             // if we don't do any logic here,
             // we actually run slower because
             // of the effect of cache-line ping-pong
             // on the message reference count.
             count_++;
+
+            // messages from the open-loop generator carry the time they were
+            // meant to be sent, measuring from it rather than from the actual
+            // send time keeps generator stalls in the latency figures.
+            if(message.intendedSendTime() != TimePoint())
+            {
+                const auto latency = Clock::now() - message.intendedSendTime();
+                latencies_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+            }
+
+            processed_.store(count_, std::memory_order_release);
+        }
+
+        // number of messages processed, safe to call from any thread.
+        std::size_t processed() const
+        {
+            return processed_.load(std::memory_order_acquire);
+        }
+
+        // hand over the recorded latencies (nanoseconds) and start afresh.
+        // Only call once every message sent has been processed.
+        std::vector<std::int64_t> takeLatencies(const std::size_t reserveForNext)
+        {
+            std::vector<std::int64_t> latencies;
+            latencies.swap(latencies_);
+
+            latencies_.reserve(reserveForNext);
+            return latencies;
         }
 
     private:
         static const std::size_t ReportInterval = 1000000;
         std::size_t count_;
+
+        std::atomic<std::size_t> processed_;
+        std::vector<std::int64_t> latencies_;
     };
 }}
@@ -0,0 +1,149 @@
+#pragma once
+#include <scheduler_benchmark/Graph.hpp>
+#include <scheduler_benchmark/Options.hpp>
+#include <scheduler_benchmark/Result.hpp>
+#include <scheduler_benchmark/Traits.hpp>
+
+#include <scheduler_benchmark/message/BenchmarkMessage.hpp>
+#include <scheduler_benchmark/stage/RoutingProcessingFunctor.hpp>
+#include <scheduler_benchmark/stage/SinkProcessingFunctor.hpp>
+
+#include <wield/SchedulerBase.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace scheduler_benchmark {
+
+    namespace details {
+
+        // wait until @outstanding is at most @limit.
+        // @return false if @outstanding did not change for @stallTimeout.
+        inline bool waitForOutstanding(const std::atomic<std::size_t>& outstanding, const std::size_t limit, const std::chrono::seconds stallTimeout)
+        {
+            std::size_t last = outstanding.load(std::memory_order_acquire);
+            TimePoint lastProgress = Clock::now();
+
+            while(last > limit)
+            {
+                std::this_thread::yield();
+
+                const std::size_t current = outstanding.load(std::memory_order_acquire);
+                if(current != last)
+                {
+                    last = current;
+                    lastProgress = Clock::now();
+                }
+                else if(Clock::now() - lastProgress > stallTimeout)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    // Run options.messages through @graph under the scheduling policy of @Setup.
+    //
+    // The run is closed loop: at most @window messages are in the graph at
+    // any time, so we measure the scheduler rather than the depth of its
+    // queues. Messages are injected at the graph's source from the calling
+    // thread, and the run ends once every arrival has reached the sink.
+    // A run which stops making progress for options.stallTimeout (e.g. a
+    // policy that never visits one of the graph's stages) is abandoned and
+    // reported as stalled.
+    template<class Setup>
+    Result runBenchmark(const Graph& graph, const Options& options, const std::size_t maxNumberOfThreads)
+    {
+        using Dispatcher = typename Setup::Dispatcher;
+        using Scheduler = wield::SchedulerBase<typename Setup::SchedulingPolicy, wield::details::PolicyIsExternalToScheduler>;
+        using Queue = Traits::Queue;
+        using Stage = Traits::Stage;
+        using RoutingProcessingFunctor = stage::RoutingProcessingFunctor<Dispatcher>;
+
+        const std::size_t messages = options.messages;
+        const ServiceTime& serviceTime = options.serviceTime;
+
+        Setup setup(maxNumberOfThreads);
+
+        const std::size_t arrivalsPerMessage = graph.arrivalsPerMessage();
+        std::atomic<std::size_t> outstanding(0);
+
+        std::array<Queue, NumberOfStages> queues;
+        std::vector<std::unique_ptr<RoutingProcessingFunctor>> routers;
+        stage::SinkProcessingFunctor sink(outstanding, messages * arrivalsPerMessage);
+
+        // every stage is registered, whether or not the graph uses it.
+        std::vector<std::unique_ptr<Stage>> stages;
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            const Stages name = static_cast<Stages>(s);
+            if(name == Graph::Sink)
+            {
+                stages.emplace_back(new Stage(name, setup.dispatcher_, queues[s], sink));
+            }
+            else
+            {
+                routers.emplace_back(new RoutingProcessingFunctor(setup.dispatcher_, graph.routes[s], graph.laps, serviceTime, s + 1));
+                stages.emplace_back(new Stage(name, setup.dispatcher_, queues[s], *routers.back()));
+            }
+        }
+
+        Scheduler scheduler(setup.policy_);
+        scheduler.start();
+
+        const std::clock_t cpuStart = std::clock();
+        const TimePoint start = Clock::now();
+
+        bool stalled = false;
+
+        const std::size_t maxOutstanding = options.window * arrivalsPerMessage;
+        for(std::size_t m = 0; m < messages && !stalled; ++m)
+        {
+            if(!details::waitForOutstanding(outstanding, maxOutstanding - arrivalsPerMessage, options.stallTimeout))
+            {
+                stalled = true;
+                break;
+            }
+
+            outstanding.fetch_add(arrivalsPerMessage, std::memory_order_relaxed);
+
+            Traits::Message::smartptr message(new message::BenchmarkMessage(Clock::now()));
+            setup.dispatcher_.dispatch(Graph::Source, *message);
+        }
+
+        stalled = stalled || !details::waitForOutstanding(outstanding, 0, options.stallTimeout);
+
+        const TimePoint end = Clock::now();
+        const std::clock_t cpuEnd = std::clock();
+
+        scheduler.stop();
+        setup.wake();
+        scheduler.join();
+
+        Result result;
+        result.scheduler = Setup::name();
+        result.graph = Graph::name(graph.shape);
+        result.serviceTime = serviceTime.toString();
+        result.threads = setup.policy_.numberOfThreads();
+        result.messages = messages;
+        result.arrivals = sink.latencies().size();
+        result.stalled = stalled;
+
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        result.throughput = result.seconds > 0 ? result.arrivals / result.seconds : 0;
+
+        const double cpuSeconds = static_cast<double>(cpuEnd - cpuStart) / CLOCKS_PER_SEC;
+        result.cpuUtilization = result.seconds > 0 ? cpuSeconds / (result.seconds * result.threads) : 0;
+
+        result.summarizeLatencies(sink.latencies());
+
+        return result;
+    }
+}
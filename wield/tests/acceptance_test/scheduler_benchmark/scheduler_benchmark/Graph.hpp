@@ -0,0 +1,57 @@
+#pragma once
+#include <scheduler_benchmark/Stages.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace scheduler_benchmark {
+
+    // Where a stage sends each message it processes.
+    struct Route
+    {
+        Route();
+
+        // the message is dispatched to every stage in @next (one
+        // stage is a pipeline step, several stages a fanout).
+        std::vector<Stages> next;
+
+        // if set, the message returns to @loopTo until it has made
+        // Graph::laps laps, then continues to @next.
+        bool loops;
+        Stages loopTo;
+    };
+
+    // A benchmark stage graph. Messages are injected at Stage1 and every
+    // path through the graph ends at the sink, Stage8.
+    struct Graph
+    {
+        enum class Shape
+        {
+            Linear,         // Stage1 -> Stage2 -> ... -> Stage8
+            FanOutFanIn,    // Stage1 -> {Stage2..Stage7} -> Stage8
+            Diamond,        // Stage1 -> {Stage2, Stage3} -> Stage4 -> {Stage5, Stage6} -> Stage7 -> Stage8
+            Cyclic          // Stage1 -> Stage2 -> Stage3 -> Stage4 -> (Stage2 x laps) -> Stage8
+        };
+
+        static const Stages Source = Stages::Stage1;
+        static const Stages Sink = Stages::Stage8;
+
+        // @laps is only used by the cyclic shape.
+        static Graph create(const Shape shape, const std::size_t laps);
+
+        // parse a shape name ("linear", "fanout", "diamond" or "cyclic").
+        // @return false if @name is not a known shape.
+        static bool parse(const std::string& name, Shape& shape);
+
+        static const char* name(const Shape shape);
+
+        // number of times each injected message reaches the sink.
+        std::size_t arrivalsPerMessage() const;
+
+        Shape shape;
+        std::size_t laps;
+        std::array<Route, NumberOfStages> routes;
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <scheduler_benchmark/Traits.hpp>
+
+namespace scheduler_benchmark {
+
+    using Message = Traits::Message;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <scheduler_benchmark/Graph.hpp>
+#include <scheduler_benchmark/Result.hpp>
+#include <scheduler_benchmark/ServiceTime.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace scheduler_benchmark {
+
+    // Command line options, every run is the cross product of
+    // schedulers x graphs x threads.
+    //
+    //   --scheduler=round_robin,random_visit,srpt,color,color_minus,thread_per_stage
+    //   --graph=linear,fanout,diamond,cyclic
+    //   --threads=1,2,4,8                at most one thread per stage
+    //   --service=constant:1000        (constant|exponential|uniform):<mean ns>
+    //   --messages=100000              messages injected per run
+    //   --window=1024                  messages in flight (closed loop)
+    //   --laps=4                       laps made by the cyclic graph
+    //   --stall-timeout=10             seconds without progress before a run is abandoned
+    //   --format=json                  json|csv
+    struct Options
+    {
+        Options();
+
+        // @return false (after writing the reason to @error) if
+        // @argv contains an unknown or malformed option.
+        bool parse(int argc, char* argv[], std::ostream& error);
+
+        static void usage(std::ostream& os);
+
+        std::vector<std::string> schedulers;
+        std::vector<Graph::Shape> graphs;
+        std::vector<std::size_t> threads;
+
+        ServiceTime serviceTime;
+
+        std::size_t messages;
+        std::size_t window;
+        std::size_t laps;
+        std::chrono::seconds stallTimeout;
+
+        Format format;
+    };
+}
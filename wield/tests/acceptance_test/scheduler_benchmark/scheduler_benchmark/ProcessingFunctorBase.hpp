@@ -0,0 +1,18 @@
+#pragma once
+#include <scheduler_benchmark/Message.hpp>
+
+namespace scheduler_benchmark { namespace message {
+    class BenchmarkMessage;
+}}
+
+namespace scheduler_benchmark {
+
+    class ProcessingFunctorBase
+    {
+    public:
+        virtual ~ProcessingFunctorBase(){}
+
+        virtual void operator()(Message&){}
+        virtual void operator()(message::BenchmarkMessage&){}
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace scheduler_benchmark {
+
+    // The measurements of one (scheduler, graph, thread count) run.
+    struct Result
+    {
+        std::string scheduler;
+        std::string graph;
+        std::string serviceTime;
+
+        std::size_t threads;
+        std::size_t messages;
+        std::size_t arrivals;       // sink arrivals, fewer than expected if stalled
+        bool stalled;
+
+        double seconds;
+        double throughput;          // sink arrivals per second
+
+        // end-to-end latency in nanoseconds, injection to sink.
+        std::int64_t p50;
+        std::int64_t p90;
+        std::int64_t p99;
+        std::int64_t p999;
+        std::int64_t max;
+
+        // process cpu time over (wall time * threads), can exceed 1.0
+        // slightly since the injecting thread is counted too.
+        double cpuUtilization;
+
+        // fill in the latency fields from @latencies (sorted in place).
+        void summarizeLatencies(std::vector<std::int64_t>& latencies);
+    };
+
+    enum class Format
+    {
+        Json,       // one JSON object per line
+        Csv
+    };
+
+    void writeHeader(std::ostream& os, const Format format);
+    void write(std::ostream& os, const Format format, const Result& result);
+}
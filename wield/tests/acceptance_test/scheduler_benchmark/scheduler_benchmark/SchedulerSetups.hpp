@@ -0,0 +1,156 @@
+#pragma once
+#include <scheduler_benchmark/Traits.hpp>
+
+#include <wield/DispatcherBase.hpp>
+#include <wield/schedulers/RandomVisit.hpp>
+#include <wield/schedulers/RoundRobin.hpp>
+#include <wield/schedulers/SRPT.hpp>
+#include <wield/schedulers/ThreadPerStage.hpp>
+#include <wield/schedulers/color/Color.hpp>
+#include <wield/schedulers/color/Dispatcher.hpp>
+#include <wield/schedulers/color_minus/ColorMinus.hpp>
+#include <wield/schedulers/color_minus/Dispatcher.hpp>
+
+#include <cstddef>
+
+namespace scheduler_benchmark {
+
+    // Each setup owns the dispatcher and scheduling policy for one of the
+    // scheduling policies under test, plus whatever state the pair shares.
+    // The scheduler is given a reference to the policy so the benchmark
+    // can ask the policy how many threads it actually runs.
+    //
+    // @maxNumberOfThreads is an upper bound, the policies cap it at the
+    // number of hardware cores.
+    //
+    // wake() is called after the scheduler is stopped, it must make sure
+    // every scheduler thread returns from nextStage() so it can be joined.
+
+    struct RoundRobinSetup
+    {
+        using Dispatcher = wield::DispatcherBase<Stages, Traits::Stage>;
+        using SchedulingPolicy = wield::schedulers::RoundRobin<Dispatcher, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "round_robin"; }
+
+        RoundRobinSetup(const std::size_t maxNumberOfThreads)
+            : policy_(dispatcher_, SchedulingPolicy::MaxThreads(), maxNumberOfThreads)
+        {
+        }
+
+        void wake() {}
+
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+
+    struct RandomVisitSetup
+    {
+        using Dispatcher = wield::DispatcherBase<Stages, Traits::Stage>;
+        using SchedulingPolicy = wield::schedulers::RandomVisit<Dispatcher, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "random_visit"; }
+
+        RandomVisitSetup(const std::size_t maxNumberOfThreads)
+            : policy_(dispatcher_, SchedulingPolicy::MaxThreads(), maxNumberOfThreads)
+        {
+        }
+
+        void wake() {}
+
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+
+    struct SRPTSetup
+    {
+        using Dispatcher = wield::DispatcherBase<Stages, Traits::Stage>;
+        using SchedulingPolicy = wield::schedulers::SRPT<Dispatcher, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "srpt"; }
+
+        SRPTSetup(const std::size_t maxNumberOfThreads)
+            : policy_(dispatcher_, SchedulingPolicy::MaxThreads(), maxNumberOfThreads)
+        {
+        }
+
+        void wake() {}
+
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+
+    struct ColorSetup
+    {
+        using StageNameQueue = Concurrency::concurrent_queue<Stages>;
+        using Dispatcher = wield::schedulers::color::Dispatcher<Stages, Traits::Stage, StageNameQueue>;
+        using SchedulingPolicy = wield::schedulers::color::Color<Dispatcher, StageNameQueue, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "color"; }
+
+        ColorSetup(const std::size_t maxNumberOfThreads)
+            : dispatcher_(stageNameQueue_)
+            , policy_(dispatcher_, stageNameQueue_, maxNumberOfThreads)
+        {
+        }
+
+        // Color threads wait in nextStage() until a stage name is enqueued.
+        // A thread that can't be assigned to a stage sets the name aside
+        // until the stage's visitor leaves, so enqueue every stage once
+        // per thread.
+        void wake()
+        {
+            for(std::size_t t = 0; t < policy_.numberOfThreads(); ++t)
+            {
+                for(std::size_t s = 0; s < NumberOfStages; ++s)
+                {
+                    stageNameQueue_.push(static_cast<Stages>(s));
+                }
+            }
+        }
+
+        StageNameQueue stageNameQueue_;
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+
+    struct ColorMinusSetup
+    {
+        using Dispatcher = wield::schedulers::color_minus::Dispatcher<Stages, Traits::Stage>;
+        using SchedulingPolicy = wield::schedulers::color_minus::ColorMinus<Dispatcher, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "color_minus"; }
+
+        ColorMinusSetup(const std::size_t maxNumberOfThreads)
+            : dispatcher_(stats_)
+            , policy_(dispatcher_, stats_, maxNumberOfThreads)
+        {
+        }
+
+        void wake() {}
+
+        Dispatcher::MessageCount stats_;
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+
+    // ThreadPerStage always runs one thread per stage,
+    // @maxNumberOfThreads is ignored.
+    struct ThreadPerStageSetup
+    {
+        using Dispatcher = wield::DispatcherBase<Stages, Traits::Stage>;
+        using SchedulingPolicy = wield::schedulers::ThreadPerStage<Dispatcher, Traits::ApplicationTraits::PollingPolicy>;
+
+        static const char* name() { return "thread_per_stage"; }
+
+        ThreadPerStageSetup(const std::size_t)
+            : policy_(dispatcher_)
+        {
+        }
+
+        void wake() {}
+
+        Dispatcher dispatcher_;
+        SchedulingPolicy policy_;
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <scheduler_benchmark/TimePoint.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace scheduler_benchmark {
+
+    // The per-message work done at each stage, a busy spin whose
+    // duration is drawn from @distribution with mean @mean.
+    struct ServiceTime
+    {
+        enum class Distribution
+        {
+            Constant,
+            Exponential,
+            Uniform         // uniform on [0, 2 * mean]
+        };
+
+        Distribution distribution;
+        std::chrono::nanoseconds mean;
+
+        // parse "<distribution>:<mean nanoseconds>", e.g. "exponential:2000".
+        // @return false if @text is not a valid service time.
+        static bool parse(const std::string& text, ServiceTime& serviceTime);
+
+        std::string toString() const;
+    };
+
+    // Draws service times for a single stage. Each stage owns one, stages
+    // are visited by one thread at a time so no locking is required.
+    class ServiceTimeGenerator
+    {
+    public:
+        ServiceTimeGenerator(const ServiceTime& serviceTime, const std::uint64_t seed);
+
+        std::chrono::nanoseconds next();
+
+        // spin for the next service time. We spin rather than sleep so
+        // the thread stays busy, as it would doing real work.
+        void spin();
+
+    private:
+        const ServiceTime serviceTime_;
+        std::mt19937_64 engine_;
+        std::exponential_distribution<double> exponential_;
+        std::uniform_real_distribution<double> uniform_;
+    };
+
+
+    inline
+    ServiceTimeGenerator::ServiceTimeGenerator(const ServiceTime& serviceTime, const std::uint64_t seed)
+        : serviceTime_(serviceTime)
+        , engine_(seed)
+        , exponential_(1.0)
+        , uniform_(0.0, 2.0)
+    {
+    }
+
+    inline
+    std::chrono::nanoseconds ServiceTimeGenerator::next()
+    {
+        const double mean = static_cast<double>(serviceTime_.mean.count());
+
+        switch(serviceTime_.distribution)
+        {
+        case ServiceTime::Distribution::Exponential:
+            return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(mean * exponential_(engine_)));
+
+        case ServiceTime::Distribution::Uniform:
+            return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(mean * uniform_(engine_)));
+
+        case ServiceTime::Distribution::Constant:
+        default:
+            return serviceTime_.mean;
+        }
+    }
+
+    inline
+    void ServiceTimeGenerator::spin()
+    {
+        const auto duration = next();
+        if(duration.count() <= 0)
+        {
+            return;
+        }
+
+        const auto until = Clock::now() + duration;
+        while(Clock::now() < until)
+        {
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace scheduler_benchmark {
+
+    // Every graph shape is laid out over the same eight stages so each
+    // scheduling policy sees an identical stage enum. Stages a graph does
+    // not route to stay registered but never receive a message.
+    enum class Stages : std::uint8_t
+    {
+        Stage1,
+        Stage2,
+        Stage3,
+        Stage4,
+        Stage5,
+        Stage6,
+        Stage7,
+        Stage8,
+
+        NumberOfEntries
+    };
+
+    static const std::size_t NumberOfStages = static_cast<std::size_t>(Stages::NumberOfEntries);
+}
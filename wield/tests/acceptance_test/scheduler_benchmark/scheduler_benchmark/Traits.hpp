@@ -0,0 +1,32 @@
+#pragma once
+#include <wield/Traits.hpp>
+#include <wield/schedulers/RoundRobin.hpp>
+#include <wield/polling_policies/ExhaustivePollingPolicy.hpp>
+
+#include <scheduler_benchmark/Stages.hpp>
+#include <scheduler_benchmark/platform/ConcurrentQueue.hpp>
+
+namespace scheduler_benchmark {
+
+    class ProcessingFunctorBase;
+
+    // NOTE: only the Message, Queue and Stage types are shared by every
+    // run. Each scheduling policy under test brings its own dispatcher
+    // and policy type (see SchedulerSetups.hpp), Traits::Dispatcher and
+    // Traits::Scheduler are unused.
+    struct AppTraits
+    {
+        using StageEnumType = Stages;
+        using ProcessingFunctor = ProcessingFunctorBase;
+
+        template<class MessagePtrType>
+        using QueueType = Concurrency::concurrent_queue<MessagePtrType>;
+
+        using PollingPolicy = wield::polling_policies::ExhaustivePollingPolicy<StageEnumType>;
+
+        template<class Dispatcher>
+        using SchedulingPolicy = wield::schedulers::RoundRobin<Dispatcher, PollingPolicy>;
+    };
+
+    using Traits = wield::Traits<AppTraits>;
+}
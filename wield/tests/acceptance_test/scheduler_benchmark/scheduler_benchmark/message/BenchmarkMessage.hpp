@@ -0,0 +1,35 @@
+#pragma once
+#include <scheduler_benchmark/Message.hpp>
+#include <scheduler_benchmark/ProcessingFunctorBase.hpp>
+#include <scheduler_benchmark/TimePoint.hpp>
+
+#include <cstddef>
+
+namespace scheduler_benchmark { namespace message {
+
+    class BenchmarkMessage : public Message
+    {
+    public:
+        BenchmarkMessage(const TimePoint injected)
+            : injected_(injected)
+            , laps_(0)
+        {
+        }
+
+        // the time the message was handed to the first stage.
+        TimePoint injected() const { return injected_; }
+
+        // number of times the message went around a cycle in the graph.
+        std::size_t laps() const { return laps_; }
+        void completeLap() { laps_++; }
+
+        void processWith(ProcessingFunctorBase& pf) override
+        {
+            pf(*this);
+        }
+
+    private:
+        const TimePoint injected_;
+        std::size_t laps_;
+    };
+}}
@@ -0,0 +1,108 @@
+#include <scheduler_benchmark/Graph.hpp>
+
+namespace scheduler_benchmark {
+
+    const Stages Graph::Source;
+    const Stages Graph::Sink;
+
+    Route::Route()
+        : loops(false)
+        , loopTo(Stages::Stage1)
+    {
+    }
+
+    Graph Graph::create(const Shape shape, const std::size_t laps)
+    {
+        Graph graph;
+        graph.shape = shape;
+        graph.laps = laps;
+
+        auto& routes = graph.routes;
+        auto route = [&routes](const Stages from) -> Route& { return routes[static_cast<std::size_t>(from)]; };
+
+        switch(shape)
+        {
+        case Shape::Linear:
+            for(std::size_t s = 0; s + 1 < NumberOfStages; ++s)
+            {
+                routes[s].next.push_back(static_cast<Stages>(s + 1));
+            }
+            break;
+
+        case Shape::FanOutFanIn:
+            for(std::size_t s = 1; s + 1 < NumberOfStages; ++s)
+            {
+                route(Source).next.push_back(static_cast<Stages>(s));
+                routes[s].next.push_back(Sink);
+            }
+            break;
+
+        case Shape::Diamond:
+            route(Stages::Stage1).next = { Stages::Stage2, Stages::Stage3 };
+            route(Stages::Stage2).next = { Stages::Stage4 };
+            route(Stages::Stage3).next = { Stages::Stage4 };
+            route(Stages::Stage4).next = { Stages::Stage5, Stages::Stage6 };
+            route(Stages::Stage5).next = { Stages::Stage7 };
+            route(Stages::Stage6).next = { Stages::Stage7 };
+            route(Stages::Stage7).next = { Sink };
+            break;
+
+        case Shape::Cyclic:
+            route(Stages::Stage1).next = { Stages::Stage2 };
+            route(Stages::Stage2).next = { Stages::Stage3 };
+            route(Stages::Stage3).next = { Stages::Stage4 };
+            route(Stages::Stage4).next = { Sink };
+            route(Stages::Stage4).loops = true;
+            route(Stages::Stage4).loopTo = Stages::Stage2;
+            break;
+        }
+
+        return graph;
+    }
+
+    bool Graph::parse(const std::string& name, Shape& shape)
+    {
+        for(const auto candidate : { Shape::Linear, Shape::FanOutFanIn, Shape::Diamond, Shape::Cyclic })
+        {
+            if(name == Graph::name(candidate))
+            {
+                shape = candidate;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const char* Graph::name(const Shape shape)
+    {
+        switch(shape)
+        {
+        case Shape::Linear:         return "linear";
+        case Shape::FanOutFanIn:    return "fanout";
+        case Shape::Diamond:        return "diamond";
+        case Shape::Cyclic:         return "cyclic";
+        }
+
+        return "unknown";
+    }
+
+    std::size_t Graph::arrivalsPerMessage() const
+    {
+        // count the paths from the source to the sink, stages are
+        // numbered in topological order (ignoring the cycle, which
+        // does not change the number of paths).
+        std::array<std::size_t, NumberOfStages> paths{};
+        paths[static_cast<std::size_t>(Source)] = 1;
+
+        for(std::size_t s = 0; s < NumberOfStages; ++s)
+        {
+            for(const auto next : routes[s].next)
+            {
+                paths[static_cast<std::size_t>(next)] += paths[s];
+            }
+        }
+
+        return paths[static_cast<std::size_t>(Sink)];
+    }
+}
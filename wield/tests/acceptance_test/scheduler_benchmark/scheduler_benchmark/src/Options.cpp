@@ -0,0 +1,154 @@
+#include <scheduler_benchmark/Options.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace scheduler_benchmark {
+
+    namespace {
+
+        const char* const AllSchedulers[] = { "round_robin", "random_visit", "srpt", "color", "color_minus", "thread_per_stage" };
+
+        std::vector<std::string> split(const std::string& text)
+        {
+            std::vector<std::string> items;
+            std::istringstream is(text);
+            std::string item;
+            while(std::getline(is, item, ','))
+            {
+                if(!item.empty())
+                {
+                    items.push_back(item);
+                }
+            }
+            return items;
+        }
+
+        bool parseCount(const std::string& text, std::size_t& count)
+        {
+            char* end = nullptr;
+            const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+            if(text.empty() || *end != '\0' || value == 0)
+            {
+                return false;
+            }
+
+            count = static_cast<std::size_t>(value);
+            return true;
+        }
+    }
+
+    Options::Options()
+        : schedulers(std::begin(AllSchedulers), std::end(AllSchedulers))
+        , graphs({ Graph::Shape::Linear, Graph::Shape::FanOutFanIn, Graph::Shape::Diamond, Graph::Shape::Cyclic })
+        , threads({ 1, 2, 4, 8 })
+        , messages(100000)
+        , window(1024)
+        , laps(4)
+        , stallTimeout(10)
+        , format(Format::Json)
+    {
+        serviceTime.distribution = ServiceTime::Distribution::Constant;
+        serviceTime.mean = std::chrono::nanoseconds(1000);
+    }
+
+    bool Options::parse(int argc, char* argv[], std::ostream& error)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto equals = argument.find('=');
+            const std::string key = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+            bool valid = true;
+            if(key == "--scheduler")
+            {
+                schedulers = split(value);
+                for(const auto& scheduler : schedulers)
+                {
+                    valid = valid && std::find(std::begin(AllSchedulers), std::end(AllSchedulers), scheduler) != std::end(AllSchedulers);
+                }
+                valid = valid && !schedulers.empty();
+            }
+            else if(key == "--graph")
+            {
+                graphs.clear();
+                for(const auto& name : split(value))
+                {
+                    Graph::Shape shape;
+                    valid = valid && Graph::parse(name, shape);
+                    graphs.push_back(shape);
+                }
+                valid = valid && !graphs.empty();
+            }
+            else if(key == "--threads")
+            {
+                threads.clear();
+                for(const auto& count : split(value))
+                {
+                    std::size_t n = 0;
+                    // every stage has a maximum concurrency of one,
+                    // threads beyond the number of stages would only idle.
+                    valid = valid && parseCount(count, n) && n <= NumberOfStages;
+                    threads.push_back(n);
+                }
+                valid = valid && !threads.empty();
+            }
+            else if(key == "--service")
+            {
+                valid = ServiceTime::parse(value, serviceTime);
+            }
+            else if(key == "--messages")
+            {
+                valid = parseCount(value, messages);
+            }
+            else if(key == "--window")
+            {
+                valid = parseCount(value, window);
+            }
+            else if(key == "--laps")
+            {
+                valid = parseCount(value, laps);
+            }
+            else if(key == "--stall-timeout")
+            {
+                std::size_t seconds = 0;
+                valid = parseCount(value, seconds);
+                stallTimeout = std::chrono::seconds(seconds);
+            }
+            else if(key == "--format")
+            {
+                valid = value == "json" || value == "csv";
+                format = value == "csv" ? Format::Csv : Format::Json;
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if(!valid)
+            {
+                error << "invalid option: " << argument << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Options::usage(std::ostream& os)
+    {
+        os << "usage: scheduler_benchmark [options]\n"
+           << "  --scheduler=round_robin,random_visit,srpt,color,color_minus,thread_per_stage\n"
+           << "  --graph=linear,fanout,diamond,cyclic\n"
+           << "  --threads=1,2,4,8\n"
+           << "  --service=constant:1000       (constant|exponential|uniform):<mean ns>\n"
+           << "  --messages=100000\n"
+           << "  --window=1024                 messages in flight\n"
+           << "  --laps=4                      laps made by the cyclic graph\n"
+           << "  --stall-timeout=10            seconds without progress before a run is abandoned\n"
+           << "  --format=json                 json|csv" << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+#include <scheduler_benchmark/Result.hpp>
+
+#include <algorithm>
+
+namespace scheduler_benchmark {
+
+    namespace {
+
+        // @latencies must be sorted and non-empty.
+        std::int64_t percentile(const std::vector<std::int64_t>& latencies, const double p)
+        {
+            const std::size_t index = static_cast<std::size_t>(p * latencies.size());
+            return latencies[std::min(index, latencies.size() - 1)];
+        }
+    }
+
+    void Result::summarizeLatencies(std::vector<std::int64_t>& latencies)
+    {
+        if(latencies.empty())
+        {
+            p50 = p90 = p99 = p999 = max = 0;
+            return;
+        }
+
+        std::sort(begin(latencies), end(latencies));
+
+        p50 = percentile(latencies, 0.50);
+        p90 = percentile(latencies, 0.90);
+        p99 = percentile(latencies, 0.99);
+        p999 = percentile(latencies, 0.999);
+        max = latencies.back();
+    }
+
+    void writeHeader(std::ostream& os, const Format format)
+    {
+        if(format == Format::Csv)
+        {
+            os << "scheduler,graph,service_time,threads,messages,arrivals,stalled,seconds,throughput,"
+               << "p50_ns,p90_ns,p99_ns,p999_ns,max_ns,cpu_utilization" << std::endl;
+        }
+    }
+
+    void write(std::ostream& os, const Format format, const Result& r)
+    {
+        if(format == Format::Csv)
+        {
+            os << r.scheduler << ',' << r.graph << ',' << r.serviceTime << ','
+               << r.threads << ',' << r.messages << ',' << r.arrivals << ',' << (r.stalled ? "true" : "false") << ','
+               << r.seconds << ',' << r.throughput << ','
+               << r.p50 << ',' << r.p90 << ',' << r.p99 << ',' << r.p999 << ',' << r.max << ','
+               << r.cpuUtilization << std::endl;
+        }
+        else
+        {
+            os << "{\"scheduler\":\"" << r.scheduler << "\""
+               << ",\"graph\":\"" << r.graph << "\""
+               << ",\"service_time\":\"" << r.serviceTime << "\""
+               << ",\"threads\":" << r.threads
+               << ",\"messages\":" << r.messages
+               << ",\"arrivals\":" << r.arrivals
+               << ",\"stalled\":" << (r.stalled ? "true" : "false")
+               << ",\"seconds\":" << r.seconds
+               << ",\"throughput\":" << r.throughput
+               << ",\"p50_ns\":" << r.p50
+               << ",\"p90_ns\":" << r.p90
+               << ",\"p99_ns\":" << r.p99
+               << ",\"p999_ns\":" << r.p999
+               << ",\"max_ns\":" << r.max
+               << ",\"cpu_utilization\":" << r.cpuUtilization
+               << "}" << std::endl;
+        }
+    }
+}
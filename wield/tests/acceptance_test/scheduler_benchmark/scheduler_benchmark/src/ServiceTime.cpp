@@ -0,0 +1,60 @@
+#include <scheduler_benchmark/ServiceTime.hpp>
+
+#include <cstdlib>
+#include <sstream>
+
+namespace scheduler_benchmark {
+
+    namespace {
+
+        const char* name(const ServiceTime::Distribution distribution)
+        {
+            switch(distribution)
+            {
+            case ServiceTime::Distribution::Constant:       return "constant";
+            case ServiceTime::Distribution::Exponential:    return "exponential";
+            case ServiceTime::Distribution::Uniform:        return "uniform";
+            }
+
+            return "unknown";
+        }
+    }
+
+    bool ServiceTime::parse(const std::string& text, ServiceTime& serviceTime)
+    {
+        const auto separator = text.find(':');
+        if(separator == std::string::npos)
+        {
+            return false;
+        }
+
+        const std::string distribution = text.substr(0, separator);
+        const std::string mean = text.substr(separator + 1);
+
+        char* end = nullptr;
+        const long long nanoseconds = std::strtoll(mean.c_str(), &end, 10);
+        if(mean.empty() || *end != '\0' || nanoseconds < 0)
+        {
+            return false;
+        }
+
+        for(const auto candidate : { Distribution::Constant, Distribution::Exponential, Distribution::Uniform })
+        {
+            if(distribution == name(candidate))
+            {
+                serviceTime.distribution = candidate;
+                serviceTime.mean = std::chrono::nanoseconds(nanoseconds);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::string ServiceTime::toString() const
+    {
+        std::ostringstream os;
+        os << name(distribution) << ":" << mean.count();
+        return os.str();
+    }
+}
@@ -0,0 +1,60 @@
+#include <scheduler_benchmark/Benchmark.hpp>
+#include <scheduler_benchmark/Options.hpp>
+#include <scheduler_benchmark/SchedulerSetups.hpp>
+
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace {
+
+    using namespace scheduler_benchmark;
+
+    using Runner = Result(*)(const Graph&, const Options&, const std::size_t);
+
+    const std::map<std::string, Runner>& runners()
+    {
+        static const std::map<std::string, Runner> runners = {
+            { RoundRobinSetup::name(),      &runBenchmark<RoundRobinSetup> },
+            { RandomVisitSetup::name(),     &runBenchmark<RandomVisitSetup> },
+            { SRPTSetup::name(),            &runBenchmark<SRPTSetup> },
+            { ColorSetup::name(),           &runBenchmark<ColorSetup> },
+            { ColorMinusSetup::name(),      &runBenchmark<ColorMinusSetup> },
+            { ThreadPerStageSetup::name(),  &runBenchmark<ThreadPerStageSetup> },
+        };
+
+        return runners;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace scheduler_benchmark;
+
+    Options options;
+    if(!options.parse(argc, argv, std::cerr))
+    {
+        Options::usage(std::cerr);
+        return 1;
+    }
+
+    writeHeader(std::cout, options.format);
+
+    for(const auto& scheduler : options.schedulers)
+    {
+        const Runner run = runners().at(scheduler);
+
+        for(const auto shape : options.graphs)
+        {
+            const Graph graph = Graph::create(shape, options.laps);
+
+            for(const auto threads : options.threads)
+            {
+                const Result result = run(graph, options, threads);
+                write(std::cout, options.format, result);
+            }
+        }
+    }
+
+    return 0;
+}
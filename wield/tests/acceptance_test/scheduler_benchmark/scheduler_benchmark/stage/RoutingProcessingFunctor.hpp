@@ -0,0 +1,49 @@
+#pragma once
+#include <scheduler_benchmark/Graph.hpp>
+#include <scheduler_benchmark/ProcessingFunctorBase.hpp>
+#include <scheduler_benchmark/ServiceTime.hpp>
+
+#include <scheduler_benchmark/message/BenchmarkMessage.hpp>
+
+namespace scheduler_benchmark { namespace stage {
+
+    // Spins for the stage's service time then forwards the message
+    // along the stage's route. Templated on the dispatcher since the
+    // Color and Color- policies each need their own dispatcher.
+    template<class Dispatcher>
+    class RoutingProcessingFunctor : public ProcessingFunctorBase
+    {
+    public:
+        RoutingProcessingFunctor(Dispatcher& dispatcher, const Route& route, const std::size_t laps, const ServiceTime& serviceTime, const std::uint64_t seed)
+            : dispatcher_(dispatcher)
+            , route_(route)
+            , laps_(laps)
+            , serviceTime_(serviceTime, seed)
+        {
+        }
+
+        void operator()(message::BenchmarkMessage& message) override
+        {
+            serviceTime_.spin();
+
+            if(route_.loops && message.laps() < laps_)
+            {
+                message.completeLap();
+                dispatcher_.dispatch(route_.loopTo, message);
+                return;
+            }
+
+            for(const auto next : route_.next)
+            {
+                dispatcher_.dispatch(next, message);
+            }
+        }
+
+    private:
+        Dispatcher& dispatcher_;
+        const Route route_;
+        const std::size_t laps_;
+
+        ServiceTimeGenerator serviceTime_;
+    };
+}}
@@ -0,0 +1,44 @@
+#pragma once
+#include <scheduler_benchmark/ProcessingFunctorBase.hpp>
+#include <scheduler_benchmark/TimePoint.hpp>
+
+#include <scheduler_benchmark/message/BenchmarkMessage.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace scheduler_benchmark { namespace stage {
+
+    // Records the end-to-end latency of every arrival and tells the
+    // injector an arrival has left the graph.
+    //
+    // NOTE: latencies are recorded without locking, every scheduling
+    // policy is run with a maximum concurrency of one thread per stage.
+    class SinkProcessingFunctor : public ProcessingFunctorBase
+    {
+    public:
+        SinkProcessingFunctor(std::atomic<std::size_t>& outstanding, const std::size_t expectedArrivals)
+            : outstanding_(outstanding)
+        {
+            // never reallocate while the benchmark is running.
+            latencies_.reserve(expectedArrivals);
+        }
+
+        void operator()(message::BenchmarkMessage& message) override
+        {
+            const auto latency = Clock::now() - message.injected();
+            latencies_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+
+            outstanding_.fetch_sub(1, std::memory_order_release);
+        }
+
+        // latencies in nanoseconds, only read once the graph is drained.
+        std::vector<std::int64_t>& latencies() { return latencies_; }
+
+    private:
+        std::atomic<std::size_t>& outstanding_;
+        std::vector<std::int64_t> latencies_;
+    };
+}}
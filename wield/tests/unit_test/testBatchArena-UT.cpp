@@ -0,0 +1,149 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test/Traits.hpp"
+#include "./test/Message.hpp"
+#include "./test/ProcessingFunctor.hpp"
+#include "./test/Scheduler.hpp"
+
+#include <wield/memory/BatchArena.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+    using namespace test;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Message = Traits::Message;
+    using Scheduler = Traits::Scheduler;
+    using Stage = Traits::Stage;
+    using Queue = Traits::Queue;
+
+    using wield::memory::BatchArena;
+    using wield::memory::BatchArenaAllocator;
+
+    bool isAligned(const void* p, const std::size_t alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+
+    TEST(verifyBatchArenaBumpsAndResetsWholesale)
+    {
+        BatchArena arena(1024);
+
+        char* a = static_cast<char*>(arena.allocate(10, 1));
+        char* b = static_cast<char*>(arena.allocate(10, 1));
+        CHECK(b == a + 10);
+
+        void* c = arena.allocate(8, 64);
+        CHECK(isAligned(c, 64));
+        CHECK_EQUAL(28U, arena.allocated());
+
+        // too big for a block, it gets one of its own.
+        void* big = arena.allocate(4096, 16);
+        CHECK(isAligned(big, 16));
+        CHECK_EQUAL(28U + 4096U, arena.allocated());
+
+        // spill into a second block.
+        for(int i = 0; i < 200; ++i)
+        {
+            arena.allocate(8, 8);
+        }
+
+        arena.reset();
+        CHECK_EQUAL(0U, arena.allocated());
+
+        // the first block is reused.
+        CHECK(arena.allocate(10, 1) == a);
+    }
+
+    TEST(verifyContainersAllocateFromTheArena)
+    {
+        BatchArena arena;
+
+        {
+            wield::memory::BatchArenaVector<int> values{BatchArenaAllocator<int>(arena)};
+            for(int i = 0; i < 100; ++i)
+            {
+                values.push_back(i);
+            }
+
+            wield::memory::BatchArenaString text("a string which is too long to be stored in place", BatchArenaAllocator<char>(arena));
+            text += " and then some";
+
+            CHECK_EQUAL(99, values.back());
+            CHECK(text.size() > 50);
+            CHECK(arena.allocated() >= 100 * sizeof(int));
+        }
+
+        CHECK(BatchArenaAllocator<int>(arena) == BatchArenaAllocator<char>(arena));
+        CHECK(BatchArenaAllocator<int>() == BatchArenaAllocator<int>(BatchArena::current()));
+    }
+
+    // records how much of the thread's arena was in use as each message arrived.
+    class ArenaProcessingFunctor : public ProcessingFunctor
+    {
+    public:
+        ArenaProcessingFunctor()
+            : processed_(0)
+            , inUseAtEleventh_(~std::size_t(0))
+        {
+        }
+
+        void operator()(TestMessage&) override
+        {
+            BatchArena& arena = BatchArena::current();
+            if(processed_ == 10)
+            {
+                inUseAtEleventh_ = arena.allocated();
+            }
+
+            wield::memory::BatchArenaString scratch(256, 'x');
+            processed_.fetch_add(1);
+        }
+
+        std::atomic<std::size_t> processed_;
+        std::atomic<std::size_t> inUseAtEleventh_;
+    };
+
+    TEST(verifySchedulerResetsTheArenaAfterEachBatch)
+    {
+        Dispatcher d;
+        Queue q;
+        ArenaProcessingFunctor f;
+        Stage s(Stages::Stage1, d, q, f);
+
+        Scheduler scheduler(d, 1U);
+
+        Message::smartptr m = new TestMessage();
+        for(int i = 0; i < 10; ++i)
+        {
+            d.dispatch(Stages::Stage1, *m);
+        }
+
+        scheduler.start();
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(f.processed_ < 10 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+
+        // let the first batch end on the empty queue, the next one starts afresh.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        d.dispatch(Stages::Stage1, *m);
+        while(f.processed_ < 11 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+
+        scheduler.stop();
+        scheduler.join();
+
+        CHECK_EQUAL(11U, f.processed_.load());
+        CHECK_EQUAL(0U, f.inUseAtEleventh_.load());
+    }
+}
@@ -70,5 +70,44 @@ namespace {
         stage2.process();
         stage1.process();
     }
+
+    TEST(verifyAddsStageNameForEachMessageWhenBatchDispatched)
+    {
+        using namespace wield::schedulers::color;
+
+        using Message = typename test_color::Traits::Message;
+        using Stages = typename test_color::Traits::StageEnumType;
+        using Stage = typename test_color::Traits::Stage;
+        using ColorQueue = Concurrency::concurrent_queue<Stages>;
+        using Queue = typename test_color::Traits::Queue;
+
+        ColorQueue colorQueue;
+        Dispatcher<Stages, Stage, ColorQueue> dispatcher(colorQueue);
+
+        Queue q;
+        test_color::ProcessingFunctor pf;
+
+        Stage stage1(Stages::Stage1, dispatcher, q, pf);
+
+        std::array<Message::ptr, 3> batch = {{ new test_color::TestMessage(), new test_color::TestMessage(), new test_color::TestMessage() }};
+        dispatcher.dispatchBatch(Stages::Stage1, begin(batch), end(batch));
+
+        // an empty batch is not a notification.
+        dispatcher.dispatchBatch(Stages::Stage1, end(batch), end(batch));
+
+        CHECK_EQUAL(3U, q.unsafe_size());
+        CHECK_EQUAL(3U, colorQueue.unsafe_size());
+
+        Stages stage = Stages::NumberOfEntries;
+        while(colorQueue.try_pop(stage))
+        {
+            CHECK_EQUAL(Stages::Stage1, stage);
+        }
+
+        // cleanup memory in queues
+        stage1.process();
+        stage1.process();
+        stage1.process();
+    }
 }
 
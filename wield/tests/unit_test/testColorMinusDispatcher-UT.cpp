@@ -7,6 +7,8 @@
 #include "./test_color_minus/ProcessingFunctor.hpp"
 #include "./test_color_minus/Traits.hpp"
 
+#include <array>
+
 namespace {
 
     TEST(verifyColorDispatcherInstantiation)
@@ -61,5 +63,39 @@ namespace {
         stage2.process();
         stage1.process();
     }
+
+    TEST(verifyCountsEveryMessageWhenBatchDispatched)
+    {
+        using namespace wield::schedulers::color_minus;
+
+        using Dispatcher = typename test_color_minus::Traits::Dispatcher;
+        using Message = typename test_color_minus::Traits::Message;
+        using Stages = typename test_color_minus::Traits::StageEnumType;
+        using Stage = typename test_color_minus::Traits::Stage;
+        using Queue = typename test_color_minus::Traits::Queue;
+        using MessageCount = wield::schedulers::utils::MessageCount<Stages>;
+
+        MessageCount stats;
+        Dispatcher dispatcher(stats);
+        Queue q;
+        test_color_minus::ProcessingFunctor pf;
+
+        Stage stage2(Stages::Stage2, dispatcher, q, pf);
+
+        std::array<Message::ptr, 4> batch = {{
+            new test_color_minus::TestMessage(), new test_color_minus::TestMessage(),
+            new test_color_minus::TestMessage(), new test_color_minus::TestMessage() }};
+
+        dispatcher.dispatchBatch(Stages::Stage2, begin(batch), end(batch));
+
+        CHECK_EQUAL(4U, stats.estimatedDepth(Stages::Stage2));
+        CHECK_EQUAL(0U, stats.estimatedDepth(Stages::Stage1));
+
+        // cleanup memory in the queues...
+        stage2.process();
+        stage2.process();
+        stage2.process();
+        stage2.process();
+    }
 }
 
@@ -91,5 +91,48 @@ namespace {
         stage2.process();
         stage3.process();
     }
-}
 
+    TEST(verifyColorKeepsTheNameOfAStageAtItsMaxConcurrency)
+    {
+        using namespace wield::schedulers::color;
+
+        using Dispatcher = typename test_color::Traits::Dispatcher;
+        using Message = typename test_color::Traits::Message;
+        using Stages = typename test_color::Traits::StageEnumType;
+        using Stage = typename test_color::Traits::Stage;
+        using ColorQueue = Concurrency::concurrent_queue<Stages>;
+        using PollingPolicy = wield::polling_policies::ExhaustivePollingPolicy<Stages>;
+        using SchedulingPolicy = Color<Dispatcher, ColorQueue, PollingPolicy>;
+        using MaxConcurrencyContainer = typename SchedulingPolicy::MaxConcurrencyContainer;
+        using Queue = typename test_color::Traits::Queue;
+
+        ColorQueue q;
+        Dispatcher d(q);
+
+        test_color::ProcessingFunctor pf;
+        Queue stageQueue1, stageQueue2;
+        Stage stage1(Stages::Stage1, d, stageQueue1, pf);
+        Stage stage2(Stages::Stage2, d, stageQueue2, pf);
+
+        MaxConcurrencyContainer concurrency = {{1, 1, 1}};
+        SchedulingPolicy color(d, q, concurrency);
+
+        std::array<Message::ptr, 2> batch = {{ new test_color::TestMessage(), new test_color::TestMessage() }};
+        d.dispatchBatch(Stages::Stage1, begin(batch), end(batch));
+
+        // thread 0 takes Stage1 to its max concurrency.
+        CHECK_EQUAL(&stage1, &color.nextStage(0));
+        CHECK(stage1.process());
+
+        // thread 1 can't visit Stage1 yet, and moves on to Stage2.
+        Message::smartptr m = new test_color::TestMessage();
+        d.dispatch(Stages::Stage2, *m);
+        CHECK_EQUAL(&stage2, &color.nextStage(1));
+        CHECK(stage2.process());
+
+        // the rest of the batch is still scheduled.
+        CHECK_EQUAL(&stage1, &color.nextStage(0));
+        CHECK(stage1.process());
+        CHECK_EQUAL(0U, q.unsafe_size());
+    }
+}
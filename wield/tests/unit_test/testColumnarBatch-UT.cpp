@@ -0,0 +1,106 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test/Traits.hpp"
+#include "./test/Message.hpp"
+#include "./test/ProcessingFunctor.hpp"
+
+#include <wield/batch/ColumnarBatch.hpp>
+
+#include <cstdint>
+
+namespace {
+
+    using namespace test;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Stage = Traits::Stage;
+    using Queue = Traits::Queue;
+
+    using wield::batch::ColumnAlignment;
+
+    enum TickColumns { Symbol, Price };
+
+    class Ticks : public wield::batch::ColumnarBatch<Message, 8, std::uint32_t, double>
+    {
+    public:
+        void processWith(ProcessingFunctorInterface& process) override { process(*this); }
+    };
+
+    bool isAligned(const void* p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % ColumnAlignment == 0;
+    }
+
+    TEST(verifyColumnarBatchStoresRecordsInAlignedColumns)
+    {
+        Message::smartptr m = new Ticks();
+        Ticks& ticks = static_cast<Ticks&>(*m);
+
+        CHECK(ticks.empty());
+        CHECK_EQUAL(8U, Ticks::capacity());
+
+        for(std::uint32_t symbol = 0; symbol < 8; ++symbol)
+        {
+            CHECK(ticks.append(symbol, symbol * 1.5));
+        }
+
+        CHECK(ticks.full());
+        CHECK(!ticks.append(8, 12.0));
+
+        CHECK(isAligned(ticks.column<Symbol>().data()));
+        CHECK(isAligned(ticks.column<Price>().data()));
+
+        CHECK_EQUAL(8U, ticks.column<Price>().size());
+        CHECK_EQUAL(7U, ticks.column<Symbol>()[7]);
+        CHECK_CLOSE(10.5, ticks.column<Price>()[7], 1e-9);
+
+        ticks.resize(3);
+        CHECK_EQUAL(3U, ticks.column<Symbol>().size());
+
+        ticks.clear();
+        CHECK(ticks.empty());
+    }
+
+    TEST(verifyColumnKernelsRunOverTheWholeBatch)
+    {
+        Ticks ticks;
+        for(std::uint32_t symbol = 1; symbol <= 4; ++symbol)
+        {
+            ticks.append(symbol, 100.0 * symbol);
+        }
+
+        // normalize the prices in place.
+        wield::batch::transform(ticks.column<Price>(), ticks.column<Price>(), [](double price){ return price / 100.0; });
+        CHECK_CLOSE(4.0, ticks.column<Price>()[3], 1e-9);
+
+        const Ticks& readOnly = ticks;
+        CHECK_CLOSE(10.0, wield::batch::accumulate(readOnly.column<Price>(), 0.0, [](double sum, double price){ return sum + price; }), 1e-9);
+        CHECK_EQUAL(4U, wield::batch::accumulate(readOnly.column<Symbol>(), 0U, [](std::uint32_t checksum, std::uint32_t symbol){ return checksum ^ symbol; }));
+    }
+
+    TEST(verifyBuilderDispatchesWholeBatches)
+    {
+        Dispatcher d;
+        Queue q;
+        ProcessingFunctor f;
+        Stage s(Stages::Stage1, d, q, f);
+
+        wield::batch::ColumnarBatchBuilder<Ticks, Dispatcher> builder(d, Stages::Stage1);
+
+        for(std::uint32_t symbol = 0; symbol < 20; ++symbol)
+        {
+            builder.append(symbol, 1.0);
+        }
+
+        CHECK_EQUAL(2U, q.unsafe_size());
+        CHECK_EQUAL(4U, builder.pending());
+
+        builder.flush();
+        builder.flush();
+        CHECK_EQUAL(3U, q.unsafe_size());
+        CHECK_EQUAL(0U, builder.pending());
+
+        while(s.process());
+        CHECK_EQUAL(3U, f.messageBaseCallCount_);
+    }
+}
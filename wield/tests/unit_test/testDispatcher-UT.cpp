@@ -1,5 +1,6 @@
 #include "./platform/UnitTestSupport.hpp"
 #include <exception>
+#include <vector>
 
 #include "./test/Traits.hpp"
 #include "./test/ProcessingFunctor.hpp"
@@ -55,6 +56,31 @@ namespace {
         delete m2;
     }
 
+    TEST(verifyDispatcherDispatchBatch)
+    {
+        Dispatcher d;
+        Queue q;
+        ProcessingFunctor f;
+
+        Stage s(Stages::Stage1, d, q, f);
+        std::vector<Message::smartptr> batch = { new TestMessage(), new TestMessage2(), new TestMessage() };
+
+        CHECK_EQUAL(0U, q.unsafe_size());
+        d.dispatchBatch(Stages::Stage1, begin(batch), end(batch));
+        CHECK_EQUAL(3U, q.unsafe_size());
+
+        // the queue holds its own reference to each message.
+        batch.clear();
+
+        CHECK(s.process());
+        CHECK(s.process());
+        CHECK(s.process());
+        CHECK(!s.process());
+
+        CHECK(f.message1Called_);
+        CHECK(f.message2Called_);
+    }
+
     TEST(verifyDispatchingCanGetAMessageFromOneStageToAnother)
     {
         Dispatcher d;
@@ -3,11 +3,16 @@
 #include <wield/adapters/dynamic/FanoutProcessingFunctor.hpp>
 #include <wield/adapters/FanoutProcessingFunctor.hpp>
 #include <wield/CloneMessageTag.hpp>
+#include <wield/memory/QuiescentState.hpp>
 
 #include "./test/Traits.hpp"
 #include "./test/ProcessingFunctor.hpp"
 #include "./test/Message.hpp"
 
+#include <atomic>
+#include <vector>
+#include <wield/platform/thread.hpp>
+
 namespace {
     
     using namespace test;
@@ -36,7 +41,18 @@ namespace {
             this->dispatch(m, wield::clone_message);
         }
     };
-    
+
+    // dispatches TestMessages copy-on-write.
+    class CopyOnWriteFanoutProcessingFunctor : public wield::adapters::dynamic::FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>
+    {
+    public:
+        using wield::adapters::dynamic::FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface>::FanoutProcessingFunctor;
+
+        void operator() (Message& m) override { this->dispatch(m); }
+        void operator()(TestMessage& m) override { this->dispatch(m, wield::copy_on_write); }
+        void operator()(TestMessage2& m) override { this->dispatch(m); }
+    };
+
     struct FanoutProcessingFunctorFixture
     {
         FanoutProcessingFunctorFixture()
@@ -144,4 +160,131 @@ namespace {
         CHECK(pf2.message2Called_); // ensure we processed a TestMessage
         CHECK(pf3.message2Called_); // ensure we processed a TestMessage
     }
+
+    TEST(verifyFanoutCopyOnWriteClonesOnlyForMutatingStages)
+    {
+        Dispatcher d;
+        Queue q1, q2, q3;
+        ProcessingFunctor pf2, pf3;
+
+        CopyOnWriteFanoutProcessingFunctor fanout(d, {Stages::Stage2, Stages::Stage3}, {Stages::Stage3});
+        Stage s1(Stages::Stage1, d, q1, fanout);
+        Stage s2(Stages::Stage2, d, q2, pf2);
+        Stage s3(Stages::Stage3, d, q3, pf3);
+
+        Message::smartptr m = new TestMessage();
+        d.dispatch(Stages::Stage1, *m);
+        CHECK(s1.process());
+
+        Message::ptr shared = nullptr;
+        Message::ptr cloned = nullptr;
+        CHECK(q2.try_pop(shared));
+        CHECK(q3.try_pop(cloned));
+
+        CHECK(shared == m.get());   // the reading stage shares the message,
+        CHECK(cloned != m.get());   // the mutating stage gets its own copy.
+
+        shared->decrementReferenceCount();
+        cloned->decrementReferenceCount();
+    }
+
+    TEST_FIXTURE(FanoutProcessingFunctorFixture, verifyFanoutConfigurationCanBeChangedWhileDispatching)
+    {
+        const std::size_t NumberOfMessages = 10000;
+        std::atomic_bool done(false);
+
+        // a control thread flips the fanout configuration while we dispatch.
+        std::thread control([this, &done]()
+        {
+            for(std::size_t flips = 0; flips < 1000 && !done.load(); ++flips)
+            {
+                fanout.updateStages({Stages::Stage3});
+                fanout.updateStages({Stages::Stage2, Stages::Stage3});
+            }
+        });
+
+        Message::smartptr m = new TestMessage();
+        for(std::size_t i = 0; i < NumberOfMessages; ++i)
+        {
+            d.dispatch(Stages::Stage1, *m);
+            CHECK(s1.process());
+
+            // as a scheduler thread does after each batch.
+            wield::memory::QuiescentState::quiescent();
+        }
+
+        done.store(true);
+        control.join();
+
+        while(s2.process()){}
+        while(s3.process()){}
+
+        // Stage3 is in every configuration, Stage2 in only some.
+        CHECK_EQUAL(NumberOfMessages, pf3.message1CallCount_);
+        CHECK(pf2.message1CallCount_ <= NumberOfMessages);
+    }
+
+    TEST_FIXTURE(FanoutProcessingFunctorFixture, verifyReplacedConfigurationsAreFreedWhileOthersDispatch)
+    {
+        const std::size_t NumberOfThreads = 4;
+        const std::size_t MessagesPerThread = 5000;
+        std::atomic_bool done(false);
+
+        // every update replaces a configuration some thread may be
+        // walking, these threads keep walking them.
+        std::vector<std::thread> dispatchers;
+        for(std::size_t t = 0; t < NumberOfThreads; ++t)
+        {
+            dispatchers.emplace_back([this]()
+            {
+                Message::smartptr m = new TestMessage();
+                for(std::size_t i = 0; i < MessagesPerThread; ++i)
+                {
+                    d.dispatch(Stages::Stage1, *m);
+                    s1.process();
+                    wield::memory::QuiescentState::quiescent();
+                }
+            });
+        }
+
+        std::size_t updates = 0;
+        std::thread control([this, &done, &updates]()
+        {
+            while(!done.load())
+            {
+                fanout.updateStages({Stages::Stage3, Stages::Stage2});
+                fanout.updateStages({Stages::Stage2, Stages::Stage3});
+                updates += 2;
+            }
+        });
+
+        for(auto& dispatcher : dispatchers)
+        {
+            dispatcher.join();
+        }
+
+        done.store(true);
+        control.join();
+
+        while(s1.process()){}
+        while(s2.process()){}
+        while(s3.process()){}
+
+        CHECK(updates > 0);
+        CHECK_EQUAL(NumberOfThreads * MessagesPerThread, pf2.message1CallCount_);
+        CHECK_EQUAL(NumberOfThreads * MessagesPerThread, pf3.message1CallCount_);
+    }
+
+    TEST_FIXTURE(FanoutProcessingFunctorFixture, verifyOnlyTheLatestConfigurationIsUsed)
+    {
+        fanout.updateStages({Stages::Stage3});
+        fanout.updateStages({Stages::Stage2});
+
+        Message::smartptr m = new TestMessage();
+        d.dispatch(Stages::Stage1, *m);
+
+        CHECK(s1.process());
+        CHECK(s2.process());
+        CHECK(!s3.process());
+    }
 }
@@ -36,7 +36,21 @@ namespace {
             this->dispatch(m, wield::clone_message);
         }
     };
-    
+
+    // dispatches TestMessages copy-on-write: Stage3 mutates, Stage2 only reads.
+    class CopyOnWriteFanoutProcessingFunctor : public wield::adapters::FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, Stages::Stage2, Stages::Stage3>
+    {
+    public:
+        CopyOnWriteFanoutProcessingFunctor(Dispatcher& d)
+            : wield::adapters::FanoutProcessingFunctor<Dispatcher, ProcessingFunctorInterface, Stages::Stage2, Stages::Stage3>(d, {Stages::Stage3})
+        {
+        }
+
+        void operator() (Message& m) override { this->dispatch(m); }
+        void operator()(TestMessage& m) override { this->dispatch(m, wield::copy_on_write); }
+        void operator()(TestMessage2& m) override { this->dispatch(m); }
+    };
+
     struct FanoutProcessingFunctorFixture
     {
         FanoutProcessingFunctorFixture()
@@ -93,4 +107,31 @@ namespace {
         CHECK(pf2.message2Called_); // ensure we processed a TestMessage
         CHECK(pf3.message2Called_); // ensure we processed a TestMessage
     }
+
+    TEST(verifyFanoutCopyOnWriteClonesOnlyForMutatingStages)
+    {
+        Dispatcher d;
+        Queue q1, q2, q3;
+        ProcessingFunctor pf2, pf3;
+
+        CopyOnWriteFanoutProcessingFunctor fanout(d);
+        Stage s1(Stages::Stage1, d, q1, fanout);
+        Stage s2(Stages::Stage2, d, q2, pf2);
+        Stage s3(Stages::Stage3, d, q3, pf3);
+
+        Message::smartptr m = new TestMessage();
+        d.dispatch(Stages::Stage1, *m);
+        CHECK(s1.process());
+
+        Message::ptr shared = nullptr;
+        Message::ptr cloned = nullptr;
+        CHECK(q2.try_pop(shared));
+        CHECK(q3.try_pop(cloned));
+
+        CHECK(shared == m.get());   // the reading stage shares the message,
+        CHECK(cloned != m.get());   // the mutating stage gets its own copy.
+
+        shared->decrementReferenceCount();
+        cloned->decrementReferenceCount();
+    }
 }
@@ -0,0 +1,142 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_static/Traits.hpp"
+#include "./test_static/Message.hpp"
+#include "./test/Traits.hpp"
+
+#include <wield/adapters/ReorderingQueue.hpp>
+#include <wield/memory/HugePageAllocator.hpp>
+#include <wield/schedulers/utils/ThreadAssignments.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifdef __linux__
+#include <wield/io/ReceiveBufferPool.hpp>
+#endif
+
+namespace {
+
+    using wield::memory::HugePageAllocator;
+    using wield::memory::HugePages;
+    using wield::memory::NodeLocalAllocator;
+
+    bool isHugePageAligned(const void* p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % HugePages::PageSize == 0;
+    }
+
+    TEST(verifyHugePageAllocatorBacksLargeBlocksWithHugePages)
+    {
+        // 8MB, well over the threshold.
+        std::vector<std::uint64_t, HugePageAllocator<std::uint64_t>> ring(1024 * 1024);
+
+#ifdef __linux__
+        CHECK(isHugePageAligned(ring.data()));
+#endif
+
+        for(std::size_t i = 0; i < ring.size(); ++i)
+        {
+            ring[i] = i;
+        }
+
+        bool intact = true;
+        for(std::size_t i = 0; i < ring.size(); ++i)
+        {
+            intact = intact && ring[i] == i;
+        }
+        CHECK(intact);
+
+        // small blocks come from operator new.
+        std::vector<int, HugePageAllocator<int>> small(10, 7);
+        CHECK_EQUAL(7, small[9]);
+    }
+
+    TEST(verifyNodeLocalAllocatorRebindsAndCompares)
+    {
+        using Allocator = NodeLocalAllocator<std::uint64_t>;
+        using Rebound = std::allocator_traits<Allocator>::rebind_alloc<char>;
+
+        Allocator allocator;
+        Rebound bytes(allocator);
+        CHECK(bytes == Rebound(allocator));
+
+        char* block = std::allocator_traits<Rebound>::allocate(bytes, HugePages::Threshold);
+        block[0] = 'a';
+        block[HugePages::Threshold - 1] = 'z';
+        CHECK_EQUAL('z', block[HugePages::Threshold - 1]);
+        std::allocator_traits<Rebound>::deallocate(bytes, block, HugePages::Threshold);
+    }
+
+    TEST(verifyThreadAssignmentsTakeAnAllocator)
+    {
+        using namespace test;
+        using Assignments = wield::schedulers::utils::ThreadAssignments<Stages, NodeLocalAllocator<Stages>>;
+
+        Assignments assignments(2);
+        CHECK(assignments.tryAssign(0, Stages::Stage1));
+        CHECK(!assignments.tryAssign(1, Stages::Stage1));
+        CHECK_EQUAL(Stages::Stage1, assignments.currentAssignment(0));
+    }
+
+    class SequencedMessage : public test_static::TestMessage
+    {
+    public:
+        SequencedMessage(const std::uint64_t sequence)
+            : sequence_(sequence)
+        {
+        }
+
+        std::uint64_t sequence() const { return sequence_; }
+
+    private:
+        const std::uint64_t sequence_;
+    };
+
+    struct BySequence
+    {
+        std::uint64_t operator()(const test_static::Traits::Message::ptr& m) const { return static_cast<const SequencedMessage&>(*m).sequence(); }
+    };
+
+    TEST(verifyReorderingQueueRingTakesAnAllocator)
+    {
+        using Message = test_static::Traits::Message;
+        using Slots = HugePageAllocator<std::atomic<Message::ptr>>;
+        using ReorderingQueue = wield::adapters::ReorderingQueue<Message::ptr, BySequence, test_static::Traits::SimpleQueue, Slots>;
+
+        // a large window, the ring is a huge page block.
+        ReorderingQueue q(1024 * 1024, std::chrono::nanoseconds::max());
+
+        Message::smartptr first = new SequencedMessage(0);
+        Message::smartptr second = new SequencedMessage(1);
+
+        q.push(second.get());
+        Message::ptr popped = nullptr;
+        CHECK(!q.try_pop(popped));
+
+        q.push(first.get());
+        CHECK(q.try_pop(popped));
+        CHECK(popped == first.get());
+        CHECK(q.try_pop(popped));
+        CHECK(popped == second.get());
+    }
+
+#ifdef __linux__
+    TEST(verifyReceiveBufferPoolTakesAnAllocator)
+    {
+        wield::io::ReceiveBufferPool pool(2048, 1024, HugePageAllocator<char>());
+        CHECK_EQUAL(1024U, pool.available());
+
+        {
+            wield::io::ReceiveBuffer buffer = pool.acquire();
+            CHECK(isHugePageAligned(buffer.data()));
+            buffer.data()[buffer.capacity() - 1] = 'x';
+            CHECK_EQUAL(1023U, pool.available());
+        }
+
+        CHECK_EQUAL(1024U, pool.available());
+    }
+#endif
+}
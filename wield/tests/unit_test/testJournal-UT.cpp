@@ -0,0 +1,223 @@
+#ifdef __linux__
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./platform/ConcurrentQueue.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+#include "./test_io/Message.hpp"
+#include "./test_io/RecordingDispatcher.hpp"
+
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+#include <wield/io/Journal.hpp>
+#include <wield/io/JournalQueue.hpp>
+#include <wield/serialization/MessageRegistry.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+    using namespace test_adapter;
+    using namespace test_io;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Stage = Traits::Stage;
+    using Message = Traits::Message;
+    using MessagePtr = Message::ptr;
+
+    using Codec = wield::serialization::RegistryCodec<Message>;
+    using JournalQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, wield::io::JournalQueue<Stages, Message, Codec>>;
+    using Replay = wield::io::JournalReplay<Stages, Message, Codec>;
+    using ReplayQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Replay>;
+    using ConcreteQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Concurrency::concurrent_queue<MessagePtr>>;
+
+    // a scratch directory, removed with its segments.
+    struct JournalDirectory
+    {
+        JournalDirectory()
+        {
+            char name[] = "/tmp/wield-journal-XXXXXX";
+            path = ::mkdtemp(name);
+            registry.add<Trade>();
+        }
+
+        ~JournalDirectory()
+        {
+            DIR* directory = ::opendir(path.c_str());
+            while(dirent* entry = ::readdir(directory))
+            {
+                ::unlink((path + "/" + entry->d_name).c_str());
+            }
+
+            ::closedir(directory);
+            ::rmdir(path.c_str());
+        }
+
+        std::string path;
+        wield::serialization::MessageRegistry<Message> registry;
+    };
+
+    void appendTrade(wield::io::JournalWriter& journal, const JournalDirectory& directory, const std::uint64_t price, const std::int64_t timestamp)
+    {
+        const Trade trade(TradePayload{ price });
+        journal.append(static_cast<std::uint32_t>(Stages::Stage2), timestamp, [&](char* buffer, std::size_t capacity){
+            return directory.registry.serialize(trade, buffer, capacity);
+        });
+    }
+
+    TEST(verifyJournalStageRecordsMessagesForReplay)
+    {
+        JournalDirectory directory;
+
+        {
+            // small segments, so the journal rotates.
+            wield::io::JournalWriter journal(directory.path, 1024, 64);
+
+            Dispatcher d;
+            ProcessingFunctor journalFunctor;
+            JournalQueue journalQueue(journal, Stages::Stage3, Codec(directory.registry));
+            Stage journalStage(Stages::Stage1, d, journalQueue, journalFunctor);
+
+            for(std::uint64_t price = 0; price < 100; ++price)
+            {
+                Message::smartptr m = new Trade(TradePayload{ price });
+                d.dispatch(Stages::Stage1, *m);
+            }
+
+            CHECK_EQUAL(100U, journalQueue.queue().recorded());
+            CHECK(journal.segments() > 1);
+            CHECK(!journalStage.process());
+            CHECK_EQUAL(0U, journalFunctor.message1CallCount_);
+        }
+
+        Dispatcher d;
+        ProcessingFunctor replayFunctor;
+        ProcessingFunctor f;
+        ReplayQueue replayQueue(d, directory.path, 0.0, 64, Codec(directory.registry));
+        ConcreteQueue q;
+        Stage replayStage(Stages::Stage1, d, replayQueue, replayFunctor);
+        Stage s(Stages::Stage3, d, q, f);
+
+        // as fast as possible: a visit replays a batch.
+        CHECK(!replayStage.process());
+        CHECK_EQUAL(64U, replayQueue.queue().replayed());
+
+        CHECK(!replayStage.process());
+        CHECK(!replayStage.process());
+        CHECK_EQUAL(100U, replayQueue.queue().replayed());
+
+        while(s.process());
+        CHECK_EQUAL(100U, f.message1CallCount_);
+
+        CHECK_THROW(replayQueue.push(nullptr), wield::IllegallyPushedMessageOntoIngress);
+    }
+
+    TEST(verifyReplayKeepsTheRecordedPace)
+    {
+        JournalDirectory directory;
+        {
+            wield::io::JournalWriter journal(directory.path, 4096, 64);
+            appendTrade(journal, directory, 1, 1000000);
+            appendTrade(journal, directory, 2, 2000000);
+            appendTrade(journal, directory, 3, 4000000);
+        }
+
+        using std::chrono::microseconds;
+        const Replay::Clock::time_point start;
+
+        RecordingDispatcher d;
+        Replay replay(d, directory.path, 1.0, 64, Codec(directory.registry));
+
+        CHECK_EQUAL(1U, replay.replay(start));
+        CHECK_EQUAL(0U, replay.replay(start + microseconds(999)));
+        CHECK_EQUAL(1U, replay.replay(start + microseconds(1000)));
+        CHECK_EQUAL(0U, replay.replay(start + microseconds(2999)));
+        CHECK_EQUAL(1U, replay.replay(start + microseconds(3000)));
+        CHECK_EQUAL(0U, replay.replay(start + microseconds(10000)));
+
+        // twice as fast, the gaps are halved.
+        RecordingDispatcher fast;
+        Replay accelerated(fast, directory.path, 2.0, 64, Codec(directory.registry));
+
+        CHECK_EQUAL(1U, accelerated.replay(start));
+        CHECK_EQUAL(1U, accelerated.replay(start + microseconds(500)));
+        CHECK_EQUAL(1U, accelerated.replay(start + microseconds(1500)));
+
+        CHECK_EQUAL(3U, fast.messages.size());
+        CHECK(Stages::Stage2 == fast.stages[0]);
+        CHECK_EQUAL(3U, fast.price(2));
+    }
+
+    TEST(verifyReplayRejectsARecordForAnUnknownStage)
+    {
+        JournalDirectory directory;
+        {
+            wield::io::JournalWriter journal(directory.path, 4096, 64);
+
+            const Trade trade(TradePayload{ 1 });
+            journal.append(static_cast<std::uint32_t>(Stages::NumberOfEntries), 0, [&](char* buffer, std::size_t capacity){
+                return directory.registry.serialize(trade, buffer, capacity);
+            });
+            appendTrade(journal, directory, 2, 0);
+        }
+
+        RecordingDispatcher d;
+        Replay replay(d, directory.path, 0.0, 64, Codec(directory.registry));
+
+        const Replay::Clock::time_point start;
+        CHECK_THROW(replay.replay(start), wield::UnknownStageName);
+
+        // the record is skipped, the replay carries on past it.
+        CHECK_EQUAL(1U, replay.replay(start));
+        CHECK_EQUAL(1U, d.messages.size());
+        CHECK_EQUAL(2U, d.price(0));
+    }
+
+    TEST(verifyReaderFollowsAGrowingJournal)
+    {
+        JournalDirectory directory;
+        wield::io::JournalWriter journal(directory.path, 1024, 64);
+
+        wield::io::JournalReader reader(directory.path);
+        wield::io::JournalReader::Record record;
+        CHECK(!reader.next(record));
+
+        // enough to cross into later segments while the reader keeps up.
+        for(std::uint64_t price = 0; price < 50; ++price)
+        {
+            appendTrade(journal, directory, price, static_cast<std::int64_t>(price));
+
+            CHECK(reader.next(record));
+            CHECK_EQUAL(static_cast<std::int64_t>(price), record.timestamp);
+            CHECK_EQUAL(price, static_cast<const Trade&>(*Message::smartptr(directory.registry.deserialize(record.data, record.length))).payload().price);
+            CHECK(!reader.next(record));
+        }
+
+        CHECK(journal.segments() > 1);
+    }
+
+    TEST(verifyReaderRejectsWhatIsNotAJournal)
+    {
+        JournalDirectory directory;
+        CHECK_THROW(wield::io::JournalReader reader(directory.path), std::system_error);
+
+        const std::string path = wield::io::JournalFormat::segmentPath(directory.path, 0);
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        const std::vector<char> garbage(4096, 'x');
+        CHECK_EQUAL(static_cast<ssize_t>(garbage.size()), ::write(fd, garbage.data(), garbage.size()));
+        ::close(fd);
+
+        CHECK_THROW(wield::io::JournalReader reader(directory.path), wield::InvalidJournal);
+    }
+}
+#endif
@@ -0,0 +1,212 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_static/Traits.hpp"
+#include "./test_static/Message.hpp"
+#include "./test_static/ProcessingFunctor.hpp"
+
+#include <wield/adapters/KeyedQueue.hpp>
+#include <wield/details/ProcessedNotification.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace test_static;
+
+    using Message = Traits::Message;
+
+    class KeyedMessage : public TestMessage
+    {
+    public:
+        KeyedMessage(const std::size_t key, const std::size_t sequence)
+            : key_(key)
+            , sequence_(sequence)
+        {
+        }
+
+        std::size_t key() const { return key_; }
+        std::size_t sequence() const { return sequence_; }
+
+    private:
+        const std::size_t key_;
+        const std::size_t sequence_;
+    };
+
+    struct ByKey
+    {
+        std::size_t operator()(const Message::ptr& m) const { return static_cast<const KeyedMessage&>(*m).key(); }
+    };
+
+    using KeyedQueue = wield::adapters::KeyedQueue<Message::ptr, ByKey, Traits::SimpleQueue>;
+
+    static_assert(wield::details::HasProcessedNotification<KeyedQueue, Message::ptr>::value, "KeyedQueue should ask to be notified.");
+    static_assert(!wield::details::HasProcessedNotification<Traits::Queue, Message::ptr>::value, "concurrent_queue has no processed().");
+
+    // records, per key, the sequence numbers in the order they were processed.
+    class OrderRecordingProcessingFunctor final : public ProcessingFunctorInterface
+    {
+    public:
+        static const std::size_t NumberOfKeys = 8;
+
+        OrderRecordingProcessingFunctor()
+            : outOfOrder_(0)
+            , processed_(0)
+        {
+            for(auto& next : next_)
+            {
+                next = 0;
+            }
+        }
+
+        void operator()(Message&) override {}
+        void operator()(TestMessage2&) override {}
+
+        void operator()(TestMessage& msg) override
+        {
+            auto& m = static_cast<KeyedMessage&>(msg);
+
+            // the partition claim makes this non-atomic read-modify-write safe.
+            if(m.sequence() != next_[m.key()])
+            {
+                outOfOrder_++;
+            }
+            next_[m.key()] = m.sequence() + 1;
+            processed_++;
+        }
+
+        std::array<std::size_t, NumberOfKeys> next_;
+        std::atomic<std::size_t> outOfOrder_;
+        std::atomic<std::size_t> processed_;
+    };
+
+    using StageGraph = wield::static_graph::StageGraph<Stages, Message,
+        Traits::StageDescription<Stages::Stage1, CountingProcessingFunctor, Traits::Queue>,
+        Traits::StageDescription<Stages::Stage2, OrderRecordingProcessingFunctor, KeyedQueue>,
+        Traits::StageDescription<Stages::Stage3, CountingProcessingFunctor, Traits::Queue>>;
+
+    using Dispatcher = wield::static_graph::Dispatcher<StageGraph>;
+
+    TEST(verifyKeyedQueueClaimsAPartitionUntilProcessed)
+    {
+        KeyedQueue q(2);
+        CHECK_EQUAL(2U, q.numberOfPartitions());
+
+        Message::smartptr m1 = new KeyedMessage(1, 0);
+        Message::smartptr m2 = new KeyedMessage(1, 1);
+        Message::smartptr m3 = new KeyedMessage(2, 0);
+
+        q.push(m1.get());
+        q.push(m2.get());
+        q.push(m3.get());
+        CHECK_EQUAL(3U, q.unsafe_size());
+
+        Message::ptr first = nullptr;
+        Message::ptr second = nullptr;
+        Message::ptr none = nullptr;
+
+        // one message from each partition, then both are claimed.
+        CHECK(q.try_pop(first));
+        CHECK(q.try_pop(second));
+        CHECK(!q.try_pop(none));
+        CHECK(first != second);
+
+        const Message::ptr key1 = first == m3.get() ? second : first;
+        CHECK_EQUAL(m1.get(), key1);
+
+        // releasing key 2's partition doesn't give up key 1's next message.
+        q.processed(m3.get());
+        CHECK(!q.try_pop(none));
+
+        q.processed(m1.get());
+        CHECK(q.try_pop(none));
+        CHECK_EQUAL(m2.get(), none);
+
+        q.processed(m2.get());
+        CHECK_EQUAL(0U, q.unsafe_size());
+        CHECK(!q.try_pop(none));
+    }
+
+    TEST(verifyStageReleasesKeyedQueuePartitionAfterProcessing)
+    {
+        Dispatcher d;
+
+        CountingProcessingFunctor f;
+        OrderRecordingProcessingFunctor ordered;
+        Traits::Queue q1;
+        Traits::Queue q3;
+        KeyedQueue keyed(1);
+
+        Dispatcher::ConcreteStageType<Stages::Stage1> s1(d, q1, f);
+        Dispatcher::ConcreteStageType<Stages::Stage2> s2(d, keyed, ordered);
+        Dispatcher::ConcreteStageType<Stages::Stage3> s3(d, q3, f);
+
+        for(std::size_t sequence = 0; sequence < 3; ++sequence)
+        {
+            Message::smartptr m = new KeyedMessage(0, sequence);
+            d.dispatch<Stages::Stage2>(*m);
+        }
+
+        // with a single partition, each process() must release it for the next.
+        CHECK(s2.process());
+        CHECK(s2.process());
+        CHECK(s2.process());
+        CHECK(!s2.process());
+
+        CHECK_EQUAL(3U, ordered.processed_.load());
+        CHECK_EQUAL(0U, ordered.outOfOrder_.load());
+    }
+
+    TEST(verifyKeyedQueuePreservesPerKeyOrderAcrossThreads)
+    {
+        static const std::size_t NumberOfThreads = 4;
+        static const std::size_t MessagesPerKey = 2000;
+        static const std::size_t NumberOfKeys = OrderRecordingProcessingFunctor::NumberOfKeys;
+
+        Dispatcher d;
+
+        CountingProcessingFunctor f;
+        OrderRecordingProcessingFunctor ordered;
+        Traits::Queue q1;
+        Traits::Queue q3;
+        KeyedQueue keyed(NumberOfKeys);
+
+        Dispatcher::ConcreteStageType<Stages::Stage1> s1(d, q1, f);
+        Dispatcher::ConcreteStageType<Stages::Stage2> s2(d, keyed, ordered);
+        Dispatcher::ConcreteStageType<Stages::Stage3> s3(d, q3, f);
+
+        std::vector<std::thread> threads;
+        for(std::size_t t = 0; t < NumberOfThreads; ++t)
+        {
+            threads.emplace_back([&]{
+                while(ordered.processed_.load() < MessagesPerKey * NumberOfKeys)
+                {
+                    if(!s2.process())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for(std::size_t sequence = 0; sequence < MessagesPerKey; ++sequence)
+        {
+            for(std::size_t key = 0; key < NumberOfKeys; ++key)
+            {
+                Message::smartptr m = new KeyedMessage(key, sequence);
+                d.dispatch<Stages::Stage2>(*m);
+            }
+        }
+
+        for(auto& t : threads)
+        {
+            t.join();
+        }
+
+        CHECK_EQUAL(MessagesPerKey * NumberOfKeys, ordered.processed_.load());
+        CHECK_EQUAL(0U, ordered.outOfOrder_.load());
+    }
+}
@@ -0,0 +1,195 @@
+#include "./platform/UnitTestSupport.hpp"
+#include "./platform/ConcurrentQueue.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+#include "./test_adapter/Stages.hpp"
+
+#include <wield/adapters/input_selection/DeficitRoundRobin.hpp>
+#include <wield/adapters/input_selection/StrictPriority.hpp>
+#include <wield/adapters/input_selection/WeightedRoundRobin.hpp>
+#include <wield/adapters/polymorphic/WeightedMultipleInputQueueAdapter.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace {
+
+    using namespace test_adapter;
+    using Dispatcher = typename Traits::Dispatcher;
+    using MessagePtr = typename Traits::MessagePtr;
+    using Stage = typename Traits::Stage;
+    using ConcreteQueue = Concurrency::concurrent_queue<MessagePtr>;
+
+    template<class InputSelectionPolicy>
+    using WeightedMultipleInputQueueAdapter = wield::adapters::polymorphic::WeightedMultipleInputQueueAdapter<Traits, ConcreteQueue, 2, InputSelectionPolicy>;
+
+    using StrictPriority = wield::adapters::input_selection::StrictPriority<2>;
+    using WeightedRoundRobin = wield::adapters::input_selection::WeightedRoundRobin<2>;
+    using DeficitRoundRobin = wield::adapters::input_selection::DeficitRoundRobin<2>;
+
+    // dispatch @count TestMessages to @data and one TestMessage2 to @control.
+    void dispatchMessages(Dispatcher& d, const Stages data, const std::size_t count, const Stages control)
+    {
+        Message::smartptr m = new TestMessage();
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            d.dispatch(data, *m);
+        }
+
+        Message::smartptr c = new TestMessage2();
+        d.dispatch(control, *c);
+    }
+
+    TEST(verifyWeightedAdapterThrowsWhenTooManyQueuesAreAdded)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+
+        WeightedMultipleInputQueueAdapter<WeightedRoundRobin> q(d, dummyFunctor);
+        q.addQueue(Stages::Stage1)
+         .addQueue(Stages::Stage2);
+
+        CHECK_THROW(q.addQueue(Stages::Stage3);, std::runtime_error);
+    }
+
+    // @return true if popping an adapter with no queues added yet finds nothing.
+    template<class InputSelectionPolicy>
+    bool popsNothingWithoutQueues(void)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+        WeightedMultipleInputQueueAdapter<InputSelectionPolicy> q(d, dummyFunctor);
+
+        MessagePtr m = nullptr;
+        return !q.try_pop(m) && !q.try_pop(m) && m == nullptr && q.unsafe_size() == 0;
+    }
+
+    TEST(verifyWeightedAdapterWithoutQueuesIsEmpty)
+    {
+        CHECK(popsNothingWithoutQueues<StrictPriority>());
+        CHECK(popsNothingWithoutQueues<WeightedRoundRobin>());
+        CHECK(popsNothingWithoutQueues<DeficitRoundRobin>());
+    }
+
+    TEST(verifyStrictPriorityPreemptsLowerPriorityInputs)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+
+        // Stage1 is the control input, added first so it has the highest priority.
+        WeightedMultipleInputQueueAdapter<StrictPriority> q(d, dummyFunctor);
+        q.addQueue(Stages::Stage1)
+         .addQueue(Stages::Stage2);
+
+        ProcessingFunctor f;
+        Stage stage(Stages::Stage3, d, q, f);
+
+        dispatchMessages(d, Stages::Stage2, 3, Stages::Stage1);
+        CHECK_EQUAL(4U, q.unsafe_size());
+
+        CHECK(stage.process());
+        CHECK_EQUAL(1U, f.message2CallCount_);  // the control message went first.
+        CHECK_EQUAL(0U, f.message1CallCount_);
+
+        while(stage.process()){}
+        CHECK_EQUAL(3U, f.message1CallCount_);
+    }
+
+    TEST(verifyWeightedRoundRobinDrainsAnInputUpToItsWeight)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+
+        WeightedMultipleInputQueueAdapter<WeightedRoundRobin> q(d, dummyFunctor);
+        q.addQueue(Stages::Stage1, 3)
+         .addQueue(Stages::Stage2, 1);
+
+        ProcessingFunctor f;
+        Stage stage(Stages::Stage3, d, q, f);
+
+        dispatchMessages(d, Stages::Stage1, 6, Stages::Stage2);
+
+        // three messages from Stage1 before Stage2 gets a turn.
+        CHECK(stage.process());
+        CHECK(stage.process());
+        CHECK(stage.process());
+        CHECK_EQUAL(3U, f.message1CallCount_);
+        CHECK_EQUAL(0U, f.message2CallCount_);
+
+        CHECK(stage.process());
+        CHECK_EQUAL(1U, f.message2CallCount_);
+
+        while(stage.process()){}
+        CHECK_EQUAL(6U, f.message1CallCount_);
+        CHECK_EQUAL(0U, q.unsafe_size());
+    }
+
+    TEST(verifyDeficitRoundRobinSharesInputsByQuantum)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+
+        WeightedMultipleInputQueueAdapter<DeficitRoundRobin> q(d, dummyFunctor);
+        q.addQueue(Stages::Stage1, 2)
+         .addQueue(Stages::Stage2, 1);
+
+        ProcessingFunctor f;
+        Stage stage(Stages::Stage3, d, q, f);
+
+        dispatchMessages(d, Stages::Stage1, 4, Stages::Stage2);
+
+        CHECK(stage.process());
+        CHECK(stage.process());
+        CHECK_EQUAL(2U, f.message1CallCount_);
+
+        CHECK(stage.process());
+        CHECK_EQUAL(1U, f.message2CallCount_);
+
+        // Stage2 is now empty, the remaining messages all come from Stage1.
+        CHECK(stage.process());
+        CHECK(stage.process());
+        CHECK(!stage.process());
+        CHECK_EQUAL(4U, f.message1CallCount_);
+    }
+
+    // a queue constructed with a counter of its pushes.
+    class CountingQueue
+    {
+    public:
+        CountingQueue(std::size_t& pushes) : pushes_(pushes) {}
+
+        void push(const MessagePtr& message) { ++pushes_; queue_.push(message); }
+        bool try_pop(MessagePtr& message) { return queue_.try_pop(message); }
+        std::size_t unsafe_size(void) const { return queue_.unsafe_size(); }
+
+    private:
+        std::size_t& pushes_;
+        ConcreteQueue queue_;
+    };
+
+    TEST(verifyWeightedAdapterPassesArgumentsToTheInputQueues)
+    {
+        Dispatcher d;
+        ProcessingFunctor dummyFunctor;
+
+        std::size_t pushes1 = 0;
+        std::size_t pushes2 = 0;
+
+        wield::adapters::polymorphic::WeightedMultipleInputQueueAdapter<Traits, CountingQueue, 2, WeightedRoundRobin> q(d, dummyFunctor);
+        q.addQueue(Stages::Stage1, 1, pushes1)
+         .addQueue(Stages::Stage2, 1, pushes2);
+
+        ProcessingFunctor f;
+        Stage stage(Stages::Stage3, d, q, f);
+
+        dispatchMessages(d, Stages::Stage1, 3, Stages::Stage2);
+        CHECK_EQUAL(3U, pushes1);
+        CHECK_EQUAL(1U, pushes2);
+
+        while(stage.process()){}
+        CHECK_EQUAL(3U, f.message1CallCount_);
+        CHECK_EQUAL(1U, f.message2CallCount_);
+    }
+}
@@ -0,0 +1,133 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include <wield/memory/QuiescentState.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+    using wield::memory::QuiescentState;
+
+    // a reader thread, online until it's told to report or to exit.
+    class Reader
+    {
+    public:
+        Reader()
+            : online_(false)
+            , report_(0)
+            , reported_(0)
+            , exit_(false)
+            , thread_([this](){ run(); })
+        {
+            while(!online_.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        ~Reader()
+        {
+            exit();
+        }
+
+        // have the reader report a quiescent state, and wait until it has.
+        void quiescent(void)
+        {
+            const int report = report_.fetch_add(1) + 1;
+            while(reported_.load() != report)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // have the reader's thread exit without reporting again.
+        void exit(void)
+        {
+            exit_.store(true);
+            if(thread_.joinable())
+            {
+                thread_.join();
+            }
+        }
+
+    private:
+        void run(void)
+        {
+            QuiescentState::online();
+            online_.store(true);
+
+            while(!exit_.load())
+            {
+                const int report = report_.load();
+                if(report != reported_.load())
+                {
+                    QuiescentState::quiescent();
+                    reported_.store(report);
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        std::atomic<bool> online_;
+        std::atomic<int> report_;
+        std::atomic<int> reported_;
+        std::atomic<bool> exit_;
+        std::thread thread_;
+    };
+
+    // begin a grace period, as a writer which isn't reading does.
+    std::uint64_t retire(void)
+    {
+        const std::uint64_t epoch = QuiescentState::retire();
+        QuiescentState::quiescent();
+        return epoch;
+    }
+
+    TEST(verifyGracePeriodEndsOnceEveryReaderHasBeenQuiescent)
+    {
+        Reader first;
+        Reader second;
+
+        const std::uint64_t epoch = retire();
+        CHECK(!QuiescentState::elapsed(epoch));
+
+        first.quiescent();
+        CHECK(!QuiescentState::elapsed(epoch));
+
+        second.quiescent();
+        CHECK(QuiescentState::elapsed(epoch));
+
+        // a later grace period waits for them again.
+        const std::uint64_t next = retire();
+        CHECK(next > epoch);
+        CHECK(!QuiescentState::elapsed(next));
+        CHECK(QuiescentState::elapsed(epoch));
+    }
+
+    TEST(verifyThreadsWhichExitedAreNotWaitedFor)
+    {
+        Reader reader;
+
+        const std::uint64_t epoch = retire();
+        CHECK(!QuiescentState::elapsed(epoch));
+
+        reader.exit();
+        CHECK(QuiescentState::elapsed(epoch));
+
+        // its record is taken over by the next thread to come online.
+        Reader next;
+        CHECK(!QuiescentState::elapsed(retire()));
+    }
+
+    TEST(verifyOnlyOnlineThreadsAreWaitedFor)
+    {
+        const std::uint64_t epoch = retire();
+
+        std::thread([](){ QuiescentState::quiescent(); }).join();
+        CHECK(QuiescentState::elapsed(epoch));
+    }
+}
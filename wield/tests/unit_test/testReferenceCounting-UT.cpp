@@ -0,0 +1,296 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./platform/ConcurrentQueue.hpp"
+#include "./test/Stages.hpp"
+
+#include <wield/Traits.hpp>
+#include <wield/ReferenceCounting.hpp>
+#include <wield/adapters/TimerWheel.hpp>
+
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+    using test::Stages;
+
+    class CountingProcessingFunctor;
+
+    template<class ReferenceCountingPolicy>
+    struct CountingTraits
+    {
+        using StageEnumType = Stages;
+        using ProcessingFunctor = CountingProcessingFunctor;
+        using ReferenceCounting = ReferenceCountingPolicy;
+
+        template<typename MessagePtrType>
+        using QueueType = Concurrency::concurrent_queue<MessagePtrType>;
+
+        template<typename Dispatcher>
+        using SchedulingPolicy = void;
+    };
+
+    using NonAtomicTraits = wield::Traits<CountingTraits<wield::NonAtomicReferenceCount>>;
+    using ThreadConfinedTraits = wield::Traits<CountingTraits<wield::ThreadConfinedReferenceCount>>;
+    using UniqueTraits = wield::Traits<CountingTraits<wield::UniqueOwnership>>;
+
+    class CountingProcessingFunctor
+    {
+    public:
+        CountingProcessingFunctor()
+            : count_(0)
+            , dispatcher_(nullptr)
+            , next_(Stages::NumberOfEntries)
+        {
+        }
+
+        // dispatch the unique messages it processes on to @next.
+        CountingProcessingFunctor(UniqueTraits::Dispatcher& dispatcher, const Stages next)
+            : count_(0)
+            , dispatcher_(&dispatcher)
+            , next_(next)
+        {
+        }
+
+        void operator()(NonAtomicTraits::Message&) { ++count_; }
+        void operator()(ThreadConfinedTraits::Message&) { ++count_; }
+
+        void operator()(UniqueTraits::Message& message)
+        {
+            ++count_;
+            if(dispatcher_ != nullptr)
+            {
+                dispatcher_->dispatch(next_, message);
+            }
+        }
+
+        int count_;
+
+    private:
+        UniqueTraits::Dispatcher* dispatcher_;
+        const Stages next_;
+    };
+
+    // counts its destructions.
+    template<class Message>
+    class TrackedMessage : public Message
+    {
+    public:
+        TrackedMessage(int& destroyed) : destroyed_(destroyed) {}
+        ~TrackedMessage() { ++destroyed_; }
+
+        void processWith(CountingProcessingFunctor& process) override { process(*this); }
+
+    private:
+        int& destroyed_;
+    };
+
+    // dispatch a message twice and process it.
+    // @return the number of destroyed messages, after dispatching and after each visit.
+    template<class Traits>
+    std::vector<int> destructionsWhileProcessing(void)
+    {
+        using Message = typename Traits::Message;
+
+        typename Traits::Dispatcher d;
+        typename Traits::Queue q;
+        CountingProcessingFunctor f;
+        typename Traits::Stage s(Stages::Stage1, d, q, f);
+
+        int destroyed = 0;
+        {
+            typename Message::smartptr m = new TrackedMessage<Message>(destroyed);
+            d.dispatch(Stages::Stage1, *m);
+            d.dispatch(Stages::Stage1, *m);
+        }
+
+        std::vector<int> destructions{ destroyed };
+        while(s.process())
+        {
+            destructions.push_back(destroyed);
+        }
+
+        return destructions;
+    }
+
+    TEST(verifyTraitsDefaultToAtomicReferenceCounting)
+    {
+        struct DefaultTraits
+        {
+            using StageEnumType = Stages;
+            using ProcessingFunctor = CountingProcessingFunctor;
+        };
+
+        CHECK((std::is_same<wield::AtomicReferenceCount, wield::details::ReferenceCountingOf<DefaultTraits>::type>::value));
+        CHECK((std::is_same<wield::NonAtomicReferenceCount, NonAtomicTraits::ReferenceCounting>::value));
+    }
+
+    TEST(verifyReferenceCountsTakeAFanoutAtOnce)
+    {
+        wield::AtomicReferenceCount atomic;
+        atomic.add(3);
+        CHECK(!atomic.decrement());
+        CHECK(!atomic.decrement());
+        CHECK(atomic.decrement());
+
+        wield::NonAtomicReferenceCount plain;
+        plain.increment();
+        plain.add(2);
+        CHECK(!plain.decrement());
+        CHECK(!plain.decrement());
+        CHECK(plain.decrement());
+    }
+
+    TEST(verifyNonAtomicReferenceCountedMessagesAreReleased)
+    {
+        CHECK((std::vector<int>{ 0, 0, 1 } == destructionsWhileProcessing<NonAtomicTraits>()));
+    }
+
+    TEST(verifyThreadConfinedReferenceCountedMessagesAreReleased)
+    {
+        CHECK((std::vector<int>{ 0, 0, 1 } == destructionsWhileProcessing<ThreadConfinedTraits>()));
+    }
+
+    TEST(verifyThreadConfinedMessageIsOwnedByTheThreadReferencingItFirst)
+    {
+        wield::ThreadConfinedReferenceCount count;
+        CHECK(count.owner() == std::thread::id());
+
+        // a message made on another thread, and handed over unreferenced.
+        std::thread([&count]{ count.increment(); count.decrement(); }).join();
+
+        count.increment();
+        CHECK(count.owner() == std::this_thread::get_id());
+        CHECK(count.decrement());
+    }
+
+    using UniqueMessage = TrackedMessage<UniqueTraits::Message>;
+
+    TEST(verifyUniqueHandleIsEmptiedByDispatching)
+    {
+        UniqueTraits::Dispatcher d;
+        UniqueTraits::Queue q1;
+        UniqueTraits::Queue q2;
+        CountingProcessingFunctor forward(d, Stages::Stage2);
+        CountingProcessingFunctor f;
+        UniqueTraits::Stage s1(Stages::Stage1, d, q1, forward);
+        UniqueTraits::Stage s2(Stages::Stage2, d, q2, f);
+
+        int destroyed = 0;
+        UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+        d.dispatch(Stages::Stage1, *m);
+        CHECK(!m);
+
+        // forwarded, the first stage lets go of it.
+        CHECK(s1.process());
+        CHECK_EQUAL(0, destroyed);
+        CHECK_EQUAL(1U, q2.unsafe_size());
+
+        CHECK(s2.process());
+        CHECK_EQUAL(1, destroyed);
+        CHECK_EQUAL(1, f.count_);
+    }
+
+    TEST(verifyUniqueMessageCanOnlyBeDispatchedOnce)
+    {
+        UniqueTraits::Dispatcher d;
+        UniqueTraits::Queue q1;
+        UniqueTraits::Queue q2;
+        CountingProcessingFunctor f1;
+        CountingProcessingFunctor f2;
+        UniqueTraits::Stage s1(Stages::Stage1, d, q1, f1);
+        UniqueTraits::Stage s2(Stages::Stage2, d, q2, f2);
+
+        int destroyed = 0;
+        UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+        UniqueTraits::Message& message = *m;
+        d.dispatch(Stages::Stage1, message);
+
+        // the first queue holds it now, a second would share it.
+        CHECK_THROW(d.dispatch(Stages::Stage2, message), wield::FanoutOfUniquelyOwnedMessage);
+        CHECK_EQUAL(0U, q2.unsafe_size());
+
+        CHECK(s1.process());
+        CHECK(!s2.process());
+        CHECK_EQUAL(1, destroyed);
+        CHECK_EQUAL(1, f1.count_);
+    }
+
+    TEST(verifyTimerWheelPassesAUniqueMessageOn)
+    {
+        UniqueTraits::Dispatcher d;
+        UniqueTraits::Queue q;
+        CountingProcessingFunctor f;
+        UniqueTraits::Stage s(Stages::Stage1, d, q, f);
+
+        const std::chrono::steady_clock::time_point start;
+        wield::adapters::TimerWheel<Stages, UniqueTraits::Message> wheel(d, std::chrono::milliseconds(1), start);
+
+        int destroyed = 0;
+        UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+        wheel.scheduleAt(Stages::Stage1, *m, start + std::chrono::milliseconds(2));
+        CHECK(!m);
+
+        CHECK_EQUAL(1U, wheel.expire(start + std::chrono::milliseconds(3)));
+        CHECK(s.process());
+        CHECK_EQUAL(1, destroyed);
+        CHECK_EQUAL(1, f.count_);
+    }
+
+    TEST(verifyUniqueHandleMovesAndFreesWhatItOwns)
+    {
+        int destroyed = 0;
+        {
+            UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+            UniqueTraits::Message::smartptr n(std::move(m));
+            CHECK(!m);
+            CHECK(n);
+
+            UniqueTraits::Message::smartptr o;
+            o = std::move(n);
+            CHECK(!n);
+            CHECK_EQUAL(0, destroyed);
+        }
+
+        CHECK_EQUAL(1, destroyed);
+
+        UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+        m.reset();
+        CHECK(!m);
+        CHECK_EQUAL(2, destroyed);
+
+        CHECK((!std::is_copy_constructible<UniqueTraits::Message::smartptr>::value));
+    }
+
+    TEST(verifyFanoutOfUniqueMessageTakesClones)
+    {
+        UniqueTraits::Dispatcher d;
+        UniqueTraits::Queue q2;
+        UniqueTraits::Queue q3;
+        CountingProcessingFunctor f2;
+        CountingProcessingFunctor f3;
+        UniqueTraits::Stage s2(Stages::Stage2, d, q2, f2);
+        UniqueTraits::Stage s3(Stages::Stage3, d, q3, f3);
+
+        int destroyed = 0;
+        UniqueTraits::Message::smartptr m = new UniqueMessage(destroyed);
+
+        const Stages stages[] = { Stages::Stage2, Stages::Stage3 };
+        CHECK_THROW(d.dispatchFanout(std::begin(stages), std::end(stages), *m), wield::FanoutOfUniquelyOwnedMessage);
+        CHECK(m);
+
+        UniqueMessage& original = static_cast<UniqueMessage&>(*m);
+        d.dispatch(Stages::Stage2, original, wield::clone_message);
+        d.dispatch(Stages::Stage3, *m);
+        CHECK(!m);
+
+        CHECK(s2.process());
+        CHECK(s3.process());
+        CHECK_EQUAL(2, destroyed);
+        CHECK_EQUAL(1, f2.count_);
+        CHECK_EQUAL(1, f3.count_);
+    }
+}
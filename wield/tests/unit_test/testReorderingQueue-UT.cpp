@@ -0,0 +1,261 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_static/Traits.hpp"
+#include "./test_static/Message.hpp"
+
+#include <wield/adapters/ReorderingQueue.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace test_static;
+
+    using Message = Traits::Message;
+
+    class SequencedMessage : public TestMessage
+    {
+    public:
+        SequencedMessage(const std::uint64_t sequence)
+            : sequence_(sequence)
+        {
+        }
+
+        std::uint64_t sequence() const { return sequence_; }
+
+    private:
+        const std::uint64_t sequence_;
+    };
+
+    struct BySequence
+    {
+        std::uint64_t operator()(const Message::ptr& m) const { return static_cast<const SequencedMessage&>(*m).sequence(); }
+    };
+
+    using ReorderingQueue = wield::adapters::ReorderingQueue<Message::ptr, BySequence, Traits::SimpleQueue>;
+
+    static const std::chrono::nanoseconds NeverSkip = std::chrono::nanoseconds::max();
+
+    std::uint64_t sequenceOf(const Message::ptr m)
+    {
+        return BySequence()(m);
+    }
+
+    TEST(verifyReorderingQueueReleasesMessagesInSequence)
+    {
+        ReorderingQueue q(4, NeverSkip);
+
+        std::vector<Message::smartptr> messages;
+        for(std::uint64_t sequence = 0; sequence < 4; ++sequence)
+        {
+            messages.push_back(new SequencedMessage(sequence));
+        }
+
+        q.push(messages[2].get());
+        q.push(messages[1].get());
+        q.push(messages[3].get());
+        CHECK_EQUAL(3U, q.unsafe_size());
+
+        Message::ptr m = nullptr;
+        CHECK(!q.try_pop(m));
+
+        q.push(messages[0].get());
+
+        for(std::uint64_t sequence = 0; sequence < 4; ++sequence)
+        {
+            CHECK(q.try_pop(m));
+            CHECK_EQUAL(sequence, sequenceOf(m));
+        }
+
+        CHECK(!q.try_pop(m));
+        CHECK_EQUAL(0U, q.unsafe_size());
+        CHECK_EQUAL(4U, q.nextSequence());
+        CHECK_EQUAL(0U, q.gapsSkipped());
+    }
+
+    TEST(verifyReorderingQueueHoldsMessagesBeyondTheWindow)
+    {
+        ReorderingQueue q(2, NeverSkip, 10);
+
+        std::vector<Message::smartptr> messages;
+        for(std::uint64_t sequence = 10; sequence < 16; ++sequence)
+        {
+            messages.push_back(new SequencedMessage(sequence));
+        }
+
+        for(auto it = messages.rbegin(); it != messages.rend(); ++it)
+        {
+            q.push(it->get());
+        }
+        CHECK_EQUAL(6U, q.unsafe_size());
+
+        Message::ptr m = nullptr;
+        for(std::uint64_t sequence = 10; sequence < 16; ++sequence)
+        {
+            CHECK(q.try_pop(m));
+            CHECK_EQUAL(sequence, sequenceOf(m));
+        }
+
+        CHECK(!q.try_pop(m));
+        CHECK_EQUAL(0U, q.unsafe_size());
+    }
+
+    TEST(verifyReorderingQueueSkipsGapAfterTimeout)
+    {
+        ReorderingQueue q(8, std::chrono::milliseconds(10));
+
+        Message::smartptr m0 = new SequencedMessage(0);
+        Message::smartptr m1 = new SequencedMessage(1);
+        Message::smartptr m3 = new SequencedMessage(3);
+        Message::smartptr m4 = new SequencedMessage(4);
+
+        q.push(m0.get());
+        q.push(m3.get());
+        q.push(m4.get());
+
+        Message::ptr m = nullptr;
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m0.get(), m);
+
+        // 1 and 2 are missing, wait for them until the timeout.
+        CHECK(!q.try_pop(m));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m3.get(), m);
+        CHECK_EQUAL(2U, q.gapsSkipped());
+
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m4.get(), m);
+
+        // a message arriving after its gap was skipped is released rather than lost.
+        q.push(m1.get());
+        CHECK_EQUAL(1U, q.unsafe_size());
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m1.get(), m);
+
+        CHECK(!q.try_pop(m));
+        CHECK_EQUAL(5U, q.nextSequence());
+    }
+
+    TEST(verifyReorderingQueueSkipsAWholeGapAtOnce)
+    {
+        ReorderingQueue q(4, std::chrono::milliseconds(10));
+
+        Message::smartptr m0 = new SequencedMessage(0);
+        Message::smartptr m100 = new SequencedMessage(100);
+
+        q.push(m0.get());
+        q.push(m100.get());
+
+        Message::ptr m = nullptr;
+        CHECK(q.try_pop(m));
+        CHECK(!q.try_pop(m));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        // straight to the message beyond the window, not a window at a time.
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m100.get(), m);
+        CHECK_EQUAL(99U, q.gapsSkipped());
+        CHECK_EQUAL(101U, q.nextSequence());
+    }
+
+    // counts every push, a message put back into the overflow included.
+    class CountingQueue : public Traits::SimpleQueue
+    {
+    public:
+        void push(const Message::ptr& message)
+        {
+            pushes++;
+            Traits::SimpleQueue::push(message);
+        }
+
+        static std::size_t pushes;
+    };
+
+    std::size_t CountingQueue::pushes = 0;
+
+    TEST(verifyReorderingQueueLeavesTheOverflowAloneWhileWaitingOnAGap)
+    {
+        wield::adapters::ReorderingQueue<Message::ptr, BySequence, CountingQueue> q(2, NeverSkip);
+        CountingQueue::pushes = 0;
+
+        Message::smartptr m0 = new SequencedMessage(0);
+        Message::smartptr m1 = new SequencedMessage(1);
+        Message::smartptr m10 = new SequencedMessage(10);
+
+        q.push(m1.get());
+        q.push(m10.get());
+        CHECK_EQUAL(1U, CountingQueue::pushes);
+
+        // nothing in the overflow fits the window, polling doesn't move it around.
+        Message::ptr m = nullptr;
+        for(int poll = 0; poll < 100; ++poll)
+        {
+            CHECK(!q.try_pop(m));
+        }
+        CHECK_EQUAL(1U, CountingQueue::pushes);
+
+        q.push(m0.get());
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m0.get(), m);
+        CHECK(q.try_pop(m));
+        CHECK_EQUAL(m1.get(), m);
+        CHECK(!q.try_pop(m));
+        CHECK_EQUAL(1U, q.unsafe_size());
+        CHECK_EQUAL(1U, CountingQueue::pushes);
+    }
+
+    TEST(verifyReorderingQueueRestoresOrderFromSeveralProducers)
+    {
+        static const std::size_t NumberOfProducers = 4;
+        static const std::uint64_t NumberOfMessages = 20000;
+
+        ReorderingQueue q(64, NeverSkip);
+
+        std::vector<Message::smartptr> messages;
+        for(std::uint64_t sequence = 0; sequence < NumberOfMessages; ++sequence)
+        {
+            messages.push_back(new SequencedMessage(sequence));
+        }
+
+        // each producer pushes every NumberOfProducers'th message, so
+        // arrivals interleave out of order as they would from a parallel stage.
+        std::vector<std::thread> producers;
+        for(std::size_t p = 0; p < NumberOfProducers; ++p)
+        {
+            producers.emplace_back([&, p]{
+                for(std::uint64_t sequence = p; sequence < NumberOfMessages; sequence += NumberOfProducers)
+                {
+                    q.push(messages[sequence].get());
+                }
+            });
+        }
+
+        std::uint64_t outOfOrder = 0;
+        std::uint64_t expected = 0;
+        while(expected < NumberOfMessages)
+        {
+            Message::ptr m = nullptr;
+            if(q.try_pop(m))
+            {
+                if(sequenceOf(m) != expected)
+                {
+                    outOfOrder++;
+                }
+                expected++;
+            }
+        }
+
+        for(auto& p : producers)
+        {
+            p.join();
+        }
+
+        CHECK_EQUAL(0U, outOfOrder);
+        CHECK_EQUAL(0U, q.unsafe_size());
+    }
+}
@@ -0,0 +1,111 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_adapter/Message.hpp"
+#include "./test_io/Message.hpp"
+
+#include <wield/serialization/Envelope.hpp>
+#include <wield/serialization/MessageRegistry.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+    using namespace test_adapter;
+    using namespace test_io;
+
+    using MessagePtr = Message::ptr;
+    using Registry = wield::serialization::MessageRegistry<Message>;
+
+    // the buffers a ring or socket would hand over are 8 byte aligned.
+    struct Buffer
+    {
+        alignas(8) char data[64];
+    };
+
+    TEST(verifyRegistryRoundTripsMessagesByTypeId)
+    {
+        Registry registry;
+        registry.add<Quote>().add<Trade>();
+
+        CHECK(registry.contains(Quote::TypeId));
+        CHECK(registry.contains(Trade::TypeId));
+        CHECK(!registry.contains(3));
+
+        Buffer buffer;
+        Message::smartptr sent = new Quote(QuotePayload{ 101, 5 });
+        const std::size_t length = registry.serialize(*sent, buffer.data, sizeof(buffer.data));
+        CHECK_EQUAL(sizeof(wield::serialization::Envelope) + sizeof(QuotePayload), length);
+
+        Message::smartptr received = registry.deserialize(buffer.data, length);
+        CHECK_EQUAL(Quote::TypeId, received->typeId());
+
+        const Quote* quote = dynamic_cast<const Quote*>(received.get());
+        CHECK(quote != nullptr);
+        CHECK_EQUAL(101U, quote->payload().price);
+        CHECK_EQUAL(5U, quote->payload().size);
+    }
+
+    TEST(verifyPayloadIsReadInPlaceWithoutCreatingAMessage)
+    {
+        Buffer buffer;
+        const Trade trade(TradePayload{ 77 });
+        const std::size_t length = wield::serialization::serialize(trade, buffer.data, sizeof(buffer.data));
+
+        const TradePayload* payload = Registry::view<Trade>(buffer.data, length);
+        CHECK(payload != nullptr);
+        CHECK(static_cast<const void*>(payload) == buffer.data + sizeof(wield::serialization::Envelope));
+        CHECK_EQUAL(77U, payload->price);
+
+        // the envelope says it's a trade, not a quote.
+        CHECK(Registry::view<Quote>(buffer.data, length) == nullptr);
+
+        // a truncated record isn't read.
+        CHECK(Registry::view<Trade>(buffer.data, length - 1) == nullptr);
+    }
+
+    TEST(verifyRegistryRejectsUnknownAndMalformedRecords)
+    {
+        Registry registry;
+        registry.add<Quote>();
+
+        Buffer buffer;
+        const Trade trade(TradePayload{ 1 });
+        const std::size_t length = registry.serialize(trade, buffer.data, sizeof(buffer.data));
+
+        CHECK_THROW(registry.deserialize(buffer.data, length), wield::UnknownMessageType);
+        CHECK_THROW(registry.deserialize(buffer.data, length - 1), wield::MessageTooLargeForBuffer);
+        CHECK_THROW(registry.deserialize(buffer.data, 3), wield::MessageTooLargeForBuffer);
+
+        CHECK_THROW(registry.add<Quote>(), wield::DuplicateMessageTypeRegistration);
+        CHECK_THROW(registry.add(0, &Trade::deserialize), std::invalid_argument);
+    }
+
+    TEST(verifySerializingRequiresRoomAndASerializableMessage)
+    {
+        Buffer buffer;
+
+        const Quote quote(QuotePayload{ 1, 1 });
+        CHECK_THROW(wield::serialization::serialize(quote, buffer.data, sizeof(QuotePayload)), wield::MessageTooLargeForBuffer);
+
+        // a message without the serialization hooks has no type id.
+        const TestMessage plain;
+        CHECK_EQUAL(0U, plain.typeId());
+        CHECK_THROW(wield::serialization::serialize(plain, buffer.data, sizeof(buffer.data)), wield::MessageNotSerializable);
+        CHECK_THROW(plain.serializeInto(buffer.data, sizeof(buffer.data)), wield::MessageNotSerializable);
+    }
+
+    TEST(verifyRegistryCodecSerializesThroughTheRegistry)
+    {
+        Registry registry;
+        registry.add<Trade>();
+        const wield::serialization::RegistryCodec<Message> codec(registry);
+
+        Buffer buffer;
+        const Trade trade(TradePayload{ 9 });
+        const std::size_t length = codec.serialize(trade, buffer.data, sizeof(buffer.data));
+
+        Message::smartptr received = codec.deserialize(buffer.data, length);
+        CHECK_EQUAL(9U, static_cast<const Trade&>(*received).payload().price);
+    }
+}
@@ -0,0 +1,247 @@
+#ifdef __linux__
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+#include <wield/io/SharedMemoryQueue.hpp>
+#include <wield/io/SharedMemoryRing.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+    using namespace test_adapter;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Stage = Traits::Stage;
+    using Message = Traits::Message;
+    using MessagePtr = Message::ptr;
+
+    class Quote : public TestMessage
+    {
+    public:
+        Quote(const std::uint64_t price)
+            : price_(price)
+        {
+            instances_++;
+        }
+
+        ~Quote()
+        {
+            instances_--;
+        }
+
+        std::uint64_t price() const { return price_; }
+
+        static int instances_;
+
+    private:
+        const std::uint64_t price_;
+    };
+
+    int Quote::instances_ = 0;
+
+    struct QuoteCodec
+    {
+        std::size_t serialize(const Message& message, char* buffer, std::size_t capacity) const
+        {
+            const std::uint64_t price = static_cast<const Quote&>(message).price();
+            if(sizeof(price) > capacity)
+            {
+                throw wield::MessageTooLargeForSharedMemoryRing();
+            }
+
+            std::memcpy(buffer, &price, sizeof(price));
+            return sizeof(price);
+        }
+
+        MessagePtr deserialize(const char* data, std::size_t) const
+        {
+            std::uint64_t price = 0;
+            std::memcpy(&price, data, sizeof(price));
+            return new Quote(price);
+        }
+    };
+
+    using EgressQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, wield::io::SharedMemoryEgressQueue<Message, QuoteCodec>>;
+    using IngressQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, wield::io::SharedMemoryIngressQueue<Message, QuoteCodec>>;
+
+    // records the prices of the quotes it processes.
+    class QuoteRecordingProcessingFunctor : public ProcessingFunctor
+    {
+    public:
+        void operator()(TestMessage& message) override
+        {
+            prices_.push_back(static_cast<Quote&>(message).price());
+        }
+
+        std::vector<std::uint64_t> prices_;
+    };
+
+    struct MemFd
+    {
+        MemFd() : fd(::memfd_create("wield-test-ring", MFD_CLOEXEC)) {}
+        ~MemFd() { ::close(fd); }
+
+        int fd;
+    };
+
+    std::string popString(wield::io::SharedMemoryRing& ring)
+    {
+        std::string result;
+        ring.try_pop_with([&result](const char* data, std::size_t length){ result.assign(data, length); });
+        return result;
+    }
+
+    TEST(verifySharedMemoryRingPassesRecordsBetweenMappings)
+    {
+        MemFd memory;
+        wield::io::SharedMemoryRing producer(memory.fd, 2, 16);
+
+        // a second mapping at another address stands in for the other process.
+        wield::io::SharedMemoryRing consumer(memory.fd);
+        CHECK_EQUAL(2U, consumer.capacity());
+        CHECK_EQUAL(16U, consumer.slotSize());
+
+        CHECK(producer.try_push("first", 5));
+        CHECK(producer.try_push("second", 6));
+        CHECK(!producer.try_push("third", 5));
+        CHECK_EQUAL(2U, consumer.unsafe_size());
+
+        CHECK_EQUAL("first", popString(consumer));
+        CHECK(producer.try_push("third", 5));
+
+        CHECK_EQUAL("second", popString(consumer));
+        CHECK_EQUAL("third", popString(consumer));
+        CHECK(!consumer.try_pop_with([](const char*, std::size_t){}));
+
+        CHECK_THROW(producer.try_push("far too long for a slot", 23), wield::MessageTooLargeForSharedMemoryRing);
+    }
+
+    TEST(verifySharedMemoryRingRejectsMemoryWithoutARing)
+    {
+        MemFd memory;
+        CHECK_THROW(wield::io::SharedMemoryRing ring(memory.fd), wield::InvalidSharedMemoryRing);
+
+        std::vector<char> garbage(4096, 'x');
+        CHECK_EQUAL(static_cast<ssize_t>(garbage.size()), ::write(memory.fd, garbage.data(), garbage.size()));
+        CHECK_THROW(wield::io::SharedMemoryRing ring(memory.fd), wield::InvalidSharedMemoryRing);
+    }
+
+    TEST(verifyEgressStageSerializesAndReleasesMessages)
+    {
+        MemFd memory;
+        wield::io::SharedMemoryRing egressRing(memory.fd, 8, 64);
+        wield::io::SharedMemoryRing ingressRing(memory.fd);
+
+        Dispatcher d;
+        ProcessingFunctor egressFunctor;
+        QuoteRecordingProcessingFunctor f;
+
+        EgressQueue egress(egressRing);
+        IngressQueue ingress(ingressRing);
+
+        Stage egressStage(Stages::Stage1, d, egress, egressFunctor);
+        Stage ingressStage(Stages::Stage2, d, ingress, f);
+
+        {
+            Message::smartptr m = new Quote(42);
+            d.dispatch(Stages::Stage1, *m);
+        }
+
+        // the ring holds bytes, the message itself is gone.
+        CHECK_EQUAL(0, Quote::instances_);
+        CHECK(!egressStage.process());
+        CHECK_EQUAL(1U, ingress.unsafe_size());
+
+        CHECK(ingressStage.process());
+        CHECK(!ingressStage.process());
+
+        CHECK_EQUAL(1U, f.prices_.size());
+        CHECK_EQUAL(42U, f.prices_[0]);
+        CHECK_EQUAL(0, Quote::instances_);
+
+        CHECK_THROW(ingress.push(nullptr), wield::IllegallyPushedMessageOntoIngress);
+    }
+
+    TEST(verifyEgressQueueReportsAFullRing)
+    {
+        MemFd memory;
+        wield::io::SharedMemoryRing ring(memory.fd, 2, 64);
+        wield::io::SharedMemoryEgressQueue<Message, QuoteCodec> egress(ring, std::chrono::milliseconds(10));
+
+        {
+            Message::smartptr m = new Quote(1);
+            CHECK(egress.try_push(*m));
+            CHECK(egress.try_push(*m));
+            CHECK(!egress.try_push(*m));
+        }
+
+        // nothing consumes the ring, push gives up and releases the message.
+        MessagePtr m = new Quote(2);
+        m->incrementReferenceCount();
+        CHECK_THROW(egress.push(m), wield::SharedMemoryRingFull);
+        CHECK_EQUAL(0, Quote::instances_);
+    }
+
+    TEST(verifySharedMemoryQueueCarriesMessagesBetweenProcesses)
+    {
+        static const std::uint64_t NumberOfQuotes = 1000;
+
+        MemFd memory;
+        wield::io::SharedMemoryRing ring(memory.fd, 16, 64);
+
+        const pid_t child = ::fork();
+        if(child == 0)
+        {
+            // the producing process attaches through the inherited descriptor.
+            wield::io::SharedMemoryRing attached(memory.fd);
+            wield::io::SharedMemoryEgressQueue<Message, QuoteCodec> egress(attached);
+
+            for(std::uint64_t price = 0; price < NumberOfQuotes; ++price)
+            {
+                MessagePtr m = new Quote(price);
+                m->incrementReferenceCount();
+                egress.push(m);
+            }
+
+            ::_exit(0);
+        }
+
+        Dispatcher d;
+        QuoteRecordingProcessingFunctor f;
+        IngressQueue ingress(ring);
+        Stage ingressStage(Stages::Stage1, d, ingress, f);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while(f.prices_.size() < NumberOfQuotes && std::chrono::steady_clock::now() < deadline)
+        {
+            ingressStage.process();
+        }
+
+        int status = 0;
+        ::waitpid(child, &status, 0);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        CHECK_EQUAL(NumberOfQuotes, f.prices_.size());
+
+        bool inOrder = f.prices_.size() == NumberOfQuotes;
+        for(std::uint64_t price = 0; price < NumberOfQuotes; ++price)
+        {
+            inOrder = inOrder && f.prices_[price] == price;
+        }
+        CHECK(inOrder);
+    }
+}
+#endif
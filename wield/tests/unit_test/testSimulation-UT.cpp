@@ -0,0 +1,174 @@
+#include "./platform/UnitTestSupport.hpp"
+#include <wield/simulation/Dispatcher.hpp>
+#include <wield/simulation/Simulator.hpp>
+#include <wield/simulation/StageGraph.hpp>
+#include <wield/simulation/StageNameQueue.hpp>
+#include <wield/schedulers/RoundRobin.hpp>
+#include <wield/schedulers/color/Color.hpp>
+#include <wield/polling_policies/ExhaustivePollingPolicy.hpp>
+
+#include "./test/Stages.hpp"
+
+#include <chrono>
+
+namespace {
+
+    using namespace wield::simulation;
+    using Stages = test::Stages;
+    using PollingPolicy = wield::polling_policies::ExhaustivePollingPolicy<Stages>;
+    using std::chrono::nanoseconds;
+    using std::chrono::milliseconds;
+
+    using RoundRobinDispatcher = Dispatcher<Stages>;
+    using RoundRobin = wield::schedulers::RoundRobin<RoundRobinDispatcher, PollingPolicy>;
+
+    using ColorQueue = StageNameQueue<Stages>;
+    using ColorDispatcher = Dispatcher<Stages, StageNameQueueHook<ColorQueue>>;
+    using Color = wield::schedulers::color::Color<ColorDispatcher, ColorQueue, PollingPolicy>;
+
+    Report runRoundRobin(const StageGraph<Stages>& graph, const Configuration& configuration, const nanoseconds duration)
+    {
+        RoundRobinDispatcher dispatcher;
+        RoundRobin schedulingPolicy(dispatcher, RoundRobin::MaxThreads(), configuration.cores);
+
+        Simulator<RoundRobin> simulator(dispatcher, schedulingPolicy, graph, configuration);
+        return simulator.run(duration);
+    }
+
+    TEST(verifySimulationOfASingleStageWithConstantTimes)
+    {
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::constant(nanoseconds(1000)))
+             .serviceTime(Stages::Stage1, Distribution::constant(nanoseconds(500)));
+
+        const Report report = runRoundRobin(graph, Configuration(), milliseconds(1));
+
+        CHECK_EQUAL(1000U, report.arrivals);
+        CHECK(report.departures >= 999U);
+
+        // the stage is never backed up, latency is the service time plus
+        // at most one trip around the stages.
+        CHECK(report.p50 >= nanoseconds(500));
+        CHECK(report.max < nanoseconds(1000));
+        CHECK(report.stages[0].maxDepth <= 1U);
+        CHECK(report.coreUtilization[0] > 0.49 && report.coreUtilization[0] < 0.51);
+    }
+
+    TEST(verifySimulationIsDeterministicForASeed)
+    {
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::poisson(1e6))
+             .serviceTime(Stages::Stage1, Distribution::exponential(nanoseconds(300)))
+             .serviceTime(Stages::Stage2, Distribution::exponential(nanoseconds(300)))
+             .edge(Stages::Stage1, Stages::Stage2)
+             .edge(Stages::Stage2, Stages::Stage1, 0.1);
+
+        Configuration configuration;
+        configuration.cores = 2;
+
+        const Report first = runRoundRobin(graph, configuration, milliseconds(1));
+        const Report second = runRoundRobin(graph, configuration, milliseconds(1));
+
+        CHECK(first.departures > 0U);
+        CHECK_EQUAL(first.arrivals, second.arrivals);
+        CHECK_EQUAL(first.departures, second.departures);
+        CHECK_EQUAL(first.p99.count(), second.p99.count());
+        CHECK_EQUAL(first.max.count(), second.max.count());
+    }
+
+    TEST(verifySimulationOfAnOverloadedStageGrowsItsQueue)
+    {
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::constant(nanoseconds(1000)))
+             .serviceTime(Stages::Stage1, Distribution::constant(nanoseconds(2000)));
+
+        Configuration configuration;
+        configuration.sampleInterval = nanoseconds(100000);
+
+        const Report report = runRoundRobin(graph, configuration, milliseconds(1));
+
+        // arrivals outpace service two to one.
+        CHECK(report.stages[0].finalDepth >= 490U);
+        CHECK(report.departures <= 500U);
+        CHECK(report.coreUtilization[0] > 0.99);
+
+        CHECK_EQUAL(11U, report.queueDepths.size());
+        CHECK(report.queueDepths.front().depths[0] < report.queueDepths.back().depths[0]);
+    }
+
+    TEST(verifySimulationOfColorParksIdleThreads)
+    {
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::constant(nanoseconds(1000)))
+             .serviceTime(Stages::Stage1, Distribution::constant(nanoseconds(200)))
+             .serviceTime(Stages::Stage2, Distribution::constant(nanoseconds(200)))
+             .serviceTime(Stages::Stage3, Distribution::constant(nanoseconds(200)))
+             .edge(Stages::Stage1, Stages::Stage2)
+             .edge(Stages::Stage2, Stages::Stage3);
+
+        Configuration configuration;
+        configuration.cores = 2;
+
+        ColorQueue queue;
+        ColorDispatcher dispatcher(queue);
+        Color schedulingPolicy(dispatcher, queue, configuration.cores);
+
+        Simulator<Color> simulator(dispatcher, schedulingPolicy, graph, configuration);
+        const Report report = simulator.run(milliseconds(1));
+
+        CHECK_EQUAL(1000U, report.arrivals);
+        CHECK(report.departures >= 999U);
+        CHECK_EQUAL(report.departures, report.stages[2].processed);
+    }
+
+    TEST(verifySimulationOfColorWithAStageAtItsMaxConcurrency)
+    {
+        // arrivals twice as fast as Stage1, which one core at a time may
+        // visit, can service: the second core keeps finding Stage1 full.
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::constant(nanoseconds(100)))
+             .serviceTime(Stages::Stage1, Distribution::constant(nanoseconds(200)));
+
+        Configuration configuration;
+        configuration.cores = 2;
+
+        ColorQueue queue;
+        ColorDispatcher dispatcher(queue);
+        Color schedulingPolicy(dispatcher, queue, configuration.cores);
+
+        Simulator<Color> simulator(dispatcher, schedulingPolicy, graph, configuration);
+        const Report report = simulator.run(nanoseconds(100000));
+
+        CHECK_EQUAL(1000U, report.arrivals);
+        CHECK(report.departures >= 490U && report.departures <= 500U);
+    }
+
+    TEST(verifySimulationOfColorWithStagesAtTheirMaxConcurrencyOnManyCores)
+    {
+        // four cores, and Stage1 and Stage2 only take three of them
+        // between them: whichever core is left finds both full.
+        StageGraph<Stages> graph;
+        graph.arrivals(Stages::Stage1, Distribution::constant(nanoseconds(50)))
+             .serviceTime(Stages::Stage1, Distribution::constant(nanoseconds(200)))
+             .serviceTime(Stages::Stage2, Distribution::constant(nanoseconds(100)))
+             .edge(Stages::Stage1, Stages::Stage2);
+
+        Configuration configuration;
+        configuration.cores = 4;
+
+        Color::MaxConcurrencyContainer concurrency = {{2, 1, 1}};
+
+        ColorQueue queue;
+        ColorDispatcher dispatcher(queue);
+        Color schedulingPolicy(dispatcher, queue, concurrency, configuration.cores);
+
+        Simulator<Color> simulator(dispatcher, schedulingPolicy, graph, configuration);
+        const Report report = simulator.run(nanoseconds(100000));
+
+        // two cores at Stage1 service half the arrivals, Stage2 keeps up.
+        CHECK_EQUAL(2000U, report.arrivals);
+        CHECK(report.stages[0].processed >= 990U && report.stages[0].processed <= 1000U);
+        CHECK(report.departures >= 985U);
+        CHECK_EQUAL(report.departures, report.stages[1].processed);
+    }
+}
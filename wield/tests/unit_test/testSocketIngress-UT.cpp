@@ -0,0 +1,365 @@
+#ifdef __linux__
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./platform/ConcurrentQueue.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+#include "./test_io/RecordingDispatcher.hpp"
+
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+#include <wield/io/SocketIngress.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    using namespace test_adapter;
+    using namespace test_io;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Stage = Traits::Stage;
+    using Message = Traits::Message;
+    using MessagePtr = Message::ptr;
+
+    // the received payload, still in its pooled buffer.
+    class Packet : public TestMessage
+    {
+    public:
+        Packet(wield::io::ReceiveBuffer&& buffer)
+            : buffer_(std::move(buffer))
+        {
+        }
+
+        std::string payload() const { return std::string(buffer_.data(), buffer_.size()); }
+        const wield::io::ReceiveBuffer& buffer() const { return buffer_; }
+
+    private:
+        wield::io::ReceiveBuffer buffer_;
+    };
+
+    struct MakePacket
+    {
+        MessagePtr operator()(wield::io::ReceiveBuffer&& buffer) const { return new Packet(std::move(buffer)); }
+    };
+
+    using SocketIngress = wield::io::SocketIngress<Stages, Message, MakePacket>;
+    using IngressQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, SocketIngress>;
+    using ConcreteQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Concurrency::concurrent_queue<MessagePtr>>;
+
+    sockaddr_in loopback(void)
+    {
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        return address;
+    }
+
+    // @return a socket of @type bound to an ephemeral loopback port, stored in @address.
+    int bindLoopback(const int type, sockaddr_in& address)
+    {
+        const int fd = ::socket(AF_INET, type, 0);
+
+        address = loopback();
+        ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        socklen_t length = sizeof(address);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+
+        return fd;
+    }
+
+    // visit until @ingress has received @count messages, or give up after a while.
+    void visitUntil(SocketIngress& ingress, const std::size_t count)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        MessagePtr none = nullptr;
+
+        while(ingress.received() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            CHECK(!ingress.try_pop(none));
+        }
+    }
+
+    TEST(verifySocketIngressReceivesDatagramsIntoPooledBuffers)
+    {
+        wield::io::ReceiveBufferPool pool(1500, 8);
+        RecordingDispatcher d;
+        SocketIngress ingress(d, Stages::Stage2, pool);
+
+        sockaddr_in address;
+        ingress.addSocket(bindLoopback(SOCK_DGRAM, address));
+
+        const int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+        const std::vector<std::string> payloads = { "one", "two", "three" };
+        for(const auto& payload : payloads)
+        {
+            ::sendto(sender, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+
+        visitUntil(ingress, payloads.size());
+
+        CHECK_EQUAL(payloads.size(), d.messages.size());
+        for(std::size_t i = 0; i < payloads.size(); ++i)
+        {
+            CHECK(Stages::Stage2 == d.stages[i]);
+            CHECK_EQUAL(payloads[i], d.recorded<Packet>(i).payload());
+        }
+
+        const auto& buffer = d.recorded<Packet>(0).buffer();
+        CHECK_EQUAL(sizeof(sockaddr_in), static_cast<std::size_t>(buffer.sourceLength()));
+
+        // the messages hold their buffers, destroying them gives the buffers back.
+        const std::size_t available = pool.available();
+        d.messages.clear();
+        CHECK_EQUAL(available + payloads.size(), pool.available());
+
+        CHECK_THROW(ingress.push(nullptr), wield::IllegallyPushedMessageOntoIngress);
+
+        ::close(sender);
+    }
+
+    // @return false if a buffer taken by this thread was handed out to another meanwhile.
+    bool churn(wield::io::ReceiveBufferPool& pool, const char id)
+    {
+        bool exclusive = true;
+
+        for(int i = 0; i < 20000; ++i)
+        {
+            wield::io::ReceiveBuffer buffer = pool.acquire();
+            if(!buffer)
+            {
+                continue;
+            }
+
+            std::memset(buffer.data(), id, buffer.capacity());
+            exclusive = exclusive && buffer.data()[0] == id && buffer.data()[buffer.capacity() - 1] == id;
+        }
+
+        return exclusive;
+    }
+
+    TEST(verifyReceiveBufferPoolIsSharedBetweenThreads)
+    {
+        wield::io::ReceiveBufferPool pool(16, 4);
+
+        bool exclusive[4] = {false, false, false, false};
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool, &exclusive, t]() { exclusive[t] = churn(pool, static_cast<char>('a' + t)); });
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for(const bool e : exclusive)
+        {
+            CHECK(e);
+        }
+
+        CHECK_EQUAL(4U, pool.available());
+    }
+
+    TEST(verifySocketIngressStopsReadingWhenThePoolIsExhausted)
+    {
+        wield::io::ReceiveBufferPool pool(64, 2);
+        RecordingDispatcher d;
+        SocketIngress ingress(d, Stages::Stage2, pool);
+
+        sockaddr_in address;
+        ingress.addSocket(bindLoopback(SOCK_DGRAM, address));
+
+        const int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+        for(int i = 0; i < 4; ++i)
+        {
+            const std::string payload = std::to_string(i);
+            ::sendto(sender, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+
+        visitUntil(ingress, 2);
+        CHECK_EQUAL(2U, d.messages.size());
+        CHECK_EQUAL(0U, pool.available());
+
+        // nothing is lost, the rest waits in the socket until buffers return.
+        MessagePtr none = nullptr;
+        ingress.try_pop(none);
+        CHECK_EQUAL(2U, d.messages.size());
+
+        d.messages.clear();
+        visitUntil(ingress, 4);
+
+        CHECK_EQUAL(2U, d.messages.size());
+        CHECK_EQUAL("2", d.recorded<Packet>(0).payload());
+        CHECK_EQUAL("3", d.recorded<Packet>(1).payload());
+
+        ::close(sender);
+    }
+
+    // throws instead of recording the first @failures messages dispatched to it.
+    struct ThrowingDispatcher : RecordingDispatcher
+    {
+        void dispatch(Stages stageName, Message& message)
+        {
+            if(failures != 0)
+            {
+                --failures;
+                throw std::runtime_error("dispatch failed");
+            }
+
+            RecordingDispatcher::dispatch(stageName, message);
+        }
+
+        int failures = 1;
+    };
+
+    // visit until @dispatcher has recorded @count messages, or give up after a while.
+    // @return true if a visit threw.
+    bool visitUntilRecorded(SocketIngress& ingress, const RecordingDispatcher& dispatcher, const std::size_t count)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        MessagePtr none = nullptr;
+        bool threw = false;
+
+        while(dispatcher.messages.size() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            try
+            {
+                ingress.try_pop(none);
+            }
+            catch(const std::runtime_error&)
+            {
+                threw = true;
+            }
+        }
+
+        return threw;
+    }
+
+    TEST(verifySocketIngressKeepsItsBuffersWhenADispatchThrows)
+    {
+        wield::io::ReceiveBufferPool pool(64, 8);
+        ThrowingDispatcher d;
+        std::unique_ptr<SocketIngress> ingress(new SocketIngress(d, Stages::Stage2, pool));
+
+        sockaddr_in address;
+        ingress->addSocket(bindLoopback(SOCK_DGRAM, address));
+
+        const int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+        for(int i = 0; i < 3; ++i)
+        {
+            const std::string payload = std::to_string(i);
+            ::sendto(sender, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+
+        // the first is lost with the exception, the rest of its batch isn't.
+        CHECK(visitUntilRecorded(*ingress, d, 2));
+        CHECK_EQUAL(2U, d.messages.size());
+
+        // later datagrams mustn't be received into a buffer a message still holds.
+        const std::string payload = "3";
+        ::sendto(sender, payload.data(), payload.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        CHECK(!visitUntilRecorded(*ingress, d, 3));
+        CHECK_EQUAL(3U, d.messages.size());
+        CHECK_EQUAL("1", d.recorded<Packet>(0).payload());
+        CHECK_EQUAL("2", d.recorded<Packet>(1).payload());
+        CHECK_EQUAL("3", d.recorded<Packet>(2).payload());
+
+        // and every buffer, the lost message's too, goes back to the pool.
+        ingress.reset();
+        d.messages.clear();
+        CHECK_EQUAL(8U, pool.available());
+
+        ::close(sender);
+    }
+
+    TEST(verifySocketIngressAcceptsAndReadsStreamConnections)
+    {
+        wield::io::ReceiveBufferPool pool(1024, 8);
+        RecordingDispatcher d;
+        SocketIngress ingress(d, Stages::Stage3, pool);
+
+        sockaddr_in address;
+        const int listener = bindLoopback(SOCK_STREAM, address);
+        ::listen(listener, 4);
+        ingress.addSocket(listener);
+
+        const int client = ::socket(AF_INET, SOCK_STREAM, 0);
+        CHECK_EQUAL(0, ::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+
+        const std::string payload = "hello over tcp";
+        ::send(client, payload.data(), payload.size(), 0);
+
+        visitUntil(ingress, 1);
+
+        CHECK_EQUAL(1U, d.messages.size());
+        CHECK(Stages::Stage3 == d.stages[0]);
+        CHECK_EQUAL(payload, d.recorded<Packet>(0).payload());
+
+        // the connection is dropped once the peer closes it.
+        ::close(client);
+
+        MessagePtr none = nullptr;
+        for(int i = 0; i < 10; ++i)
+        {
+            ingress.try_pop(none);
+        }
+        CHECK_EQUAL(1U, ingress.received());
+    }
+
+    TEST(verifyIngressStageDispatchesToTargetStage)
+    {
+        wield::io::ReceiveBufferPool pool(1500, 4);
+
+        Dispatcher d;
+        ProcessingFunctor ingressFunctor;
+        ProcessingFunctor f;
+        IngressQueue ingressQueue(d, Stages::Stage2, pool);
+        ConcreteQueue q;
+
+        Stage ingressStage(Stages::Stage1, d, ingressQueue, ingressFunctor);
+        Stage s(Stages::Stage2, d, q, f);
+
+        sockaddr_in address;
+        ingressQueue.queue().addSocket(bindLoopback(SOCK_DGRAM, address));
+
+        const int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ::sendto(sender, "x", 1, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(q.unsafe_size() == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            CHECK(!ingressStage.process());
+        }
+
+        const std::size_t available = pool.available();
+
+        CHECK(s.process());
+        CHECK_EQUAL(1U, f.message1CallCount_);
+        CHECK_EQUAL(0U, ingressFunctor.message1CallCount_);
+
+        // processed and released, the buffer is back in the pool.
+        CHECK_EQUAL(available + 1, pool.available());
+
+        ::close(sender);
+    }
+}
+#endif
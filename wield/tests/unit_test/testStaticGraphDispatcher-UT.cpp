@@ -0,0 +1,206 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_static/Traits.hpp"
+#include "./test_static/Message.hpp"
+#include "./test_static/ProcessingFunctor.hpp"
+
+#include <wield/platform/thread.hpp>
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+    using namespace test_static;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Message = Traits::Message;
+    using Queue = Traits::Queue;
+    using SimpleQueue = Traits::SimpleQueue;
+    using Scheduler = Traits::Scheduler;
+
+    using Stage1 = Traits::Stage<Stages::Stage1>;
+    using Stage2 = Traits::Stage<Stages::Stage2>;
+    using Stage3 = Traits::Stage<Stages::Stage3>;
+
+    // each stage has its own concrete queue & processing functor type.
+    static_assert(std::is_same<Stage1::Queue, Queue>::value, "Stage1 should use the concurrent queue.");
+    static_assert(std::is_same<Stage2::Queue, SimpleQueue>::value, "Stage2 should use the simple queue.");
+    static_assert(std::is_same<Stage1::ProcessingFunctorType, ForwardingProcessingFunctor>::value, "Stage1 should use the concrete functor type.");
+
+    struct StaticGraphFixture
+    {
+        StaticGraphFixture()
+            : f1(d)
+            , s1(d, q1, f1)
+            , s2(d, q2, f2)
+            , s3(d, q3, f3)
+        {
+        }
+
+        Dispatcher d;
+
+        Queue q1;
+        ForwardingProcessingFunctor f1;
+        Stage1 s1;
+
+        SimpleQueue q2;
+        CountingProcessingFunctor f2;
+        Stage2 s2;
+
+        Queue q3;
+        CountingProcessingFunctor f3;
+        Stage3 s3;
+    };
+
+    TEST_FIXTURE(StaticGraphFixture, verifyStaticDispatcherInstantiation)
+    {
+        CHECK_EQUAL(&s1, &d.stage<Stages::Stage1>());
+        CHECK_EQUAL(&s2, &d.stage<Stages::Stage2>());
+        CHECK_EQUAL(&s3, &d.stage<Stages::Stage3>());
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyStaticDispatcherThrowsIfStageNameIsRegisteredTwice)
+    {
+        CHECK_THROW(Stage2 duplicate(d, q2, f2);, std::runtime_error);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyCompileTimeDispatch)
+    {
+        Message::smartptr m = new TestMessage();
+
+        d.dispatch<Stages::Stage2>(*m);
+        CHECK_EQUAL(1U, q2.unsafe_size());
+
+        CHECK(s2.process());
+        CHECK_EQUAL(1U, f2.message1CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyRunTimeDispatchRoutesToConcreteStage)
+    {
+        Message::smartptr m = new TestMessage2();
+
+        d.dispatch(Stages::Stage3, *m);
+        d.dispatch(Stages::Stage2, *m);
+        d.dispatch(Stages::Stage3, *m);
+
+        CHECK_EQUAL(0U, q1.unsafe_size());
+        CHECK_EQUAL(1U, q2.unsafe_size());
+        CHECK_EQUAL(2U, q3.unsafe_size());
+
+        CHECK(d.process(Stages::Stage2));
+        CHECK(d.process(Stages::Stage3));
+        CHECK(d.process(Stages::Stage3));
+        CHECK(!d.process(Stages::Stage3));
+
+        CHECK_EQUAL(1U, f2.message2CallCount_);
+        CHECK_EQUAL(2U, f3.message2CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyDispatchBatchUsesBulkPushWhenAvailable)
+    {
+        std::array<Message::ptr, 3> batch = {{ new TestMessage(), new TestMessage2(), new TestMessage() }};
+
+        d.dispatchBatch<Stages::Stage2>(begin(batch), end(batch));
+        CHECK_EQUAL(3U, q2.unsafe_size());
+        CHECK_EQUAL(1U, q2.bulkPushCount_);
+
+        CHECK(s2.process());
+        CHECK(s2.process());
+        CHECK(s2.process());
+        CHECK_EQUAL(2U, f2.message1CallCount_);
+        CHECK_EQUAL(1U, f2.message2CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyRunTimeDispatchBatch)
+    {
+        std::array<Message::smartptr, 2> batch = {{ new TestMessage(), new TestMessage() }};
+
+        d.dispatchBatch(Stages::Stage3, begin(batch), end(batch));
+        d.dispatchBatch(Stages::Stage2, begin(batch), end(batch));
+
+        // smart pointers are pushed individually.
+        CHECK_EQUAL(2U, q3.unsafe_size());
+        CHECK_EQUAL(2U, q2.unsafe_size());
+        CHECK_EQUAL(0U, q2.bulkPushCount_);
+
+        CHECK(d.process(Stages::Stage3));
+        CHECK(d.process(Stages::Stage3));
+        CHECK(d.process(Stages::Stage2));
+        CHECK(d.process(Stages::Stage2));
+        CHECK_EQUAL(2U, f3.message1CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyDispatchByCloning)
+    {
+        TestMessage m;
+
+        d.dispatch<Stages::Stage2>(m, wield::clone_message);
+        d.dispatch(Stages::Stage3, m, wield::clone_message);
+
+        Message::ptr clone = nullptr;
+        CHECK(q2.try_pop(clone));
+        CHECK(clone != &m);
+        delete clone;
+
+        CHECK(q3.try_pop(clone));
+        CHECK(clone != &m);
+        delete clone;
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyMessagesFlowThroughTheGraph)
+    {
+        Message::smartptr m = new TestMessage();
+        Message::smartptr m2 = new TestMessage2();
+
+        d.dispatch<Stages::Stage1>(*m);
+        d.dispatch<Stages::Stage1>(*m2);
+
+        CHECK(s1.process());    // TestMessage -> Stage2
+        CHECK(s1.process());    // TestMessage2 -> Stage3
+
+        CHECK(s2.process());
+        CHECK(s3.process());
+
+        CHECK_EQUAL(1U, f2.message1CallCount_);
+        CHECK_EQUAL(0U, f2.message2CallCount_);
+        CHECK_EQUAL(0U, f3.message1CallCount_);
+        CHECK_EQUAL(1U, f3.message2CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyStageHandlesForSchedulingPolicies)
+    {
+        Message::smartptr m = new TestMessage();
+        d.dispatch<Stages::Stage2>(*m);
+
+        Dispatcher::StageType& handle = d[Stages::Stage2];
+        CHECK_EQUAL(Stages::Stage2, handle.name());
+        CHECK_EQUAL(&handle, &d[Stages::Stage2]);
+
+        CHECK(handle.process());
+        CHECK(!handle.process());
+        CHECK_EQUAL(1U, f2.message1CallCount_);
+    }
+
+    TEST_FIXTURE(StaticGraphFixture, verifyStaticDispatcherCanBeScheduled)
+    {
+        Scheduler scheduler(d);
+
+        Message::smartptr m = new TestMessage();
+        d.dispatch<Stages::Stage1>(*m);
+
+        std::thread t([&scheduler]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            scheduler.stop();
+        });
+
+        scheduler.start();
+        scheduler.join();
+        t.join();
+
+        CHECK_EQUAL(1U, f2.message1CallCount_);
+    }
+}
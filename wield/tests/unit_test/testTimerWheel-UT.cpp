@@ -0,0 +1,194 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./platform/ConcurrentQueue.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+#include "./test_io/RecordingDispatcher.hpp"
+
+#include <wield/adapters/TimerWheel.hpp>
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    using namespace test_adapter;
+    using namespace test_io;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Queue = Traits::Queue;
+    using Stage = Traits::Stage;
+    using Message = Traits::Message;
+    using MessagePtr = Message::ptr;
+
+    using TimerWheel = wield::adapters::TimerWheel<Stages, Message>;
+    using TimerQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, TimerWheel>;
+    using ConcreteQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Concurrency::concurrent_queue<MessagePtr>>;
+
+    using Clock = TimerWheel::Clock;
+    using std::chrono::milliseconds;
+
+    TEST(verifyTimerWheelDispatchesTimeoutsWhenTheyExpire)
+    {
+        RecordingDispatcher d;
+        const Clock::time_point start = Clock::now();
+        TimerWheel timers(d, milliseconds(1), start);
+
+        Message::smartptr m1 = new TestMessage();
+        Message::smartptr m2 = new TestMessage2();
+
+        timers.scheduleAt(Stages::Stage2, *m1, start + milliseconds(10));
+        timers.scheduleAt(Stages::Stage3, *m2, start + milliseconds(300));
+        CHECK_EQUAL(2U, timers.size());
+
+        CHECK_EQUAL(0U, timers.expire(start + milliseconds(9)));
+
+        CHECK_EQUAL(1U, timers.expire(start + milliseconds(10)));
+        CHECK(Stages::Stage2 == d.stages[0]);
+        CHECK_EQUAL(m1.get(), d.messages[0].get());
+
+        // the second timeout was a level up, and is moved down to expire on time.
+        CHECK_EQUAL(0U, timers.expire(start + milliseconds(299)));
+        CHECK_EQUAL(1U, timers.expire(start + milliseconds(400)));
+        CHECK(Stages::Stage3 == d.stages[1]);
+        CHECK_EQUAL(m2.get(), d.messages[1].get());
+
+        CHECK_EQUAL(0U, timers.size());
+    }
+
+    TEST(verifyTimerWheelExpiresTimeoutsOnEveryLevelInOrder)
+    {
+        RecordingDispatcher d;
+        const Clock::time_point start = Clock::now();
+        TimerWheel timers(d, milliseconds(1), start);
+
+        // spread over all levels, and beyond the last one.
+        const std::vector<std::size_t> deadlines = { 1, 255, 256, 257, 65535, 65536, 70000, 16777216, 20000000, 5000000000 };
+
+        std::vector<Message::smartptr> messages;
+        for(auto it = deadlines.rbegin(); it != deadlines.rend(); ++it)
+        {
+            messages.push_back(new TestMessage());
+            timers.scheduleAt(Stages::Stage1, *messages.back(), start + milliseconds(*it));
+        }
+
+        for(std::size_t i = 0; i < deadlines.size(); ++i)
+        {
+            CHECK_EQUAL(0U, timers.expire(start + milliseconds(deadlines[i] - 1)));
+            CHECK_EQUAL(1U, timers.expire(start + milliseconds(deadlines[i])));
+            CHECK_EQUAL(messages[deadlines.size() - 1 - i].get(), d.messages.back().get());
+        }
+
+        CHECK_EQUAL(0U, timers.size());
+    }
+
+    TEST(verifyTimerWheelCancelsTimeouts)
+    {
+        RecordingDispatcher d;
+        const Clock::time_point start = Clock::now();
+        TimerWheel timers(d, milliseconds(1), start);
+
+        Message::smartptr m1 = new TestMessage();
+        Message::smartptr m2 = new TestMessage();
+
+        const wield::adapters::TimerHandle h1 = timers.scheduleAt(Stages::Stage1, *m1, start + milliseconds(5));
+        const wield::adapters::TimerHandle h2 = timers.scheduleAt(Stages::Stage1, *m2, start + milliseconds(5));
+
+        CHECK(timers.cancel(h1));
+        CHECK(!timers.cancel(h1));
+        CHECK_EQUAL(1U, timers.size());
+
+        // the cancelled timer is reused, its old handle must not cancel the new one.
+        const wield::adapters::TimerHandle h3 = timers.scheduleAt(Stages::Stage1, *m1, start + milliseconds(50));
+        CHECK_EQUAL(h1.index, h3.index);
+        CHECK(!timers.cancel(h1));
+
+        CHECK_EQUAL(1U, timers.expire(start + milliseconds(10)));
+        CHECK_EQUAL(m2.get(), d.messages.back().get());
+        CHECK(!timers.cancel(h2));
+
+        CHECK(timers.cancel(h3));
+        CHECK_EQUAL(0U, timers.expire(start + milliseconds(100)));
+        CHECK_EQUAL(0U, timers.size());
+    }
+
+    // counts the messages freed.
+    class CountedMessage : public TestMessage
+    {
+    public:
+        ~CountedMessage() { ++freed; }
+        static std::size_t freed;
+    };
+
+    std::size_t CountedMessage::freed = 0;
+
+    struct ThrowingDispatcher
+    {
+        void dispatch(Stages, Message&) { throw std::runtime_error("dispatch failed"); }
+    };
+
+    TEST(verifyTimerWheelReleasesExpiredTimeoutsWhenDispatchThrows)
+    {
+        ThrowingDispatcher d;
+        const Clock::time_point start = Clock::now();
+        TimerWheel timers(d, milliseconds(1), start);
+
+        CountedMessage::freed = 0;
+        for(int i = 0; i < 3; ++i)
+        {
+            Message::smartptr m = new CountedMessage();
+            timers.scheduleAt(Stages::Stage1, *m, start + milliseconds(5));
+        }
+
+        CHECK_THROW(timers.expire(start + milliseconds(5)), std::runtime_error);
+
+        // the wheel's references are gone, and the wheel can be expired again.
+        CHECK_EQUAL(3U, CountedMessage::freed);
+        CHECK_EQUAL(0U, timers.size());
+
+        Message::smartptr m = new CountedMessage();
+        timers.scheduleAt(Stages::Stage1, *m, start + milliseconds(10));
+        CHECK_THROW(timers.expire(start + milliseconds(10)), std::runtime_error);
+    }
+
+    TEST(verifyTimerStageDispatchesExpiredTimeoutsToTargetStage)
+    {
+        Dispatcher d;
+        ProcessingFunctor timerFunctor;
+        ProcessingFunctor f;
+
+        TimerQueue timerQueue(d, milliseconds(1));
+        ConcreteQueue q;
+
+        Stage timerStage(Stages::Stage1, d, timerQueue, timerFunctor);
+        Stage s(Stages::Stage2, d, q, f);
+
+        CHECK_THROW(timerQueue.push(nullptr), wield::IllegallyPushedMessageOntoTimerWheel);
+
+        {
+            Message::smartptr m = new TestMessage();
+            timerQueue.queue().schedule(Stages::Stage2, *m, milliseconds(0));
+            timerQueue.queue().schedule(Stages::Stage2, *m, std::chrono::hours(1));
+        }
+
+        const Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+        while(q.unsafe_size() == 0 && Clock::now() < deadline)
+        {
+            // visiting the timer stage never processes anything on it.
+            CHECK(!timerStage.process());
+        }
+
+        CHECK_EQUAL(1U, q.unsafe_size());
+        CHECK(s.process());
+        CHECK_EQUAL(1U, f.message1CallCount_);
+        CHECK_EQUAL(0U, timerFunctor.message1CallCount_);
+
+        // the hour long timeout still references the message until the wheel goes.
+        CHECK_EQUAL(1U, timerQueue.queue().size());
+    }
+}
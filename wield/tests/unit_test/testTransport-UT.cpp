@@ -0,0 +1,287 @@
+#ifdef __linux__
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./platform/ConcurrentQueue.hpp"
+
+#include "./test_adapter/Traits.hpp"
+#include "./test_adapter/Message.hpp"
+#include "./test_adapter/ProcessingFunctor.hpp"
+#include "./test_io/Message.hpp"
+#include "./test_io/RecordingDispatcher.hpp"
+
+#include <wield/adapters/polymorphic/QueueAdapter.hpp>
+#include <wield/io/Transport.hpp>
+#include <wield/serialization/MessageRegistry.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    using namespace test_adapter;
+    using namespace test_io;
+
+    using Dispatcher = Traits::Dispatcher;
+    using Stage = Traits::Stage;
+    using Message = Traits::Message;
+    using MessagePtr = Message::ptr;
+
+    using Codec = wield::serialization::RegistryCodec<Message>;
+    using Egress = wield::io::TransportEgressQueue<Stages, Message, Codec>;
+    using Ingress = wield::io::TransportIngress<Stages, Message, Codec>;
+
+    using EgressQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Egress>;
+    using IngressQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Ingress>;
+    using ConcreteQueue = wield::adapters::polymorphic::QueueAdapter<MessagePtr, Concurrency::concurrent_queue<MessagePtr>>;
+
+    struct Link
+    {
+        Link()
+        {
+            registry.add<Trade>();
+            ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets);
+        }
+
+        wield::serialization::MessageRegistry<Message> registry;
+        int sockets[2];
+    };
+
+    // push a trade the way the dispatcher does, with a reference for the queue.
+    void pushTrade(Egress& egress, const std::uint64_t price)
+    {
+        MessagePtr m = new Trade(TradePayload{ price });
+        m->incrementReferenceCount();
+        egress.push(m);
+    }
+
+    // visit @ingress until it has received @count messages, or give up after a while.
+    void visitUntil(Ingress& ingress, const std::size_t count)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        MessagePtr none = nullptr;
+
+        while(ingress.received() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            CHECK(!ingress.try_pop(none));
+        }
+    }
+
+    TEST(verifyTransportDeliversMessagesInOrderToTheNamedStage)
+    {
+        Link link;
+        RecordingDispatcher d;
+
+        Egress egress(link.sockets[0], Stages::Stage3, 16, 64, std::chrono::seconds(1), Codec(link.registry));
+        Ingress ingress(d, link.sockets[1], 64, 64, Codec(link.registry));
+
+        for(std::uint64_t price = 0; price < 10; ++price)
+        {
+            pushTrade(egress, price);
+        }
+
+        // below a full window, frames wait for the egress stage's visit.
+        CHECK_EQUAL(10U, egress.unsafe_size());
+
+        MessagePtr none = nullptr;
+        CHECK(!egress.try_pop(none));
+        CHECK_EQUAL(0U, egress.unsafe_size());
+        CHECK_EQUAL(10U, egress.sent());
+
+        visitUntil(ingress, 10);
+
+        CHECK_EQUAL(10U, d.messages.size());
+        for(std::uint64_t price = 0; price < d.messages.size(); ++price)
+        {
+            CHECK(Stages::Stage3 == d.stages[price]);
+            CHECK_EQUAL(price, d.price(price));
+        }
+
+        CHECK_THROW(ingress.push(nullptr), wield::IllegallyPushedMessageOntoIngress);
+    }
+
+    TEST(verifyEgressStopsSendingWhenTheWindowIsSpent)
+    {
+        Link link;
+        RecordingDispatcher d;
+
+        Egress egress(link.sockets[0], Stages::Stage2, 4, 64, std::chrono::seconds(1), Codec(link.registry));
+        Ingress ingress(d, link.sockets[1], 64, 64, Codec(link.registry));
+
+        // the fourth push fills the window and sends it.
+        for(std::uint64_t price = 0; price < 4; ++price)
+        {
+            pushTrade(egress, price);
+        }
+        CHECK_EQUAL(4U, egress.sent());
+
+        for(std::uint64_t price = 4; price < 7; ++price)
+        {
+            pushTrade(egress, price);
+        }
+
+        MessagePtr none = nullptr;
+        egress.try_pop(none);
+        CHECK_EQUAL(4U, egress.sent());
+        CHECK_EQUAL(3U, egress.unsafe_size());
+
+        // dispatching hands the credit back.
+        visitUntil(ingress, 4);
+        egress.try_pop(none);
+        CHECK_EQUAL(7U, egress.sent());
+        CHECK_EQUAL(0U, egress.unsafe_size());
+
+        visitUntil(ingress, 7);
+        CHECK_EQUAL(7U, d.messages.size());
+        CHECK_EQUAL(6U, d.price(d.messages.size() - 1));
+    }
+
+    TEST(verifyEgressGivesUpPushingWhenTheWindowStaysFull)
+    {
+        Link link;
+        RecordingDispatcher d;
+
+        Egress egress(link.sockets[0], Stages::Stage2, 2, 64, std::chrono::milliseconds(10), Codec(link.registry));
+        Ingress ingress(d, link.sockets[1], 64, 64, Codec(link.registry));
+
+        // a window sent, and a window waiting on credit the ingress hasn't returned.
+        for(std::uint64_t price = 0; price < 4; ++price)
+        {
+            pushTrade(egress, price);
+        }
+        CHECK_EQUAL(2U, egress.sent());
+        CHECK_EQUAL(2U, egress.unsafe_size());
+
+        MessagePtr m = new Trade(TradePayload{ 4 });
+        m->incrementReferenceCount();
+        CHECK_THROW(egress.push(m), wield::TransportWindowFull);
+        CHECK_EQUAL(2U, egress.unsafe_size());
+
+        // once the far side catches up, pushing carries on.
+        visitUntil(ingress, 2);
+        pushTrade(egress, 5);
+        CHECK_EQUAL(4U, egress.sent());
+
+        visitUntil(ingress, 4);
+        MessagePtr none = nullptr;
+        egress.try_pop(none);
+        visitUntil(ingress, 5);
+
+        const std::vector<std::uint64_t> expected = { 0, 1, 2, 3, 5 };
+        CHECK_EQUAL(expected.size(), d.messages.size());
+        for(std::size_t i = 0; i < expected.size() && i < d.messages.size(); ++i)
+        {
+            CHECK_EQUAL(expected[i], d.price(i));
+        }
+    }
+
+    TEST(verifyEgressReportsALinkClosedByTheFarSide)
+    {
+        Link link;
+        Egress egress(link.sockets[0], Stages::Stage2, 4, 64, std::chrono::seconds(1), Codec(link.registry));
+        ::close(link.sockets[1]);
+
+        pushTrade(egress, 1);
+
+        MessagePtr none = nullptr;
+        CHECK_THROW(egress.try_pop(none), wield::TransportLinkClosed);
+        CHECK(egress.closed());
+
+        MessagePtr m = new Trade(TradePayload{ 2 });
+        m->incrementReferenceCount();
+        CHECK_THROW(egress.push(m), wield::TransportLinkClosed);
+    }
+
+    TEST(verifyIngressRejectsAFrameForAnUnknownStage)
+    {
+        Link link;
+        RecordingDispatcher d;
+        Ingress ingress(d, link.sockets[1], 64, 64, Codec(link.registry));
+
+        // a frame naming a stage past the end of Stages, its payload is never looked at.
+        char frame[sizeof(wield::io::TransportFrame::Header) + wield::io::TransportFrame::Alignment] = {};
+        const wield::io::TransportFrame::Header header{ htonl(wield::io::TransportFrame::Alignment), htonl(static_cast<std::uint32_t>(Stages::NumberOfEntries)) };
+        std::memcpy(frame, &header, sizeof(header));
+        CHECK_EQUAL(static_cast<ssize_t>(sizeof(frame)), ::write(link.sockets[0], frame, sizeof(frame)));
+
+        MessagePtr none = nullptr;
+        CHECK_THROW(ingress.try_pop(none), wield::UnknownStageName);
+
+        // the frame was dropped, those behind it still arrive.
+        Egress egress(link.sockets[0], Stages::Stage2, 1, 64, std::chrono::seconds(1), Codec(link.registry));
+        pushTrade(egress, 7);
+
+        visitUntil(ingress, 1);
+        CHECK_EQUAL(1U, d.messages.size());
+        CHECK(Stages::Stage2 == d.stages[0]);
+        CHECK_EQUAL(7U, d.price(0));
+    }
+
+    TEST(verifyTransportStagesSpanAStageGraphOverTcp)
+    {
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        ::listen(listener, 1);
+
+        const int client = ::socket(AF_INET, SOCK_STREAM, 0);
+        CHECK_EQUAL(0, ::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+        const int server = ::accept(listener, nullptr, nullptr);
+        ::close(listener);
+
+        wield::serialization::MessageRegistry<Message> registry;
+        registry.add<Trade>();
+
+        // the sending node: Stage1 forwards to Stage2 on the receiving node.
+        Dispatcher sender;
+        ProcessingFunctor egressFunctor;
+        EgressQueue egressQueue(client, Stages::Stage2, 8, 64, std::chrono::seconds(1), Codec(registry));
+        Stage egressStage(Stages::Stage1, sender, egressQueue, egressFunctor);
+
+        // the receiving node.
+        Dispatcher receiver;
+        ProcessingFunctor ingressFunctor;
+        ProcessingFunctor f;
+        IngressQueue ingressQueue(receiver, server, 64, 64, Codec(registry));
+        ConcreteQueue q;
+        Stage ingressStage(Stages::Stage1, receiver, ingressQueue, ingressFunctor);
+        Stage s(Stages::Stage2, receiver, q, f);
+
+        // both nodes share this thread, so visit the stages between
+        // dispatches, a full window would otherwise hold the sender back.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        for(std::uint64_t price = 0; price < 20; ++price)
+        {
+            Message::smartptr m = new Trade(TradePayload{ price });
+            sender.dispatch(Stages::Stage1, *m);
+
+            egressStage.process();
+            ingressStage.process();
+            while(s.process());
+        }
+
+        while(f.message1CallCount_ < 20 && std::chrono::steady_clock::now() < deadline)
+        {
+            egressStage.process();
+            ingressStage.process();
+            while(s.process());
+        }
+
+        CHECK_EQUAL(20U, f.message1CallCount_);
+        CHECK_EQUAL(0U, egressFunctor.message1CallCount_);
+        CHECK_EQUAL(0U, ingressFunctor.message1CallCount_);
+    }
+}
+#endif
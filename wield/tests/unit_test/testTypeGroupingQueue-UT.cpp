@@ -0,0 +1,142 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include "./test_static/Traits.hpp"
+#include "./test_static/Message.hpp"
+
+#include <wield/adapters/TypeGroupingQueue.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    using namespace test_static;
+
+    using Message = Traits::Message;
+    using TypeGroupingQueue = wield::adapters::TypeGroupingQueue<Message::ptr, Traits::SimpleQueue>;
+
+    std::vector<Message::ptr> popAll(TypeGroupingQueue& q)
+    {
+        std::vector<Message::ptr> popped;
+
+        Message::ptr m = nullptr;
+        while(q.try_pop(m))
+        {
+            popped.push_back(m);
+        }
+
+        return popped;
+    }
+
+    TEST(verifyTypeGroupingQueueGroupsEachBatchByType)
+    {
+        TypeGroupingQueue q;
+
+        Message::smartptr a1 = new TestMessage();
+        Message::smartptr b1 = new TestMessage2();
+        Message::smartptr a2 = new TestMessage();
+        Message::smartptr b2 = new TestMessage2();
+        Message::smartptr a3 = new TestMessage();
+
+        q.push(a1.get());
+        q.push(b1.get());
+        q.push(a2.get());
+        q.push(b2.get());
+        q.push(a3.get());
+        CHECK_EQUAL(5U, q.unsafe_size());
+
+        Message::ptr m = nullptr;
+        CHECK(q.try_pop(m));
+        CHECK(m == a1.get());
+        CHECK_EQUAL(4U, q.unsafe_size());
+
+        // in order within a type, types in order of first appearance.
+        const std::vector<Message::ptr> expected{ a2.get(), a3.get(), b1.get(), b2.get() };
+        CHECK(expected == popAll(q));
+        CHECK_EQUAL(0U, q.unsafe_size());
+    }
+
+    TEST(verifyTypeGroupingQueueOnlyGroupsWithinABatch)
+    {
+        TypeGroupingQueue q(3);
+
+        Message::smartptr a1 = new TestMessage();
+        Message::smartptr b1 = new TestMessage2();
+        Message::smartptr a2 = new TestMessage();
+        Message::smartptr b2 = new TestMessage2();
+        Message::smartptr a3 = new TestMessage();
+
+        const std::vector<Message::ptr> messages{ a1.get(), b1.get(), a2.get(), b2.get(), a3.get() };
+        q.push_bulk(messages.begin(), messages.end());
+        CHECK_EQUAL(1U, q.queue().bulkPushCount_);
+
+        const std::vector<Message::ptr> expected{ a1.get(), a2.get(), b1.get(), b2.get(), a3.get() };
+        CHECK(expected == popAll(q));
+    }
+
+    struct ByTypeParity
+    {
+        std::uintptr_t operator()(const Message::ptr& m) const { return dynamic_cast<const TestMessage2*>(m) != nullptr ? 1 : 0; }
+    };
+
+    TEST(verifyTypeGroupingQueueTakesATypeFunction)
+    {
+        wield::adapters::TypeGroupingQueue<Message::ptr, Traits::SimpleQueue, ByTypeParity> q;
+
+        Message::smartptr b1 = new TestMessage2();
+        Message::smartptr a1 = new TestMessage();
+        Message::smartptr b2 = new TestMessage2();
+
+        q.push(b1.get());
+        q.push(a1.get());
+        q.push(b2.get());
+
+        Message::ptr m = nullptr;
+        CHECK(q.try_pop(m));
+        CHECK(m == b1.get());
+        CHECK(q.try_pop(m));
+        CHECK(m == b2.get());
+        CHECK(q.try_pop(m));
+        CHECK(m == a1.get());
+        CHECK(!q.try_pop(m));
+    }
+
+    // fails on the first message it's asked about.
+    struct FailingOnce
+    {
+        std::uintptr_t operator()(const Message::ptr&) const
+        {
+            if(!failed)
+            {
+                failed = true;
+                throw std::runtime_error("no type");
+            }
+            return 0;
+        }
+
+        static bool failed;
+    };
+
+    bool FailingOnce::failed = false;
+
+    TEST(verifyTypeGroupingQueueCanBePoppedAfterAThrow)
+    {
+        wield::adapters::TypeGroupingQueue<Message::ptr, Traits::SimpleQueue, FailingOnce> q;
+
+        Message::smartptr a1 = new TestMessage();
+        Message::smartptr a2 = new TestMessage();
+        q.push(a1.get());
+        q.push(a2.get());
+
+        Message::ptr m = nullptr;
+        CHECK_THROW(q.try_pop(m), std::runtime_error);
+
+        // the pop claim was released, and nothing pulled was lost.
+        CHECK(q.try_pop(m));
+        CHECK(m == a1.get());
+        CHECK(q.try_pop(m));
+        CHECK(m == a2.get());
+        CHECK(!q.try_pop(m));
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../test_adapter/Message.hpp"
+
+#include <wield/serialization/FlatMessage.hpp>
+
+#include <cstdint>
+
+namespace test_io {
+
+    // flat messages of test_adapter's hierarchy, for the serialization,
+    // journal and transport tests.
+    struct QuotePayload
+    {
+        std::uint64_t price;
+        std::uint32_t size;
+    };
+
+    struct TradePayload
+    {
+        std::uint64_t price;
+    };
+
+    class Quote : public wield::serialization::FlatMessage<Quote, test_adapter::TestMessage, QuotePayload, 1>
+    {
+    public:
+        Quote(const QuotePayload& payload)
+            : FlatMessage(payload)
+        {
+        }
+    };
+
+    class Trade : public wield::serialization::FlatMessage<Trade, test_adapter::TestMessage, TradePayload, 2>
+    {
+    public:
+        Trade(const TradePayload& payload)
+            : FlatMessage(payload)
+        {
+        }
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "../test_adapter/Message.hpp"
+#include "../test_adapter/Stages.hpp"
+#include "./Message.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace test_io {
+
+    // stands in for the dispatcher of an event source, keeping what it's
+    // given alive, in order. Declare it after anything the messages hold
+    // on to, e.g. a buffer pool.
+    struct RecordingDispatcher
+    {
+        using Message = test_adapter::Message;
+
+        void dispatch(test_adapter::Stages stageName, Message& message)
+        {
+            stages.push_back(stageName);
+            messages.push_back(&message);
+        }
+
+        template<class RecordedMessage>
+        const RecordedMessage& recorded(const std::size_t i) const { return static_cast<const RecordedMessage&>(*messages[i]); }
+
+        std::uint64_t price(const std::size_t i) const { return recorded<Trade>(i).payload().price; }
+
+        std::vector<test_adapter::Stages> stages;
+        std::vector<Message::smartptr> messages;
+    };
+}
@@ -0,0 +1,17 @@
+#include "./Message.hpp"
+#include "./ProcessingFunctor.hpp"
+
+namespace test_static {
+    
+    //virtual
+    void TestMessage::processWith(ProcessingFunctorInterface& process)
+    {
+        process(*this);
+    }
+
+    //virtual
+    void TestMessage2::processWith(ProcessingFunctorInterface& process)
+    {
+        process(*this);
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "./Traits.hpp"
+
+namespace test_static {
+    
+    class ProcessingFunctorInterface;
+    using Message = Traits::Message;
+
+    class TestMessage : public Message
+    {
+    public:
+        void processWith(ProcessingFunctorInterface& process) override;
+    };
+
+    class TestMessage2 : public Message
+    {
+    public:
+        void processWith(ProcessingFunctorInterface& process) override;
+    };
+}
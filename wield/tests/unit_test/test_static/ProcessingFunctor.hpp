@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+
+#include "./Message.hpp"
+#include "./Stages.hpp"
+#include "./Traits.hpp"
+
+namespace test_static {
+    
+    class ProcessingFunctorInterface
+    {
+    public:
+        virtual ~ProcessingFunctorInterface(){}
+        
+        virtual void operator()(Message&) = 0;
+        virtual void operator()(TestMessage&) = 0;
+        virtual void operator()(TestMessage2&) = 0;
+    };
+
+    class CountingProcessingFunctor final : public ProcessingFunctorInterface
+    {
+    public:
+        CountingProcessingFunctor()
+            : messageBaseCallCount_(0)
+            , message1CallCount_(0)
+            , message2CallCount_(0)
+        {
+        }
+
+        void operator()(Message&) override { messageBaseCallCount_++; }
+        void operator()(TestMessage&) override { message1CallCount_++; }
+        void operator()(TestMessage2&) override { message2CallCount_++; }
+
+        std::size_t messageBaseCallCount_;
+        std::size_t message1CallCount_;
+        std::size_t message2CallCount_;
+    };
+
+    // forwards TestMessage to Stage2 (routed at compile-time) and
+    // TestMessage2 to Stage3 (routed at run-time).
+    class ForwardingProcessingFunctor final : public ProcessingFunctorInterface
+    {
+    public:
+        ForwardingProcessingFunctor(Traits::Dispatcher& dispatcher)
+            : dispatcher_(dispatcher)
+        {
+        }
+
+        void operator()(Message& msg) override
+        {
+            dispatcher_.dispatch(Stages::Stage3, msg);
+        }
+
+        void operator()(TestMessage& msg) override
+        {
+            dispatcher_.dispatch<Stages::Stage2>(msg);
+        }
+
+        void operator()(TestMessage2& msg) override
+        {
+            dispatcher_.dispatch(Stages::Stage3, msg);
+        }
+
+    private:
+        ForwardingProcessingFunctor(const ForwardingProcessingFunctor&) = delete;
+        ForwardingProcessingFunctor& operator=(const ForwardingProcessingFunctor&) = delete;
+
+    private:
+        Traits::Dispatcher& dispatcher_;
+    };
+}
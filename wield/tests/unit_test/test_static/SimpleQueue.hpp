@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <queue>
+
+namespace test_static {
+    
+    // A basic concurrent queue implementation using mutex to protect std::queue.
+    // Used so the stage graph has stages with differing concrete queue types.
+    template<class MessagePtr>
+    class SimpleQueue
+    {
+    public:
+        SimpleQueue()
+            : bulkPushCount_(0)
+        {
+        }
+
+        void push(const MessagePtr& message)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            queue_.push(message);
+        }
+        
+        // optional bulk enqueue, used by dispatchBatch.
+        template<class Iterator>
+        void push_bulk(Iterator first, Iterator last)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            for(; first != last; ++first)
+            {
+                queue_.push(*first);
+            }
+
+            bulkPushCount_++;
+        }
+
+        bool try_pop(MessagePtr& message)
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            
+            if(!queue_.empty())
+            {
+                message = queue_.front();
+                queue_.pop();
+                
+                return true;
+            }
+            
+            return false;
+        }
+        
+        std::size_t unsafe_size(void) const
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            return queue_.size();
+        }
+        
+        std::size_t bulkPushCount_;
+
+    private:
+        mutable std::mutex lock_;
+        std::queue<MessagePtr> queue_;
+    };
+}
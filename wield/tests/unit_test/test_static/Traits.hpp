@@ -0,0 +1,56 @@
+#pragma once
+#include <wield/MessageBase.hpp>
+#include <wield/SchedulerBase.hpp>
+
+#include <wield/polling_policies/ExhaustivePollingPolicy.hpp>
+#include <wield/schedulers/RoundRobin.hpp>
+#include <wield/static_graph/Dispatcher.hpp>
+#include <wield/static_graph/StageGraph.hpp>
+
+#include "../platform/ConcurrentQueue.hpp"
+#include "./SimpleQueue.hpp"
+#include "./Stages.hpp"
+
+namespace test_static {
+
+    // forward declare the ProcessingFunctor types
+    class ProcessingFunctorInterface;
+    class ForwardingProcessingFunctor;
+    class CountingProcessingFunctor;
+
+    // For this test, the stage graph is described at compile-time.
+    // Each stage names its concrete processing functor and queue type.
+    struct TestTraits
+    {
+        using StageEnumType = Stages;
+        using ProcessingFunctor = ProcessingFunctorInterface;
+
+        using Message = wield::MessageBase<ProcessingFunctor>;
+        using MessagePtr = typename Message::ptr;
+
+        using Queue = Concurrency::concurrent_queue<MessagePtr>;
+        using SimpleQueue = test_static::SimpleQueue<MessagePtr>;
+
+        template<StageEnumType StageName, class ProcessingFunctorType, class QueueType>
+        using StageDescription = wield::static_graph::StageDescription<StageEnumType, StageName, ProcessingFunctorType, QueueType>;
+
+        using StageGraph = wield::static_graph::StageGraph<StageEnumType, Message,
+            StageDescription<Stages::Stage1, ForwardingProcessingFunctor, Queue>,
+            StageDescription<Stages::Stage2, CountingProcessingFunctor, SimpleQueue>,
+            StageDescription<Stages::Stage3, CountingProcessingFunctor, Queue>>;
+
+        using Dispatcher = wield::static_graph::Dispatcher<StageGraph>;
+
+        template<StageEnumType StageName>
+        using Stage = typename Dispatcher::template ConcreteStageType<StageName>;
+
+        using PollingPolicy = wield::polling_policies::ExhaustivePollingPolicy<StageEnumType>;
+        using SchedulingPolicy = wield::schedulers::RoundRobin<Dispatcher, PollingPolicy>;
+        using Scheduler = wield::SchedulerBase<SchedulingPolicy>;
+    };
+
+    // here we are using our own traits definition, not using the 
+    // wield::Traits<> convenience class template. We're doing this
+    // because for this set of tests, we need the static dispatcher.
+    using Traits = TestTraits;
+}
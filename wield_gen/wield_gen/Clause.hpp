@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace wield_gen {
+
+    // a single clause of a generator file, e.g.
+    //     edge('Stage1', 'Stage2', 'Message1')
+    struct Clause
+    {
+        std::string name;                       // edge
+        std::vector<std::string> arguments;     // Stage1, Stage2, Message1
+        std::string location;                   // file:line, for error messages
+    };
+}
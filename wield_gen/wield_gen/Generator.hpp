@@ -0,0 +1,83 @@
+#pragma once
+#include <wield_gen/Model.hpp>
+
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace wield_gen {
+
+    class GeneratorError : public std::runtime_error
+    {
+    public:
+        GeneratorError(const std::string& what)
+            : std::runtime_error(what)
+        {
+        }
+    };
+
+    // Write the application described by a Model into an output directory:
+    //
+    //   Stages.hpp, src/Stages.cpp      the StageEnum
+    //   Traits.hpp                      message, queue, static_graph StageGraph & Dispatcher,
+    //                                   polling and scheduling policy types
+    //   ProcessingFunctor.hpp           ProcessingFunctorInterface, one operator() per message
+    //   Application.hpp                 owns the dispatcher, functors, queues and stages
+    //   StageProperties.hpp             concurrency, affinity and service time maps
+    //   platform/ConcurrentQueue.hpp    the queue used by stages which aren't inline
+    //
+    // and, only when they don't exist yet (or @overwriteSkeletons is set), the
+    // skeletons the application fills in:
+    //
+    //   message/<Message>.hpp, src/<Message>.cpp
+    //   stage/<ProcessingFunctor>.hpp, src/<ProcessingFunctor>.cpp
+    //
+    // Generated files whose contents haven't changed are not rewritten, so
+    // running the generator from a build doesn't trigger needless rebuilds.
+    class Generator
+    {
+    public:
+        // @sources the generator files the model was read from, named in
+        // the header of each generated file.
+        Generator(const Model& model, const std::vector<std::string>& sources, const std::string& outputDirectory, const bool overwriteSkeletons);
+
+        // @log receives a line per file written.
+        // @throws GeneratorError if a file can't be written.
+        void run(std::ostream& log);
+
+    private:
+        enum class FileKind
+        {
+            Generated,
+            Skeleton
+        };
+
+        void write(const std::string& path, const std::string& contents, const FileKind kind, std::ostream& log);
+
+        std::string banner() const;
+        std::string openNamespace() const;
+        std::string closeNamespace() const;
+
+        std::string stagesHeader() const;
+        std::string stagesSource() const;
+        std::string traitsHeader() const;
+        std::string processingFunctorHeader() const;
+        std::string messageHeader(const Message& message) const;
+        std::string messageSource(const Message& message) const;
+        std::string processingFunctorSkeletonHeader(const std::string& processingFunctor) const;
+        std::string processingFunctorSkeletonSource(const std::string& processingFunctor) const;
+        std::string applicationHeader() const;
+        std::string stagePropertiesHeader() const;
+        std::string concurrentQueueHeader() const;
+
+        // @return true if any stage using @processingFunctor has an outgoing edge.
+        bool dispatches(const std::string& processingFunctor) const;
+
+    private:
+        const Model& model_;
+        const std::vector<std::string> sources_;
+        const std::string outputDirectory_;
+        const bool overwriteSkeletons_;
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <wield_gen/Clause.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace wield_gen {
+
+    class ModelError : public std::runtime_error
+    {
+    public:
+        ModelError(const std::string& location, const std::string& what)
+            : std::runtime_error(location.empty() ? what : location + ": " + what)
+        {
+        }
+    };
+
+    struct Affinity
+    {
+        enum class Kind
+        {
+            None,
+            NumaNode,
+            Cpu
+        };
+
+        Kind kind;
+        std::size_t id;
+    };
+
+    struct ServiceTime
+    {
+        std::string load;           // empty when no load tag was given
+        std::uint64_t nanoseconds;
+    };
+
+    struct Stage
+    {
+        std::string name;
+        std::string processingFunctor;  // the stage name unless given
+        bool isInline;
+        bool orderedProcessing;
+        Affinity affinity;
+        std::vector<ServiceTime> serviceTimes;
+    };
+
+    struct Message
+    {
+        std::string name;
+        std::string base;           // empty for Traits::Message
+    };
+
+    struct Edge
+    {
+        std::string from;
+        std::string to;
+        std::string message;        // empty when every message type takes the edge
+    };
+
+    // The application described by a generator file.
+    struct Model
+    {
+        std::vector<std::string> namespaces;    // outermost first
+        std::vector<Stage> stages;              // in StageEnum order (order of first mention)
+        std::vector<Message> messages;          // in declaration order
+        std::vector<Edge> edges;
+        std::vector<std::string> warnings;
+
+        const Stage* findStage(const std::string& name) const;
+        const Message* findMessage(const std::string& name) const;
+
+        // the distinct processing functor types, in order of first use.
+        std::vector<std::string> processingFunctors() const;
+
+        // the stages using processing functor type @processingFunctor.
+        std::vector<const Stage*> stagesUsing(const std::string& processingFunctor) const;
+
+        // the edges leaving @stage which messages of type @message take, an edge
+        // for a message type is also taken by the types derived from it. An
+        // empty @message is the message base class, which only takes the edges
+        // with no message type.
+        std::vector<const Edge*> routes(const std::string& stage, const std::string& message) const;
+
+        // @return true if @message is, or derives from, @base.
+        bool isA(const std::string& message, const std::string& base) const;
+    };
+
+    // build (and validate) the model from the clauses of one or more generator files.
+    // @throws ModelError
+    Model buildModel(const std::vector<Clause>& clauses);
+}
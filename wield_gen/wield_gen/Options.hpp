@@ -0,0 +1,31 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wield_gen {
+
+    // Command line options
+    //
+    //   wield_gen [--output=<directory>] [--force] <file>...
+    //
+    //   --output=.          directory the application is generated into
+    //   --force             overwrite message and processing functor skeletons
+    //
+    // Clauses from every <file> are combined, so e.g. affinity profiles can
+    // be kept apart from the stage graph.
+    struct Options
+    {
+        Options();
+
+        // @return false (after writing the reason to @error) if
+        // @argv contains an unknown option or no input file.
+        bool parse(int argc, char* argv[], std::ostream& error);
+
+        static void usage(std::ostream& os);
+
+        std::vector<std::string> inputs;
+        std::string output;
+        bool force;
+    };
+}
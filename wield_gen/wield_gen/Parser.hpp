@@ -0,0 +1,29 @@
+#pragma once
+#include <wield_gen/Clause.hpp>
+
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace wield_gen {
+
+    class ParseError : public std::runtime_error
+    {
+    public:
+        ParseError(const std::string& location, const std::string& what)
+            : std::runtime_error(location + ": " + what)
+        {
+        }
+    };
+
+    // Read the clauses of a generator file (see _notes/GenerationFileFormat.md).
+    //
+    // A clause is a name followed by a parenthesized, comma separated list of
+    // single (or double) quoted arguments. Clauses are separated by white space,
+    // '%' starts a comment which runs to the end of the line.
+    //
+    // @fileName is only used in the location of each clause.
+    // @throws ParseError on malformed input.
+    std::vector<Clause> parse(std::istream& input, const std::string& fileName);
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+namespace wield_gen { namespace platform {
+
+    // create the directory @path (its parent must exist).
+    // @return true if the directory exists afterwards.
+    bool makeDirectory(const std::string& path);
+}}
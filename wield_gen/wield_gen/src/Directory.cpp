@@ -0,0 +1,23 @@
+#include <wield_gen/platform/Directory.hpp>
+
+#include <cerrno>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+    #include <sys/types.h>
+#endif
+
+namespace wield_gen { namespace platform {
+
+    bool makeDirectory(const std::string& path)
+    {
+#ifdef _WIN32
+        const int result = _mkdir(path.c_str());
+#else
+        const int result = mkdir(path.c_str(), 0755);
+#endif
+        return result == 0 || errno == EEXIST;
+    }
+}}
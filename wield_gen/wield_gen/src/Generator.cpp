@@ -0,0 +1,713 @@
+#include <wield_gen/Generator.hpp>
+#include <wield_gen/platform/Directory.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace wield_gen {
+
+    namespace {
+
+        std::string lowerFirst(std::string name)
+        {
+            name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+            return name;
+        }
+
+        std::string stageIndex(const std::string& stage)
+        {
+            return "static_cast<std::size_t>(Stages::" + stage + ")";
+        }
+
+        // the stages a message of type @message is dispatched to from @stage.
+        std::vector<std::string> targets(const Model& model, const std::string& stage, const std::string& message)
+        {
+            std::vector<std::string> to;
+            for(const Edge* edge : model.routes(stage, message))
+            {
+                if(std::find(begin(to), end(to), edge->to) == end(to))
+                {
+                    to.push_back(edge->to);
+                }
+            }
+            return to;
+        }
+
+        bool readFile(const std::string& path, std::string& contents)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if(!file)
+            {
+                return false;
+            }
+
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            return true;
+        }
+    }
+
+    Generator::Generator(const Model& model, const std::vector<std::string>& sources, const std::string& outputDirectory, const bool overwriteSkeletons)
+        : model_(model)
+        , sources_(sources)
+        , outputDirectory_(outputDirectory)
+        , overwriteSkeletons_(overwriteSkeletons)
+    {
+    }
+
+    void Generator::run(std::ostream& log)
+    {
+        for(const auto directory : { "", "/message", "/platform", "/src", "/stage" })
+        {
+            if(!platform::makeDirectory(outputDirectory_ + directory))
+            {
+                throw GeneratorError("can't create directory " + outputDirectory_ + directory);
+            }
+        }
+
+        write("Stages.hpp", stagesHeader(), FileKind::Generated, log);
+        write("src/Stages.cpp", stagesSource(), FileKind::Generated, log);
+        write("Traits.hpp", traitsHeader(), FileKind::Generated, log);
+        write("ProcessingFunctor.hpp", processingFunctorHeader(), FileKind::Generated, log);
+        write("Application.hpp", applicationHeader(), FileKind::Generated, log);
+        write("StageProperties.hpp", stagePropertiesHeader(), FileKind::Generated, log);
+        write("platform/ConcurrentQueue.hpp", concurrentQueueHeader(), FileKind::Generated, log);
+
+        for(const auto& message : model_.messages)
+        {
+            write("message/" + message.name + ".hpp", messageHeader(message), FileKind::Skeleton, log);
+            write("src/" + message.name + ".cpp", messageSource(message), FileKind::Skeleton, log);
+        }
+
+        for(const auto& processingFunctor : model_.processingFunctors())
+        {
+            write("stage/" + processingFunctor + ".hpp", processingFunctorSkeletonHeader(processingFunctor), FileKind::Skeleton, log);
+            write("src/" + processingFunctor + ".cpp", processingFunctorSkeletonSource(processingFunctor), FileKind::Skeleton, log);
+        }
+    }
+
+    void Generator::write(const std::string& relativePath, const std::string& contents, const FileKind kind, std::ostream& log)
+    {
+        const std::string path = outputDirectory_ + "/" + relativePath;
+
+        std::string existing;
+        if(readFile(path, existing))
+        {
+            if(existing == contents)
+            {
+                return;
+            }
+
+            if(kind == FileKind::Skeleton && !overwriteSkeletons_)
+            {
+                log << "kept " << path << std::endl;
+                return;
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+        if(!file)
+        {
+            throw GeneratorError("can't write " + path);
+        }
+
+        log << "wrote " << path << std::endl;
+    }
+
+    bool Generator::dispatches(const std::string& processingFunctor) const
+    {
+        for(const Stage* stage : model_.stagesUsing(processingFunctor))
+        {
+            if(std::any_of(begin(model_.edges), end(model_.edges), [stage](const Edge& e){ return e.from == stage->name; }))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string Generator::banner() const
+    {
+        std::string names;
+        for(const auto& source : sources_)
+        {
+            names += (names.empty() ? "" : ", ") + source;
+        }
+
+        return "// Generated by wield_gen from " + names + ", do not edit.\n";
+    }
+
+    std::string Generator::openNamespace() const
+    {
+        std::string text;
+        for(const auto& name : model_.namespaces)
+        {
+            text += (text.empty() ? "" : " ") + std::string("namespace ") + name + " {";
+        }
+        return text + "\n";
+    }
+
+    std::string Generator::closeNamespace() const
+    {
+        return std::string(model_.namespaces.size(), '}') + "\n";
+    }
+
+    std::string Generator::stagesHeader() const
+    {
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << banner()
+           << "#include <cstdint>\n"
+           << "#include <iostream>\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    enum class Stages : " << (model_.stages.size() < 255 ? "std::uint8_t" : "std::uint16_t") << "\n"
+           << "    {\n";
+
+        for(const auto& stage : model_.stages)
+        {
+            os << "        " << stage.name << ",\n";
+        }
+
+        os << "\n"
+           << "        NumberOfEntries\n"
+           << "    };\n"
+           << "\n"
+           << "    std::ostream& operator<<(std::ostream& os, Stages s);\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::stagesSource() const
+    {
+        std::ostringstream os;
+        os << banner()
+           << "#include \"../Stages.hpp\"\n"
+           << "\n"
+           << "#include <string>\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    namespace {\n"
+           << "\n"
+           << "        std::string name(const Stages s)\n"
+           << "        {\n"
+           << "            switch(s)\n"
+           << "            {\n";
+
+        for(const auto& stage : model_.stages)
+        {
+            os << "            case Stages::" << stage.name << ": return \"Stages::" << stage.name << "\";\n";
+        }
+
+        os << "            case Stages::NumberOfEntries: return \"Stages::NumberOfEntries\";\n"
+           << "            };\n"
+           << "\n"
+           << "            return \"Unknown Value\";\n"
+           << "        }\n"
+           << "    }\n"
+           << "\n"
+           << "    std::ostream& operator<<(std::ostream& os, Stages s)\n"
+           << "    {\n"
+           << "        os << name(s);\n"
+           << "        return os;\n"
+           << "    }\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::traitsHeader() const
+    {
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << banner()
+           << "#include <wield/MessageBase.hpp>\n"
+           << "#include <wield/SchedulerBase.hpp>\n"
+           << "\n"
+           << "#include <wield/adapters/FusedQueue.hpp>\n"
+           << "#include <wield/polling_policies/ExhaustivePollingPolicy.hpp>\n"
+           << "#include <wield/schedulers/RoundRobin.hpp>\n"
+           << "#include <wield/static_graph/Dispatcher.hpp>\n"
+           << "#include <wield/static_graph/StageGraph.hpp>\n"
+           << "\n"
+           << "#include \"./platform/ConcurrentQueue.hpp\"\n"
+           << "#include \"./Stages.hpp\"\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    // forward declare the ProcessingFunctor types\n"
+           << "    class ProcessingFunctorInterface;\n";
+
+        for(const auto& processingFunctor : model_.processingFunctors())
+        {
+            os << "    class " << processingFunctor << ";\n";
+        }
+
+        os << "\n"
+           << "    // The stage graph is described at compile-time, each stage names its\n"
+           << "    // concrete processing functor and queue type. Inline stages use a\n"
+           << "    // FusedQueue, a message dispatched to them is processed immediately\n"
+           << "    // in the dispatching thread.\n"
+           << "    struct Traits\n"
+           << "    {\n"
+           << "        using StageEnumType = Stages;\n"
+           << "        using ProcessingFunctor = ProcessingFunctorInterface;\n"
+           << "\n"
+           << "        using Message = wield::MessageBase<ProcessingFunctor>;\n"
+           << "        using MessagePtr = typename Message::ptr;\n"
+           << "\n"
+           << "        using Queue = Concurrency::concurrent_queue<MessagePtr>;\n"
+           << "\n"
+           << "        template<class ProcessingFunctorType>\n"
+           << "        using FusedQueue = wield::adapters::FusedQueue<MessagePtr, ProcessingFunctorType>;\n"
+           << "\n"
+           << "        template<StageEnumType StageName, class ProcessingFunctorType, class QueueType>\n"
+           << "        using StageDescription = wield::static_graph::StageDescription<StageEnumType, StageName, ProcessingFunctorType, QueueType>;\n"
+           << "\n"
+           << "        using StageGraph = wield::static_graph::StageGraph<StageEnumType, Message";
+
+        for(const auto& stage : model_.stages)
+        {
+            const std::string queue = stage.isInline ? "FusedQueue<" + stage.processingFunctor + ">" : std::string("Queue");
+            os << ",\n            StageDescription<Stages::" << stage.name << ", " << stage.processingFunctor << ", " << queue << ">";
+        }
+
+        os << ">;\n"
+           << "\n"
+           << "        using Dispatcher = wield::static_graph::Dispatcher<StageGraph>;\n"
+           << "\n"
+           << "        template<StageEnumType StageName>\n"
+           << "        using Stage = typename Dispatcher::template ConcreteStageType<StageName>;\n"
+           << "\n"
+           << "        using PollingPolicy = wield::polling_policies::ExhaustivePollingPolicy<StageEnumType>;\n"
+           << "        using SchedulingPolicy = wield::schedulers::RoundRobin<Dispatcher, PollingPolicy>;\n"
+           << "        using Scheduler = wield::SchedulerBase<SchedulingPolicy>;\n"
+           << "\n"
+           << "        using MaxConcurrencyContainer = typename SchedulingPolicy::MaxConcurrencyContainer;\n"
+           << "    };\n"
+           << "\n"
+           << "    using Message = Traits::Message;\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::processingFunctorHeader() const
+    {
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << banner()
+           << "#include \"./Traits.hpp\"\n";
+
+        for(const auto& message : model_.messages)
+        {
+            os << "#include \"./message/" << message.name << ".hpp\"\n";
+        }
+
+        os << "\n"
+           << openNamespace()
+           << "\n"
+           << "    class ProcessingFunctorInterface\n"
+           << "    {\n"
+           << "    public:\n"
+           << "        virtual ~ProcessingFunctorInterface(){}\n"
+           << "\n"
+           << "        virtual void operator()(Message&) = 0;\n";
+
+        for(const auto& message : model_.messages)
+        {
+            os << "        virtual void operator()(" << message.name << "&) = 0;\n";
+        }
+
+        os << "    };\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::messageHeader(const Message& message) const
+    {
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << "#include \"../Traits.hpp\"\n";
+
+        if(!message.base.empty())
+        {
+            os << "#include \"./" << message.base << ".hpp\"\n";
+        }
+
+        os << "\n"
+           << openNamespace()
+           << "\n"
+           << "    class " << message.name << " : public " << (message.base.empty() ? std::string("Message") : message.base) << "\n"
+           << "    {\n"
+           << "    public:\n"
+           << "        void processWith(ProcessingFunctorInterface& process) override;\n"
+           << "    };\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::messageSource(const Message& message) const
+    {
+        std::ostringstream os;
+        os << "#include \"../message/" << message.name << ".hpp\"\n"
+           << "#include \"../ProcessingFunctor.hpp\"\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    //virtual\n"
+           << "    void " << message.name << "::processWith(ProcessingFunctorInterface& process)\n"
+           << "    {\n"
+           << "        process(*this);\n"
+           << "    }\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::processingFunctorSkeletonHeader(const std::string& processingFunctor) const
+    {
+        std::string stageNames;
+        const auto stages = model_.stagesUsing(processingFunctor);
+        for(const Stage* stage : stages)
+        {
+            stageNames += (stageNames.empty() ? "" : ", ") + stage->name;
+        }
+
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << "#include \"../ProcessingFunctor.hpp\"\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    // the processing functor of " << (stages.size() == 1 ? "stage " : "stages ") << stageNames << ".\n"
+           << "    class " << processingFunctor << " final : public ProcessingFunctorInterface\n"
+           << "    {\n"
+           << "    public:\n";
+
+        if(dispatches(processingFunctor))
+        {
+            os << "        " << processingFunctor << "(Traits::Dispatcher& dispatcher);\n";
+        }
+        else
+        {
+            os << "        " << processingFunctor << "() = default;\n";
+        }
+        os << "\n";
+
+        os << "        void operator()(Message& message) override;\n";
+        for(const auto& message : model_.messages)
+        {
+            os << "        void operator()(" << message.name << "& message) override;\n";
+        }
+
+        os << "\n"
+           << "    private:\n"
+           << "        " << processingFunctor << "(const " << processingFunctor << "&) = delete;\n"
+           << "        " << processingFunctor << "& operator=(const " << processingFunctor << "&) = delete;\n";
+
+        if(dispatches(processingFunctor))
+        {
+            os << "\n"
+               << "    private:\n"
+               << "        Traits::Dispatcher& dispatcher_;\n";
+        }
+
+        os << "    };\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::processingFunctorSkeletonSource(const std::string& processingFunctor) const
+    {
+        const auto stages = model_.stagesUsing(processingFunctor);
+
+        std::ostringstream os;
+        os << "#include \"../stage/" << processingFunctor << ".hpp\"\n";
+
+        // dispatching to an inline stage runs its processing functor
+        // right here, so its type must be complete.
+        if(dispatches(processingFunctor))
+        {
+            std::vector<std::string> included(1, processingFunctor);
+            for(const auto& stage : model_.stages)
+            {
+                if(stage.isInline && std::find(begin(included), end(included), stage.processingFunctor) == end(included))
+                {
+                    os << "#include \"../stage/" << stage.processingFunctor << ".hpp\"     // inline\n";
+                    included.push_back(stage.processingFunctor);
+                }
+            }
+        }
+
+        os << "\n"
+           << openNamespace();
+
+        if(dispatches(processingFunctor))
+        {
+            os << "\n"
+               << "    " << processingFunctor << "::" << processingFunctor << "(Traits::Dispatcher& dispatcher)\n"
+               << "        : dispatcher_(dispatcher)\n"
+               << "    {\n"
+               << "    }\n";
+        }
+
+        std::vector<std::string> messages(1);   // the message base class
+        for(const auto& message : model_.messages)
+        {
+            messages.push_back(message.name);
+        }
+
+        for(const auto& message : messages)
+        {
+            // every stage using the functor must route the message the same
+            // way for the skeleton to dispatch it.
+            const auto to = targets(model_, stages.front()->name, message);
+            const bool sameRoutes = std::all_of(begin(stages), end(stages), [&](const Stage* stage){ return targets(model_, stage->name, message) == to; });
+            const bool usesMessage = sameRoutes && !to.empty();
+
+            os << "\n"
+               << "    void " << processingFunctor << "::operator()(" << (message.empty() ? std::string("Message") : message)
+               << (usesMessage ? "& message)\n" : "& /*message*/)\n")
+               << "    {\n"
+               << "        // TODO: process the message.\n";
+
+            if(sameRoutes)
+            {
+                for(const auto& stage : to)
+                {
+                    os << "        dispatcher_.dispatch<Stages::" << stage << ">(message);\n";
+                }
+            }
+            else
+            {
+                os << "        // the stages using this processing functor route it differently:\n";
+                for(const Stage* stage : stages)
+                {
+                    for(const auto& target : targets(model_, stage->name, message))
+                    {
+                        os << "        //   " << stage->name << " -> " << target << "\n";
+                    }
+                }
+            }
+
+            os << "    }\n";
+        }
+
+        os << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::applicationHeader() const
+    {
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << banner()
+           << "#include \"./Traits.hpp\"\n";
+
+        for(const auto& processingFunctor : model_.processingFunctors())
+        {
+            os << "#include \"./stage/" << processingFunctor << ".hpp\"\n";
+        }
+
+        os << "\n"
+           << openNamespace()
+           << "\n"
+           << "    // Owns the dispatcher and the processing functor, queue and stage of\n"
+           << "    // every stage. Schedule it with Traits::Scheduler, which makes its\n"
+           << "    // Traits::SchedulingPolicy from the arguments, e.g.\n"
+           << "    //     Application application;\n"
+           << "    //     auto concurrency = maxConcurrency(numberOfCores);\n"
+           << "    //     Traits::Scheduler scheduler(application.dispatcher(), concurrency);\n"
+           << "    class Application\n"
+           << "    {\n"
+           << "    public:\n"
+           << "        Application();\n"
+           << "\n"
+           << "        Traits::Dispatcher& dispatcher() { return dispatcher_; }\n"
+           << "\n"
+           << "    private:\n"
+           << "        Application(const Application&) = delete;\n"
+           << "        Application& operator=(const Application&) = delete;\n"
+           << "\n"
+           << "    private:\n"
+           << "        Traits::Dispatcher dispatcher_;\n"
+           << "\n";
+
+        for(const auto& stage : model_.stages)
+        {
+            os << "        " << stage.processingFunctor << " " << lowerFirst(stage.name) << "ProcessingFunctor_;\n";
+        }
+
+        os << "\n";
+        for(const auto& stage : model_.stages)
+        {
+            os << "        " << (stage.isInline ? "Traits::FusedQueue<" + stage.processingFunctor + ">" : std::string("Traits::Queue"))
+               << " " << lowerFirst(stage.name) << "Queue_;\n";
+        }
+
+        os << "\n";
+        for(const auto& stage : model_.stages)
+        {
+            os << "        Traits::Stage<Stages::" << stage.name << "> " << lowerFirst(stage.name) << "Stage_;\n";
+        }
+
+        os << "    };\n"
+           << "\n"
+           << "\n"
+           << "    inline\n"
+           << "    Application::Application()\n";
+
+        // in declaration order: functors, queues, then stages.
+        std::vector<std::string> initializers;
+        for(const auto& stage : model_.stages)
+        {
+            if(dispatches(stage.processingFunctor))
+            {
+                initializers.push_back(lowerFirst(stage.name) + "ProcessingFunctor_(dispatcher_)");
+            }
+        }
+
+        for(const auto& stage : model_.stages)
+        {
+            if(stage.isInline)
+            {
+                const std::string name = lowerFirst(stage.name);
+                initializers.push_back(name + "Queue_(" + name + "ProcessingFunctor_)");
+            }
+        }
+
+        for(const auto& stage : model_.stages)
+        {
+            const std::string name = lowerFirst(stage.name);
+            initializers.push_back(name + "Stage_(dispatcher_, " + name + "Queue_, " + name + "ProcessingFunctor_)");
+        }
+
+        for(std::size_t i = 0; i < initializers.size(); ++i)
+        {
+            os << "        " << (i == 0 ? ": " : ", ") << initializers[i] << "\n";
+        }
+
+        os << "    {\n"
+           << "    }\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::stagePropertiesHeader() const
+    {
+        const bool hasUnorderedStages = std::any_of(begin(model_.stages), end(model_.stages), [](const Stage& s){ return !s.isInline && !s.orderedProcessing; });
+
+        std::ostringstream os;
+        os << "#pragma once\n"
+           << banner()
+           << "#include \"./Traits.hpp\"\n"
+           << "\n"
+           << "#include <array>\n"
+           << "#include <chrono>\n"
+           << "#include <cstddef>\n"
+           << "#include <vector>\n"
+           << "\n"
+           << openNamespace()
+           << "\n"
+           << "    // The maximum number of threads which may visit each stage at once, for\n"
+           << "    // the MaxConcurrencyContainer constructors of Traits::SchedulingPolicy.\n"
+           << "    // ordered_processing stages allow 1 thread so their messages are processed\n"
+           << "    // in order, inline stages none (their queue is always empty), and every\n"
+           << "    // other stage @unorderedConcurrency.\n"
+           << "    inline\n"
+           << "    Traits::MaxConcurrencyContainer maxConcurrency(const std::size_t " << (hasUnorderedStages ? "unorderedConcurrency" : "/*unorderedConcurrency*/") << ")\n"
+           << "    {\n"
+           << "        Traits::MaxConcurrencyContainer concurrency;\n";
+
+        for(const auto& stage : model_.stages)
+        {
+            os << "        concurrency[" << stageIndex(stage.name) << "] = "
+               << (stage.isInline ? "0;                       // inline" : stage.orderedProcessing ? "1;                       // ordered_processing" : "unorderedConcurrency;")
+               << "\n";
+        }
+
+        os << "        return concurrency;\n"
+           << "    }\n"
+           << "\n"
+           << "    struct StageAffinity\n"
+           << "    {\n"
+           << "        enum class Kind\n"
+           << "        {\n"
+           << "            None,\n"
+           << "            NumaNode,\n"
+           << "            Cpu\n"
+           << "        };\n"
+           << "\n"
+           << "        Kind kind;\n"
+           << "        std::size_t id;     // of the NUMA node or cpu\n"
+           << "    };\n"
+           << "\n"
+           << "    // The affinity of the threads visiting each stage, indexed by stage.\n"
+           << "    inline\n"
+           << "    std::array<StageAffinity, static_cast<std::size_t>(Stages::NumberOfEntries)> stageAffinity()\n"
+           << "    {\n"
+           << "        std::array<StageAffinity, static_cast<std::size_t>(Stages::NumberOfEntries)> affinity = {{\n";
+
+        for(std::size_t s = 0; s < model_.stages.size(); ++s)
+        {
+            const auto& affinity = model_.stages[s].affinity;
+            const char* kind = affinity.kind == Affinity::Kind::NumaNode ? "NumaNode" : affinity.kind == Affinity::Kind::Cpu ? "Cpu" : "None";
+
+            os << "            { StageAffinity::Kind::" << kind << ", " << affinity.id << " }"
+               << (s + 1 == model_.stages.size() ? "  " : ", ") << "// " << model_.stages[s].name << "\n";
+        }
+
+        os << "        }};\n"
+           << "        return affinity;\n"
+           << "    }\n"
+           << "\n"
+           << "    struct ServiceTime\n"
+           << "    {\n"
+           << "        Stages stage;\n"
+           << "        const char* load;   // \"\" when the service time has no load tag\n"
+           << "        std::chrono::nanoseconds time;\n"
+           << "    };\n"
+           << "\n"
+           << "    // The measured (or expected) service times of the stages.\n"
+           << "    inline\n"
+           << "    std::vector<ServiceTime> serviceTimes()\n"
+           << "    {\n"
+           << "        return {\n";
+
+        for(const auto& stage : model_.stages)
+        {
+            for(const auto& serviceTime : stage.serviceTimes)
+            {
+                os << "            { Stages::" << stage.name << ", \"" << serviceTime.load << "\", std::chrono::nanoseconds(" << serviceTime.nanoseconds << ") },\n";
+            }
+        }
+
+        os << "        };\n"
+           << "    }\n"
+           << closeNamespace();
+        return os.str();
+    }
+
+    std::string Generator::concurrentQueueHeader() const
+    {
+        return "#pragma once\n"
+            + banner()
+            + "\n"
+              "#ifdef _WIN32\n"
+              "\n"
+              "    // Use Microsoft's concurrent_queue implementation\n"
+              "    // Disable some warnings\n"
+              "    #pragma warning(push)\n"
+              "    #pragma warning(disable : 4127 4625 4626)\n"
+              "    #include <concurrent_queue.h>\n"
+              "    #pragma warning(pop)\n"
+              "#else\n"
+              "    // Use Intel Thread Build Blocks concurrent_queue\n"
+              "    #include <tbb/concurrent_queue.h>\n"
+              "    namespace Concurrency = tbb::strict_ppl;\n"
+              "#endif\n";
+    }
+}
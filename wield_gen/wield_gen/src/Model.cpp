@@ -0,0 +1,456 @@
+#include <wield_gen/Model.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <set>
+
+namespace wield_gen {
+
+    namespace {
+
+        // names the generated code already uses in the application's namespace.
+        const std::set<std::string> reservedNames = {
+            "Application", "Message", "MessagePtr", "ProcessingFunctorInterface",
+            "ServiceTime", "StageAffinity", "Stages", "Traits", "NumberOfEntries"
+        };
+
+        // C++11 keywords and alternative tokens, none of which can name anything.
+        const std::set<std::string> keywords = {
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor",
+            "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class",
+            "compl", "const", "const_cast", "constexpr", "continue", "decltype",
+            "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+            "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+            "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+            "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private",
+            "protected", "public", "register", "reinterpret_cast", "return", "short",
+            "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+            "switch", "template", "this", "thread_local", "throw", "true", "try",
+            "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+            "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+        };
+
+        void checkArity(const Clause& clause, const std::size_t min, const std::size_t max)
+        {
+            if(clause.arguments.size() < min || clause.arguments.size() > max)
+            {
+                throw ModelError(clause.location, "wrong number of arguments to " + clause.name + "()");
+            }
+        }
+
+        void checkIdentifier(const Clause& clause, const std::string& name)
+        {
+            const bool valid = !name.empty()
+                && (std::isalpha(static_cast<unsigned char>(name[0])) || name[0] == '_')
+                && std::all_of(begin(name), end(name), [](const char c){ return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+
+            if(!valid)
+            {
+                throw ModelError(clause.location, "'" + name + "' is not a valid C++ identifier");
+            }
+
+            if(keywords.count(name) != 0)
+            {
+                throw ModelError(clause.location, "'" + name + "' is a C++ keyword");
+            }
+        }
+
+        void checkTypeName(const Clause& clause, const std::string& name)
+        {
+            checkIdentifier(clause, name);
+            if(reservedNames.count(name) != 0)
+            {
+                throw ModelError(clause.location, "'" + name + "' is used by the generated code");
+            }
+        }
+
+        bool parseNumber(const std::string& text, std::size_t& value)
+        {
+            char* end = nullptr;
+            const unsigned long long number = std::strtoull(text.c_str(), &end, 10);
+            if(text.empty() || *end != '\0' || !std::isdigit(static_cast<unsigned char>(text[0])))
+            {
+                return false;
+            }
+
+            value = static_cast<std::size_t>(number);
+            return true;
+        }
+
+        // NUMA_<n>, CPU_<n> or <n> (a cpu)
+        Affinity parseAffinity(const Clause& clause, const std::string& text)
+        {
+            Affinity affinity;
+            std::string id = text;
+
+            if(text.compare(0, 5, "NUMA_") == 0)
+            {
+                affinity.kind = Affinity::Kind::NumaNode;
+                id = text.substr(5);
+            }
+            else if(text.compare(0, 4, "CPU_") == 0)
+            {
+                affinity.kind = Affinity::Kind::Cpu;
+                id = text.substr(4);
+            }
+            else
+            {
+                affinity.kind = Affinity::Kind::Cpu;
+            }
+
+            if(!parseNumber(id, affinity.id))
+            {
+                throw ModelError(clause.location, "affinity '" + text + "' is not NUMA_<n>, CPU_<n> or a cpu number");
+            }
+            return affinity;
+        }
+
+        // hh:mm:ss.fraction, digits beyond nanoseconds are dropped.
+        std::uint64_t parseServiceTime(const Clause& clause, const std::string& text)
+        {
+            const auto fail = [&clause, &text]()
+            {
+                return ModelError(clause.location, "service time '" + text + "' is not hh:mm:ss.fraction");
+            };
+
+            const auto firstColon = text.find(':');
+            const auto secondColon = text.find(':', firstColon == std::string::npos ? firstColon : firstColon + 1);
+            if(firstColon == std::string::npos || secondColon == std::string::npos)
+            {
+                throw fail();
+            }
+
+            const auto dot = text.find('.', secondColon);
+            const std::string seconds = text.substr(secondColon + 1, dot == std::string::npos ? std::string::npos : dot - secondColon - 1);
+            std::string fraction = dot == std::string::npos ? std::string() : text.substr(dot + 1);
+
+            std::size_t h = 0;
+            std::size_t m = 0;
+            std::size_t s = 0;
+            std::size_t ns = 0;
+
+            fraction.resize(9, '0');
+            if(!parseNumber(text.substr(0, firstColon), h)
+                || !parseNumber(text.substr(firstColon + 1, secondColon - firstColon - 1), m)
+                || !parseNumber(seconds, s)
+                || !parseNumber(fraction, ns))
+            {
+                throw fail();
+            }
+
+            return ((h * 60 + m) * 60 + s) * 1000000000ULL + ns;
+        }
+
+        class Builder
+        {
+        public:
+            Model build(const std::vector<Clause>& clauses)
+            {
+                // stages and messages first, so the other clauses
+                // may refer to them wherever they are declared.
+                for(const auto& clause : clauses)
+                {
+                    if(clause.name == "namespace")          addNamespace(clause);
+                    else if(clause.name == "stage")         addStage(clause);
+                    else if(clause.name == "message")       addMessage(clause);
+                    else if(clause.name == "edge")          addEdgeStages(clause);
+                    else if(clause.name != "inline"
+                        && clause.name != "affinity"
+                        && clause.name != "service_time"
+                        && clause.name != "serviceTime"
+                        && clause.name != "ordered_processing")
+                    {
+                        throw ModelError(clause.location, "unknown clause " + clause.name + "()");
+                    }
+                }
+
+                checkMessages();
+
+                for(const auto& clause : clauses)
+                {
+                    if(clause.name == "edge")                       addEdge(clause);
+                    else if(clause.name == "inline")                stage(clause, 1).isInline = true;
+                    else if(clause.name == "ordered_processing")    stage(clause, 1).orderedProcessing = true;
+                    else if(clause.name == "affinity")              addAffinity(clause);
+                    else if(clause.name == "service_time"
+                        || clause.name == "serviceTime")            addServiceTime(clause);
+                }
+
+                for(auto& stage : model_.stages)
+                {
+                    if(stage.isInline && stage.affinity.kind != Affinity::Kind::None)
+                    {
+                        model_.warnings.push_back("inlined stage " + stage.name + " can't have affinity, it runs in the thread of the dispatching stage.");
+                        stage.affinity.kind = Affinity::Kind::None;
+                    }
+
+                    if(stage.isInline && stage.orderedProcessing)
+                    {
+                        model_.warnings.push_back("inlined stage " + stage.name + " is processed in dispatch order, ordered_processing has no effect.");
+                    }
+                }
+
+                if(model_.namespaces.empty())
+                {
+                    throw ModelError("", "no namespace() clause");
+                }
+
+                if(model_.stages.empty())
+                {
+                    throw ModelError("", "no stages");
+                }
+
+                return std::move(model_);
+            }
+
+        private:
+            void addNamespace(const Clause& clause)
+            {
+                checkArity(clause, 1, 64);
+                for(const auto& name : clause.arguments)
+                {
+                    checkIdentifier(clause, name);
+                }
+
+                if(!model_.namespaces.empty() && model_.namespaces != clause.arguments)
+                {
+                    throw ModelError(clause.location, "conflicting namespace() clauses");
+                }
+                model_.namespaces = clause.arguments;
+            }
+
+            // declare @name if it hasn't been already.
+            Stage& declareStage(const Clause& clause, const std::string& name)
+            {
+                checkIdentifier(clause, name);
+
+                auto it = std::find_if(begin(model_.stages), end(model_.stages), [&name](const Stage& s){ return s.name == name; });
+                if(it != end(model_.stages))
+                {
+                    return *it;
+                }
+
+                Stage stage;
+                stage.name = name;
+                stage.isInline = false;
+                stage.orderedProcessing = false;
+                stage.affinity.kind = Affinity::Kind::None;
+                stage.affinity.id = 0;
+
+                model_.stages.push_back(stage);
+                return model_.stages.back();
+            }
+
+            void addStage(const Clause& clause)
+            {
+                checkArity(clause, 1, 2);
+
+                const std::string& functor = clause.arguments.back();
+                checkTypeName(clause, functor);
+
+                Stage& stage = declareStage(clause, clause.arguments[0]);
+                if(!stage.processingFunctor.empty() && stage.processingFunctor != functor)
+                {
+                    throw ModelError(clause.location, "stage " + stage.name + " already uses processing functor " + stage.processingFunctor);
+                }
+                stage.processingFunctor = functor;
+            }
+
+            void addEdgeStages(const Clause& clause)
+            {
+                checkArity(clause, 2, 3);
+                declareStage(clause, clause.arguments[0]);
+                declareStage(clause, clause.arguments[1]);
+            }
+
+            void addMessage(const Clause& clause)
+            {
+                checkArity(clause, 1, 2);
+                checkTypeName(clause, clause.arguments[0]);
+
+                if(model_.findMessage(clause.arguments[0]) != nullptr)
+                {
+                    throw ModelError(clause.location, "message " + clause.arguments[0] + " is already declared");
+                }
+
+                Message message;
+                message.name = clause.arguments[0];
+                if(clause.arguments.size() == 2)
+                {
+                    checkTypeName(clause, clause.arguments[1]);
+                    message.base = clause.arguments[1];
+                }
+
+                model_.messages.push_back(message);
+                locations_.push_back(clause.location);
+            }
+
+            void checkMessages()
+            {
+                for(auto& stage : model_.stages)
+                {
+                    if(stage.processingFunctor.empty())
+                    {
+                        stage.processingFunctor = stage.name;
+                        if(reservedNames.count(stage.name) != 0)
+                        {
+                            throw ModelError("", "stage " + stage.name + " needs a processing functor name, '" + stage.name + "' is used by the generated code");
+                        }
+                    }
+                }
+
+                for(std::size_t i = 0; i < model_.messages.size(); ++i)
+                {
+                    const auto& message = model_.messages[i];
+
+                    if(!model_.stagesUsing(message.name).empty())
+                    {
+                        throw ModelError(locations_[i], "message " + message.name + " has the same name as a processing functor");
+                    }
+
+                    // walk up the hierarchy, every base must be declared and
+                    // the walk must end at the message base class.
+                    std::string base = message.base;
+                    for(std::size_t depth = 0; !base.empty(); ++depth)
+                    {
+                        const Message* parent = model_.findMessage(base);
+                        if(parent == nullptr)
+                        {
+                            throw ModelError(locations_[i], "message " + message.name + " derives from undeclared message " + base);
+                        }
+
+                        if(depth > model_.messages.size())
+                        {
+                            throw ModelError(locations_[i], "message " + message.name + " derives from itself");
+                        }
+                        base = parent->base;
+                    }
+                }
+            }
+
+            Stage& stage(const Clause& clause, const std::size_t maxArguments)
+            {
+                checkArity(clause, 1, maxArguments);
+
+                auto it = std::find_if(begin(model_.stages), end(model_.stages), [&clause](const Stage& s){ return s.name == clause.arguments[0]; });
+                if(it == end(model_.stages))
+                {
+                    throw ModelError(clause.location, "undeclared stage " + clause.arguments[0]);
+                }
+                return *it;
+            }
+
+            void addEdge(const Clause& clause)
+            {
+                Edge edge;
+                edge.from = clause.arguments[0];
+                edge.to = clause.arguments[1];
+
+                if(clause.arguments.size() == 3)
+                {
+                    edge.message = clause.arguments[2];
+                    if(model_.findMessage(edge.message) == nullptr)
+                    {
+                        throw ModelError(clause.location, "undeclared message " + edge.message);
+                    }
+                }
+
+                model_.edges.push_back(edge);
+            }
+
+            void addAffinity(const Clause& clause)
+            {
+                Stage& s = stage(clause, 2);
+                checkArity(clause, 2, 2);
+                s.affinity = parseAffinity(clause, clause.arguments[1]);
+            }
+
+            void addServiceTime(const Clause& clause)
+            {
+                Stage& s = stage(clause, 3);
+                checkArity(clause, 2, 3);
+
+                ServiceTime serviceTime;
+                serviceTime.nanoseconds = parseServiceTime(clause, clause.arguments[1]);
+                if(clause.arguments.size() == 3)
+                {
+                    serviceTime.load = clause.arguments[2];
+                }
+                s.serviceTimes.push_back(serviceTime);
+            }
+
+        private:
+            Model model_;
+            std::vector<std::string> locations_;    // of each message clause
+        };
+    }
+
+    const Stage* Model::findStage(const std::string& name) const
+    {
+        auto it = std::find_if(begin(stages), end(stages), [&name](const Stage& s){ return s.name == name; });
+        return it == end(stages) ? nullptr : &*it;
+    }
+
+    const Message* Model::findMessage(const std::string& name) const
+    {
+        auto it = std::find_if(begin(messages), end(messages), [&name](const Message& m){ return m.name == name; });
+        return it == end(messages) ? nullptr : &*it;
+    }
+
+    std::vector<std::string> Model::processingFunctors() const
+    {
+        std::vector<std::string> functors;
+        for(const auto& stage : stages)
+        {
+            if(std::find(begin(functors), end(functors), stage.processingFunctor) == end(functors))
+            {
+                functors.push_back(stage.processingFunctor);
+            }
+        }
+        return functors;
+    }
+
+    std::vector<const Stage*> Model::stagesUsing(const std::string& processingFunctor) const
+    {
+        std::vector<const Stage*> using_;
+        for(const auto& stage : stages)
+        {
+            if(stage.processingFunctor == processingFunctor)
+            {
+                using_.push_back(&stage);
+            }
+        }
+        return using_;
+    }
+
+    std::vector<const Edge*> Model::routes(const std::string& stage, const std::string& message) const
+    {
+        std::vector<const Edge*> taken;
+        for(const auto& edge : edges)
+        {
+            if(edge.from == stage && (edge.message.empty() || (!message.empty() && isA(message, edge.message))))
+            {
+                taken.push_back(&edge);
+            }
+        }
+        return taken;
+    }
+
+    bool Model::isA(const std::string& message, const std::string& base) const
+    {
+        for(const Message* m = findMessage(message); m != nullptr; m = findMessage(m->base))
+        {
+            if(m->name == base)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Model buildModel(const std::vector<Clause>& clauses)
+    {
+        return Builder().build(clauses);
+    }
+}
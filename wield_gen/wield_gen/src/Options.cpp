@@ -0,0 +1,61 @@
+#include <wield_gen/Options.hpp>
+
+namespace wield_gen {
+
+    Options::Options()
+        : output(".")
+        , force(false)
+    {
+    }
+
+    bool Options::parse(int argc, char* argv[], std::ostream& error)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto equals = argument.find('=');
+            const std::string key = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+            bool valid = true;
+            if(key == "--output")
+            {
+                output = value;
+                valid = !output.empty();
+            }
+            else if(argument == "--force")
+            {
+                force = true;
+            }
+            else if(argument.compare(0, 1, "-") == 0)
+            {
+                valid = false;
+            }
+            else
+            {
+                inputs.push_back(argument);
+            }
+
+            if(!valid)
+            {
+                error << "invalid option: " << argument << std::endl;
+                return false;
+            }
+        }
+
+        if(inputs.empty())
+        {
+            error << "no input files" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    void Options::usage(std::ostream& os)
+    {
+        os << "usage: wield_gen [options] <file>...\n"
+           << "  --output=.                    directory the application is generated into\n"
+           << "  --force                       overwrite message and processing functor skeletons" << std::endl;
+    }
+}
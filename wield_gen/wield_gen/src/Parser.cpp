@@ -0,0 +1,146 @@
+#include <wield_gen/Parser.hpp>
+
+#include <cctype>
+#include <sstream>
+
+namespace wield_gen {
+
+    namespace {
+
+        class Reader
+        {
+        public:
+            Reader(std::istream& input, const std::string& fileName)
+                : input_(input)
+                , fileName_(fileName)
+                , line_(1)
+            {
+            }
+
+            // skip white space and comments, @return the next character without consuming it.
+            int peek()
+            {
+                for(;;)
+                {
+                    const int c = input_.peek();
+                    if(c == '%')
+                    {
+                        while(input_.peek() != '\n' && input_.peek() != EOF)
+                        {
+                            input_.get();
+                        }
+                    }
+                    else if(c != EOF && std::isspace(c))
+                    {
+                        get();
+                    }
+                    else
+                    {
+                        return c;
+                    }
+                }
+            }
+
+            int get()
+            {
+                const int c = input_.get();
+                if(c == '\n')
+                {
+                    line_++;
+                }
+                return c;
+            }
+
+            void expect(const char expected)
+            {
+                if(peek() != expected)
+                {
+                    fail(std::string("expected '") + expected + "'");
+                }
+                get();
+            }
+
+            std::string identifier()
+            {
+                std::string name;
+                while(input_.peek() != EOF && (std::isalnum(input_.peek()) || input_.peek() == '_'))
+                {
+                    name += static_cast<char>(get());
+                }
+
+                if(name.empty())
+                {
+                    fail("expected a clause name");
+                }
+                return name;
+            }
+
+            std::string quoted()
+            {
+                const int quote = peek();
+                if(quote != '\'' && quote != '"')
+                {
+                    fail("expected a quoted argument");
+                }
+                get();
+
+                std::string text;
+                for(int c = get(); c != quote; c = get())
+                {
+                    if(c == EOF || c == '\n')
+                    {
+                        fail("unterminated argument");
+                    }
+                    text += static_cast<char>(c);
+                }
+                return text;
+            }
+
+            std::string location() const
+            {
+                std::ostringstream os;
+                os << fileName_ << ":" << line_;
+                return os.str();
+            }
+
+            void fail(const std::string& what) const
+            {
+                throw ParseError(location(), what);
+            }
+
+        private:
+            std::istream& input_;
+            const std::string fileName_;
+            std::size_t line_;
+        };
+    }
+
+    std::vector<Clause> parse(std::istream& input, const std::string& fileName)
+    {
+        Reader reader(input, fileName);
+        std::vector<Clause> clauses;
+
+        while(reader.peek() != EOF)
+        {
+            Clause clause;
+            clause.location = reader.location();
+            clause.name = reader.identifier();
+
+            reader.expect('(');
+            if(reader.peek() != ')')
+            {
+                clause.arguments.push_back(reader.quoted());
+                while(reader.peek() == ',')
+                {
+                    reader.get();
+                    clause.arguments.push_back(reader.quoted());
+                }
+            }
+            reader.expect(')');
+
+            clauses.push_back(std::move(clause));
+        }
+
+        return clauses;
+    }
+}
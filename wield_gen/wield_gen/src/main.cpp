@@ -0,0 +1,55 @@
+#include <wield_gen/Generator.hpp>
+#include <wield_gen/Model.hpp>
+#include <wield_gen/Options.hpp>
+#include <wield_gen/Parser.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    using namespace wield_gen;
+
+    Options options;
+    if(!options.parse(argc, argv, std::cerr))
+    {
+        Options::usage(std::cerr);
+        return 1;
+    }
+
+    try
+    {
+        std::vector<Clause> clauses;
+        for(const auto& input : options.inputs)
+        {
+            std::ifstream file(input);
+            if(!file)
+            {
+                std::cerr << "can't open " << input << std::endl;
+                return 1;
+            }
+
+            auto fileClauses = parse(file, input);
+            std::move(begin(fileClauses), end(fileClauses), std::back_inserter(clauses));
+        }
+
+        const Model model = buildModel(clauses);
+        for(const auto& warning : model.warnings)
+        {
+            std::cerr << "warning: " << warning << std::endl;
+        }
+
+        Generator(model, options.inputs, options.output, options.force).run(std::cout);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
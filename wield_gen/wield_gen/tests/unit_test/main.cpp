@@ -0,0 +1,6 @@
+#include "./platform/UnitTestSupport.hpp"
+
+int main()
+{
+    return UnitTest::RunAllTests();
+}
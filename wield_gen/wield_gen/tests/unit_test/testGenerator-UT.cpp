@@ -0,0 +1,101 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include <wield_gen/Generator.hpp>
+#include <wield_gen/Model.hpp>
+#include <wield_gen/Parser.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace wield_gen;
+
+    // the example pipeline, generated into the working directory.
+    const std::string Output = "wield_gen-UT-pipeline";
+
+    Model pipelineModel()
+    {
+        std::ifstream input(WIELD_GEN_EXAMPLES "/pipeline.wield");
+        return buildModel(parse(input, "pipeline.wield"));
+    }
+
+    // @return the log of the run.
+    std::string generate(const Model& model, const bool overwriteSkeletons)
+    {
+        std::ostringstream log;
+        Generator(model, { "pipeline.wield" }, Output, overwriteSkeletons).run(log);
+        return log.str();
+    }
+
+    std::string contentsOf(const std::string& relativePath)
+    {
+        std::ifstream file(Output + "/" + relativePath, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    bool contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    TEST(verifyGeneratorWritesThePipelineExample)
+    {
+        const Model model = pipelineModel();
+        generate(model, true);
+
+        const std::string stages = contentsOf("Stages.hpp");
+        CHECK(contains(stages, "// Generated by wield_gen from pipeline.wield, do not edit."));
+        CHECK(contains(stages, "namespace example { namespace pipeline {"));
+        CHECK(contains(stages,
+            "        Receive,\n"
+            "        Decode,\n"
+            "        Normalize,\n"
+            "        NormalizeTrades,\n"
+            "        Publish,\n"
+            "        Journal,\n"
+            "\n"
+            "        NumberOfEntries\n"));
+
+        // Decode is inline, Journal ordered_processing.
+        const std::string properties = contentsOf("StageProperties.hpp");
+        CHECK(contains(properties, "concurrency[static_cast<std::size_t>(Stages::Decode)] = 0;"));
+        CHECK(contains(properties, "concurrency[static_cast<std::size_t>(Stages::Journal)] = 1;"));
+        CHECK(contains(properties, "concurrency[static_cast<std::size_t>(Stages::Publish)] = unorderedConcurrency;"));
+
+        // Decode routes quotes and trades to different stages.
+        const std::string decode = contentsOf("src/Decode.cpp");
+        CHECK(contains(decode, "dispatcher_.dispatch<Stages::Normalize>(message);"));
+        CHECK(contains(decode, "dispatcher_.dispatch<Stages::NormalizeTrades>(message);"));
+
+        // Normalize and NormalizeTrades share one functor.
+        CHECK(!contentsOf("stage/Normalizer.hpp").empty());
+        CHECK(contentsOf("stage/Normalize.hpp").empty());
+
+        CHECK(contains(contentsOf("message/Trade.hpp"), "MarketData"));
+    }
+
+    TEST(verifyGeneratorLeavesUnchangedFilesAndSkeletonsAlone)
+    {
+        const Model model = pipelineModel();
+        generate(model, true);
+
+        // nothing changed, nothing is written.
+        CHECK_EQUAL("", generate(model, false));
+
+        // a skeleton holds the application's code, it's kept unless forced.
+        {
+            std::ofstream file(Output + "/src/Publish.cpp", std::ios::binary | std::ios::trunc);
+            file << "// filled in\n";
+        }
+
+        CHECK_EQUAL("kept " + Output + "/src/Publish.cpp\n", generate(model, false));
+        CHECK_EQUAL("// filled in\n", contentsOf("src/Publish.cpp"));
+
+        CHECK_EQUAL("wrote " + Output + "/src/Publish.cpp\n", generate(model, true));
+        CHECK(contentsOf("src/Publish.cpp") != "// filled in\n");
+    }
+}
@@ -0,0 +1,112 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include <wield_gen/Model.hpp>
+#include <wield_gen/Parser.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+    using namespace wield_gen;
+
+    Model modelOf(const std::string& text)
+    {
+        std::istringstream input(text);
+        return buildModel(parse(input, "test.wield"));
+    }
+
+    // @return the ModelError's message, empty if @text is a valid model.
+    std::string modelErrorOf(const std::string& text)
+    {
+        try
+        {
+            modelOf(text);
+        }
+        catch(const ModelError& e)
+        {
+            return e.what();
+        }
+
+        return std::string();
+    }
+
+    TEST(verifyModelCollectsStagesMessagesAndEdges)
+    {
+        const Model model = modelOf(
+            "namespace('app')\n"
+            "edge('Stage1', 'Stage2', 'Derived')\n"
+            "stage('Stage2', 'Functor')\n"
+            "message('Base')\n"
+            "message('Derived', 'Base')\n"
+            "inline('Stage2')\n"
+            "ordered_processing('Stage1')\n"
+            "affinity('Stage1', 'NUMA_1')\n"
+            "service_time('Stage1', '00:00:01.5', 'Burst')\n");
+
+        CHECK_EQUAL(1U, model.namespaces.size());
+        CHECK_EQUAL("app", model.namespaces[0]);
+
+        // in order of first mention, an edge declares its stages.
+        CHECK_EQUAL(2U, model.stages.size());
+        CHECK_EQUAL("Stage1", model.stages[0].name);
+        CHECK_EQUAL("Stage1", model.stages[0].processingFunctor);
+        CHECK(model.stages[0].orderedProcessing);
+        CHECK(model.stages[0].affinity.kind == Affinity::Kind::NumaNode);
+        CHECK_EQUAL(1U, model.stages[0].affinity.id);
+        CHECK_EQUAL(1U, model.stages[0].serviceTimes.size());
+        CHECK_EQUAL("Burst", model.stages[0].serviceTimes[0].load);
+        CHECK_EQUAL(1500000000U, model.stages[0].serviceTimes[0].nanoseconds);
+
+        CHECK_EQUAL("Stage2", model.stages[1].name);
+        CHECK_EQUAL("Functor", model.stages[1].processingFunctor);
+        CHECK(model.stages[1].isInline);
+
+        CHECK(model.isA("Derived", "Base"));
+        CHECK(!model.isA("Base", "Derived"));
+        CHECK_EQUAL(1U, model.routes("Stage1", "Derived").size());
+        CHECK_EQUAL(0U, model.routes("Stage1", "Base").size());
+        CHECK(model.warnings.empty());
+    }
+
+    TEST(verifyModelWarnsAboutAffinityOfAnInlineStage)
+    {
+        const Model model = modelOf(
+            "namespace('app')\n"
+            "stage('Stage1')\n"
+            "inline('Stage1')\n"
+            "affinity('Stage1', '3')\n");
+
+        CHECK_EQUAL(1U, model.warnings.size());
+        CHECK(model.stages[0].affinity.kind == Affinity::Kind::None);
+    }
+
+    TEST(verifyModelRejectsInvalidNames)
+    {
+        CHECK_EQUAL("test.wield:2: '1Stage' is not a valid C++ identifier", modelErrorOf("namespace('app')\nstage('1Stage')"));
+        CHECK_EQUAL("test.wield:2: 'Traits' is used by the generated code", modelErrorOf("namespace('app')\nmessage('Traits')"));
+    }
+
+    TEST(verifyModelRejectsKeywords)
+    {
+        CHECK_EQUAL("test.wield:1: 'class' is a C++ keyword", modelErrorOf("namespace('class')\nstage('Stage1')"));
+        CHECK_EQUAL("test.wield:2: 'switch' is a C++ keyword", modelErrorOf("namespace('app')\nstage('switch')"));
+        CHECK_EQUAL("test.wield:2: 'new' is a C++ keyword", modelErrorOf("namespace('app')\nstage('Stage1', 'new')"));
+        CHECK_EQUAL("test.wield:2: 'and' is a C++ keyword", modelErrorOf("namespace('app')\nedge('Stage1', 'and')"));
+        CHECK_EQUAL("test.wield:3: 'delete' is a C++ keyword", modelErrorOf("namespace('app')\nstage('Stage1')\nmessage('delete')"));
+    }
+
+    TEST(verifyModelRejectsInconsistentClauses)
+    {
+        CHECK_EQUAL("no namespace() clause", modelErrorOf("stage('Stage1')"));
+        CHECK_EQUAL("no stages", modelErrorOf("namespace('app')"));
+        CHECK_EQUAL("test.wield:2: unknown clause stages()", modelErrorOf("namespace('app')\nstages('Stage1')"));
+        CHECK_EQUAL("test.wield:2: wrong number of arguments to stage()", modelErrorOf("namespace('app')\nstage('Stage1', 'Functor', 'More')"));
+        CHECK_EQUAL("test.wield:3: undeclared stage Stage2", modelErrorOf("namespace('app')\nstage('Stage1')\ninline('Stage2')"));
+        CHECK_EQUAL("test.wield:2: undeclared message Message1", modelErrorOf("namespace('app')\nedge('Stage1', 'Stage2', 'Message1')"));
+        CHECK_EQUAL("test.wield:3: message Derived derives from undeclared message Base", modelErrorOf("namespace('app')\nstage('Stage1')\nmessage('Derived', 'Base')"));
+        CHECK_EQUAL("test.wield:3: message Stage1 has the same name as a processing functor", modelErrorOf("namespace('app')\nstage('Stage1')\nmessage('Stage1')"));
+        CHECK_EQUAL("test.wield:3: service time '1.5' is not hh:mm:ss.fraction", modelErrorOf("namespace('app')\nstage('Stage1')\nservice_time('Stage1', '1.5')"));
+        CHECK_EQUAL("test.wield:3: affinity 'GPU_0' is not NUMA_<n>, CPU_<n> or a cpu number", modelErrorOf("namespace('app')\nstage('Stage1')\naffinity('Stage1', 'GPU_0')"));
+    }
+}
@@ -0,0 +1,70 @@
+#include "./platform/UnitTestSupport.hpp"
+
+#include <wield_gen/Parser.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace wield_gen;
+
+    std::vector<Clause> parseText(const std::string& text)
+    {
+        std::istringstream input(text);
+        return parse(input, "test.wield");
+    }
+
+    // @return the ParseError's message, empty if @text parsed.
+    std::string parseErrorOf(const std::string& text)
+    {
+        try
+        {
+            parseText(text);
+        }
+        catch(const ParseError& e)
+        {
+            return e.what();
+        }
+
+        return std::string();
+    }
+
+    TEST(verifyParserReadsClausesAndTheirArguments)
+    {
+        const auto clauses = parseText(
+            "% a comment\n"
+            "stage('Stage1')\n"
+            "edge('Stage1', \"Stage2\", 'Message1') % trailing comment\n");
+
+        CHECK_EQUAL(2U, clauses.size());
+
+        CHECK_EQUAL("stage", clauses[0].name);
+        CHECK_EQUAL(1U, clauses[0].arguments.size());
+        CHECK_EQUAL("Stage1", clauses[0].arguments[0]);
+        CHECK_EQUAL("test.wield:2", clauses[0].location);
+
+        CHECK_EQUAL("edge", clauses[1].name);
+        CHECK_EQUAL(3U, clauses[1].arguments.size());
+        CHECK_EQUAL("Stage1", clauses[1].arguments[0]);
+        CHECK_EQUAL("Stage2", clauses[1].arguments[1]);
+        CHECK_EQUAL("Message1", clauses[1].arguments[2]);
+        CHECK_EQUAL("test.wield:3", clauses[1].location);
+    }
+
+    TEST(verifyParserReadsNothingFromAnEmptyFile)
+    {
+        CHECK(parseText("").empty());
+        CHECK(parseText("  % only a comment\n\n").empty());
+    }
+
+    TEST(verifyParserRejectsMalformedClauses)
+    {
+        CHECK_EQUAL("test.wield:1: expected a quoted argument", parseErrorOf("stage(Stage1)"));
+        CHECK_EQUAL("test.wield:1: unterminated argument", parseErrorOf("stage('Stage1)"));
+        CHECK_EQUAL("test.wield:2: expected '('", parseErrorOf("\nstage 'Stage1'"));
+        CHECK_EQUAL("test.wield:1: expected ')'", parseErrorOf("stage('Stage1'"));
+        CHECK_EQUAL("test.wield:1: expected a clause name", parseErrorOf("('Stage1')"));
+    }
+}